@@ -28,6 +28,9 @@
 #include <stdio.h>
 #include <string.h>
 #include "microsh.h"
+#if MICROSH_CFG_MUX
+#include "microsh_mux.h"
+#endif /* MICROSH_CFG_MUX */
 #include "example_misc.h"
 
 /* Create microsh instance */
@@ -35,14 +38,56 @@ static microsh_t sh;
 
 #if MICROSH_CFG_CONSOLE_SESSIONS
 /* Console sessions credentials for authorization process */
-static microsh_credentials_t credentials[2] = {
+#if MICROSH_CFG_PASSW_HASH
+/* Generated by `tools/microsh_passwd.py _LOGIN_TYPE_DEBUG:debug:54321 _LOGIN_TYPE_ADMIN:admin:12345` */
+static const microsh_credentials_t credentials[2] = {
+    { .login_type = _LOGIN_TYPE_DEBUG, .username = "debug",
+      .salt = { 0xBE, 0x2B, 0xB2, 0x41, 0xD3, 0x46, 0xFD, 0x7B, 0x2A, 0xC6, 0x25, 0x80, 0xE1, 0x9B, 0x2E, 0x0B },
+      .hash = { 0x0E, 0x73, 0x64, 0x37, 0x36, 0xC3, 0xF2, 0x51, 0x13, 0x74, 0x01, 0x0A, 0x93, 0x2A, 0xF6, 0x8D, 0x3E, 0x2C, 0xF6, 0x14, 0x47, 0x9B, 0xE7, 0x69, 0x73, 0x39, 0xA8, 0xC5, 0xF9, 0x94, 0x33, 0x01 } },
+    { .login_type = _LOGIN_TYPE_ADMIN, .username = "admin",
+      .salt = { 0xD4, 0x85, 0xAD, 0x59, 0x22, 0x34, 0x3B, 0x96, 0x2E, 0xC0, 0x80, 0xB5, 0xFF, 0x59, 0xBD, 0xDF },
+      .hash = { 0xA4, 0x4A, 0x13, 0x48, 0xB4, 0xDE, 0xE8, 0x19, 0x11, 0x43, 0x5B, 0x00, 0xC3, 0x6A, 0x16, 0xA8, 0x0E, 0x65, 0x7E, 0x86, 0xAE, 0x20, 0x82, 0xCA, 0x0E, 0x7D, 0x50, 0x3B, 0x4F, 0xBA, 0x0F, 0x7B } }
+};
+#else
+static const microsh_credentials_t credentials[2] = {
     { .login_type = _LOGIN_TYPE_DEBUG, .username = "debug", .password = "54321" },
     { .login_type = _LOGIN_TYPE_ADMIN, .username = "admin", .password = "12345" }
 };
+#endif /* MICROSH_CFG_PASSW_HASH */
+
+#if MICROSH_CFG_SESSION_IDLE_TIMEOUT
+/* Idle sessions are logged out automatically */
+static const microsh_idle_timeout_t idle_timeouts[2] = {
+    { .login_type = _LOGIN_TYPE_DEBUG, .timeout_ms = 10 * 60 * 1000 },
+    { .login_type = _LOGIN_TYPE_ADMIN, .timeout_ms = 5 * 60 * 1000 }
+};
+#endif /* MICROSH_CFG_SESSION_IDLE_TIMEOUT */
 
+#if !MICROSH_CFG_TERMINALS
 static void log_in_callback(microsh_t* msh);
+#endif /* !MICROSH_CFG_TERMINALS */
 #endif /* MICROSH_CFG_CONSOLE_SESSIONS */
 
+#if MICROSH_CFG_SCRIPT
+/* Bring-up script run at every start, commands are resolved once by compiler */
+static const char boot_script_text[] =
+    "# Print serial number, restore default one if it is not readable\n"
+    "if sernum ?\n"
+    "else\n"
+    "    -sernum 1\n"
+    "end\n";
+
+static microsh_script_t boot_script;
+#endif /* MICROSH_CFG_SCRIPT */
+
+#if MICROSH_CFG_MUX
+/* Virtual channels multiplexer, channel 0 is used by shell */
+static microsh_mux_t mux;
+
+static int  mux_print(microrl_t* mrl, const char* str);
+static void mux_tx(microsh_mux_t* mux, const uint8_t* data, size_t len);
+#endif /* MICROSH_CFG_MUX */
+
 /**
  * \brief           Program entry point
  */
@@ -53,28 +98,85 @@ int main (void/*int argc, char** argv*/) {
     /* Hardware initialization */
     init();
 
+#if MICROSH_CFG_MUX
+    /* Shell input and output are passed through multiplexer channel 0 with the highest priority */
+    microsh_mux_init(&mux, mux_tx, NULL);
+    microsh_mux_channel_set(&mux, 0, 0, microsh_mux_shell_rx, psh);
+    microsh_init(psh, mux_print);
+#else
     /* Initialize library with microsh instance and print callback placed in microrl instance */
     microsh_init(psh, microrl_print);
+#endif /* MICROSH_CFG_MUX */
+
+#if MICROSH_CFG_AUDIT_LOG
+    /* Mount audit log persistent storage */
+    if (microsh_audit_init(psh, audit_storage_init()) != microshOK) {
+        psh->mrl.out_fn(&psh->mrl, "Audit log storage is not available!"MICRORL_CFG_END_LINE);
+    }
+#endif /* MICROSH_CFG_AUDIT_LOG */
+
+#if MICROSH_CFG_ALIASES
+    /* Load aliases saved before, they are saved again on every change */
+    if (microsh_alias_set_storage(psh, alias_storage_init()) != microshOK) {
+        psh->mrl.out_fn(&psh->mrl, "Saved aliases are not loaded!"MICRORL_CFG_END_LINE);
+    }
+#endif /* MICROSH_CFG_ALIASES */
+
+#if MICROSH_CFG_HISTORY
+    /* Mount command history persistent storage, Ctrl+R searches it */
+    if (microsh_hist_init(psh, hist_storage_init()) != microshOK) {
+        psh->mrl.out_fn(&psh->mrl, "History storage is not available!"MICRORL_CFG_END_LINE);
+    }
+#endif /* MICROSH_CFG_HISTORY */
 
 #if MICROSH_CFG_CONSOLE_SESSIONS
     /* Initialize sessions credentials */
+#if MICROSH_CFG_TERMINALS
+    /* Commands are shared by all terminals, logged out terminals accept `login` only */
+    microsh_session_init(&sh, credentials, MICROSH_ARRAYSIZE(credentials), NULL);
+#else
     microsh_session_init(&sh, credentials, MICROSH_ARRAYSIZE(credentials), log_in_callback);
+#endif /* MICROSH_CFG_TERMINALS */
+#if MICROSH_CFG_SESSION_IDLE_TIMEOUT
+    microsh_session_set_idle_timeouts(&sh, idle_timeouts, MICROSH_ARRAYSIZE(idle_timeouts));
+#endif /* MICROSH_CFG_SESSION_IDLE_TIMEOUT */
+
+#if MICROSH_CFG_TERMINALS
+    /* Registering shell commands once for all terminals */
+    cmd_reg_res = register_all_commands(psh);
 
+    /* Start accepting additional terminals */
+    terminals_init(psh);
+#else
     /* Registering additional commands for the authorization process (optional) */
     cmd_reg_res = register_auth_commands(psh);
+#endif /* MICROSH_CFG_TERMINALS */
 #else
     /* Registering shell commands */
     cmd_reg_res = register_all_commands(psh);
 #endif /* MICROSH_CFG_CONSOLE_SESSIONS */
 
     if (cmd_reg_res != microshOK) {
-        microrl_print(&psh->mrl, "No memory to register all commands!"MICRORL_CFG_END_LINE);
+        psh->mrl.out_fn(&psh->mrl, "No memory to register all commands!"MICRORL_CFG_END_LINE);
+    }
+
+#if MICROSH_CFG_EVENTS
+    /* Application events may be posted from interrupts from now on */
+    events_init(psh);
+#endif /* MICROSH_CFG_EVENTS */
+
+#if MICROSH_CFG_SCRIPT
+    /* Script commands must be registered before compilation */
+    if (microsh_script_compile(psh, &boot_script, boot_script_text, NULL) != microshOK
+            || microsh_script_run(psh, &boot_script, NULL) != microshEXEC_OK) {
+        psh->mrl.out_fn(&psh->mrl, "Boot script failed!"MICRORL_CFG_END_LINE);
     }
+#endif /* MICROSH_CFG_SCRIPT */
 
-#if MICRORL_CFG_USE_COMPLETE
+#if MICRORL_CFG_USE_COMPLETE && !MICROSH_CFG_COMPLETION
     /* Set callback for auto-completion */
     microrl_set_complete_callback(&psh->mrl, complet);
-#endif /* MICRORL_CFG_USE_COMPLETE */
+#endif /* MICRORL_CFG_USE_COMPLETE && !MICROSH_CFG_COMPLETION */
 
 #if MICRORL_CFG_USE_CTRL_C
     /* Set callback for Ctrl+C handling */
@@ -82,34 +184,100 @@ int main (void/*int argc, char** argv*/) {
 #endif /* MICRORL_CFG_USE_CTRL_C */
 
     while (1) {
-#if MICROSH_CFG_CONSOLE_SESSIONS
+#if MICROSH_CFG_CONSOLE_SESSIONS && !MICROSH_CFG_TERMINALS
         if (sh.cmds[0].arg_num == 0) {
-            if (!sh.session.status.flags.logged_in) {
+            if (!microsh_session_is_logged_in(psh)) {
                 cmd_reg_res = register_auth_commands(psh);
             } else {
                 cmd_reg_res = register_all_commands(psh);
             }
 
             if (cmd_reg_res != microshOK) {
-                microrl_print(&psh->mrl, "No memory to register all commands!"MICRORL_CFG_END_LINE);
+                psh->mrl.out_fn(&psh->mrl, "No memory to register all commands!"MICRORL_CFG_END_LINE);
             }
         }
-#endif /* MICROSH_CFG_CONSOLE_SESSIONS */
+#endif /* MICROSH_CFG_CONSOLE_SESSIONS && !MICROSH_CFG_TERMINALS */
 
+#if MICROSH_CFG_ASYNC_LOG
+        /* Print log messages queued by interrupts and other tasks above the edited line */
+        microsh_log_process(psh);
+#endif /* MICROSH_CFG_ASYNC_LOG */
+
+#if MICROSH_CFG_AUDIT_LOG
+        /* Write queued audit records while waiting for input */
+        microsh_audit_flush(psh);
+#endif /* MICROSH_CFG_AUDIT_LOG */
+
+#if MICROSH_CFG_MUX
+        /* Send queued data of all channels */
+        while (microsh_mux_process(&mux) == microshOK) {}
+
+        /* Put received char to multiplexer, shell frames are passed to microrl instance */
+        char ch = get_char();
+        microsh_tick(psh, get_tick_ms());
+        microsh_mux_input(&mux, &ch, 1);
+#else
         /* Put received char from stdin to microrl instance */
         char ch = get_char();
+        microsh_tick(psh, get_tick_ms());
+#if MICROSH_CFG_HISTORY
+        microsh_hist_input(psh, &psh->mrl, &ch, 1);
+#else
         microrl_processing_input(&psh->mrl, &ch, 1);
+#endif /* MICROSH_CFG_HISTORY */
+#endif /* MICROSH_CFG_MUX */
     }
 
     return 0;
 }
 
-#if MICROSH_CFG_CONSOLE_SESSIONS
+#if MICROSH_CFG_CONSOLE_SESSIONS && !MICROSH_CFG_TERMINALS
 /**
- * \brief           Post log in callback. Clears auth commands
+ * \brief           Post log in callback. Replaces auth commands with session commands
+ * \note            Commands are registered right here, because input of several
+ *                      lines may be processed at once, e.g. from multiplexer frame
  * \param[in]       msh: microSH instance
  */
 static void log_in_callback(microsh_t* msh) {
     microsh_cmd_unregister_all(msh);
+    if (register_all_commands(msh) != microshOK) {
+        msh->mrl.out_fn(&msh->mrl, "No memory to register all commands!"MICRORL_CFG_END_LINE);
+    }
 }
-#endif /* MICROSH_CFG_CONSOLE_SESSIONS */
+#endif /* MICROSH_CFG_CONSOLE_SESSIONS && !MICROSH_CFG_TERMINALS */
+
+#if MICROSH_CFG_MUX
+/**
+ * \brief           Print callback for microrl, queues string to shell channel
+ * \param[in]       mrl: \ref microrl_t working instance
+ * \param[in]       str: Output string
+ * \return          Number of printed characters
+ */
+static int mux_print(microrl_t* mrl, const char* str) {
+    size_t len = strlen(str), n = 0;
+
+    MICROSH_UNUSED(mrl);
+
+    while (n < len) {
+        n += microsh_mux_write(&mux, 0, &str[n], len - n);
+
+        /* Send frame to free queue space if string does not fit */
+        if (n < len) {
+            microsh_mux_process(&mux);
+        }
+    }
+
+    return (int)len;
+}
+
+/**
+ * \brief           Multiplexer transport write callback
+ * \param[in]       mux: Multiplexer instance
+ * \param[in]       data: Encoded frame
+ * \param[in]       len: Frame length
+ */
+static void mux_tx(microsh_mux_t* mux, const uint8_t* data, size_t len) {
+    MICROSH_UNUSED(mux);
+    transport_write(data, len);
+}
+#endif /* MICROSH_CFG_MUX */
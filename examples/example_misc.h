@@ -47,10 +47,35 @@ microshr_t register_auth_commands(microsh_t* msh);
 microshr_t register_all_commands(microsh_t* msh);
 int        microrl_print(microrl_t* mrl, const char* str);
 char       get_char(void);
+uint32_t   get_tick_ms(void);
 
-#if MICRORL_CFG_USE_COMPLETE
+#if MICROSH_CFG_MUX
+void       transport_write(const uint8_t* data, size_t len);
+#endif /* MICROSH_CFG_MUX */
+
+#if MICROSH_CFG_TERMINALS
+void       terminals_init(microsh_t* msh);
+#endif /* MICROSH_CFG_TERMINALS */
+
+#if MICROSH_CFG_EVENTS
+void       events_init(microsh_t* msh);
+#endif /* MICROSH_CFG_EVENTS */
+
+#if MICROSH_CFG_AUDIT_LOG
+const microsh_audit_storage_t* audit_storage_init(void);
+#endif /* MICROSH_CFG_AUDIT_LOG */
+
+#if MICROSH_CFG_ALIASES
+const microsh_alias_storage_t* alias_storage_init(void);
+#endif /* MICROSH_CFG_ALIASES */
+
+#if MICROSH_CFG_HISTORY
+const microsh_hist_storage_t* hist_storage_init(void);
+#endif /* MICROSH_CFG_HISTORY */
+
+#if MICRORL_CFG_USE_COMPLETE && !MICROSH_CFG_COMPLETION
 char**     complet(microrl_t* mrl, int argc, const char* const *argv);
-#endif /* MICRORL_CFG_USE_COMPLETE */
+#endif /* MICRORL_CFG_USE_COMPLETE && !MICROSH_CFG_COMPLETION */
 
 #if MICRORL_CFG_USE_CTRL_C
 void       sigint(microrl_t* mrl);
@@ -0,0 +1,108 @@
+/**
+ * \file            linux_alias.c
+ * \brief           File-backed storage of command aliases
+ */
+
+/*
+ * Copyright (c) 2022 Dmitry KARASEV
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * This file is part of microSH - Shell for Embedded Systems library.
+ *
+ * Author:          Dmitry KARASEV <karasevsdmitry@yandex.ru>
+ * Version:         2.0.0-dev
+ */
+
+#include <stdio.h>
+#include "microsh.h"
+#include "example_misc.h"
+
+#if MICROSH_CFG_ALIASES
+
+#define _ALIAS_FILE_PATH            "microsh_alias.bin"
+
+static microshr_t prv_file_load(void* ctx, void* data, size_t len, size_t* read_len);
+static microshr_t prv_file_save(void* ctx, const void* data, size_t len);
+
+/* Aliases storage interface for microSH */
+static const microsh_alias_storage_t alias_storage = {
+    .load_fn = prv_file_load,
+    .save_fn = prv_file_save,
+    .ctx = NULL,
+};
+
+/**
+ * \brief           Get aliases storage kept in file
+ * \return          Pointer to aliases storage
+ */
+const microsh_alias_storage_t* alias_storage_init(void) {
+    return &alias_storage;
+}
+
+/**
+ * \brief           Load aliases image from file
+ * \param[in]       ctx: Unused storage context
+ * \param[out]      data: Buffer to read aliases image to
+ * \param[in]       len: Buffer length
+ * \param[out]      read_len: Length of stored image, `0` if file does not exist
+ * \return          \ref microshOK on success, member of \ref microshr_t otherwise
+ */
+static microshr_t prv_file_load(void* ctx, void* data, size_t len, size_t* read_len) {
+    FILE* file = fopen(_ALIAS_FILE_PATH, "rb");
+    microshr_t res = microshOK;
+
+    MICROSH_UNUSED(ctx);
+
+    *read_len = 0;
+    if (file == NULL) {
+        return microshOK;
+    }
+
+    *read_len = fread(data, 1, len, file);
+    if (ferror(file) || fgetc(file) != EOF) {
+        res = microshERR;
+    }
+    fclose(file);
+
+    return res;
+}
+
+/**
+ * \brief           Replace aliases image in file
+ * \param[in]       ctx: Unused storage context
+ * \param[in]       data: Aliases image
+ * \param[in]       len: Image length
+ * \return          \ref microshOK on success, member of \ref microshr_t otherwise
+ */
+static microshr_t prv_file_save(void* ctx, const void* data, size_t len) {
+    FILE* file = fopen(_ALIAS_FILE_PATH, "wb");
+    microshr_t res = microshOK;
+
+    MICROSH_UNUSED(ctx);
+
+    if (file == NULL) {
+        return microshERR;
+    }
+
+    if (fwrite(data, 1, len, file) != len) {
+        res = microshERR;
+    }
+    if (fclose(file) != 0) {
+        res = microshERR;
+    }
+
+    return res;
+}
+
+#endif /* MICROSH_CFG_ALIASES */
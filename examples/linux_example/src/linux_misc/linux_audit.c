@@ -0,0 +1,127 @@
+/**
+ * \file            linux_audit.c
+ * \brief           File-backed audit log storage emulating NOR flash sectors
+ */
+
+/*
+ * Copyright (c) 2022 Dmitry KARASEV
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * This file is part of microSH - Shell for Embedded Systems library.
+ *
+ * Author:          Dmitry KARASEV <karasevsdmitry@yandex.ru>
+ * Version:         2.0.0-dev
+ */
+
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include "microsh.h"
+#include "example_misc.h"
+
+#if MICROSH_CFG_AUDIT_LOG
+
+#define _AUDIT_FILE_PATH            "microsh_audit.bin"
+#define _AUDIT_SECTOR_SIZE          4096
+#define _AUDIT_SECTOR_NUM           4
+
+/* Audit storage file descriptor */
+static int audit_fd = -1;
+
+static microshr_t prv_file_read(void* ctx, uint32_t addr, void* data, size_t len);
+static microshr_t prv_file_write(void* ctx, uint32_t addr, const void* data, size_t len);
+static microshr_t prv_file_erase(void* ctx, uint32_t addr);
+
+/* Audit storage interface for microSH */
+static const microsh_audit_storage_t audit_storage = {
+    .read_fn = prv_file_read,
+    .write_fn = prv_file_write,
+    .erase_fn = prv_file_erase,
+    .sector_size = _AUDIT_SECTOR_SIZE,
+    .sector_num = _AUDIT_SECTOR_NUM,
+    .ctx = NULL,
+};
+
+/**
+ * \brief           Open audit storage file. New file is created in erased state
+ * \return          Pointer to audit storage on success, `NULL` otherwise
+ */
+const microsh_audit_storage_t* audit_storage_init(void) {
+    audit_fd = open(_AUDIT_FILE_PATH, O_RDWR | O_CREAT, 0644);
+    if (audit_fd < 0) {
+        return NULL;
+    }
+
+    if (lseek(audit_fd, 0, SEEK_END) < (off_t)(_AUDIT_SECTOR_SIZE * _AUDIT_SECTOR_NUM)) {
+        for (uint32_t i = 0; i < _AUDIT_SECTOR_NUM; ++i) {
+            if (prv_file_erase(NULL, i * _AUDIT_SECTOR_SIZE) != microshOK) {
+                close(audit_fd);
+                audit_fd = -1;
+                return NULL;
+            }
+        }
+    }
+
+    return &audit_storage;
+}
+
+/**
+ * \brief           Read data from audit storage file
+ * \param[in]       ctx: Unused storage context
+ * \param[in]       addr: Storage address
+ * \param[out]      data: Buffer to read data to
+ * \param[in]       len: Number of bytes to read
+ * \return          \ref microshOK on success, member of \ref microshr_t otherwise
+ */
+static microshr_t prv_file_read(void* ctx, uint32_t addr, void* data, size_t len) {
+    MICROSH_UNUSED(ctx);
+
+    return pread(audit_fd, data, len, addr) == (ssize_t)len ? microshOK : microshERR;
+}
+
+/**
+ * \brief           Write data to audit storage file
+ * \param[in]       ctx: Unused storage context
+ * \param[in]       addr: Storage address
+ * \param[in]       data: Data to write
+ * \param[in]       len: Number of bytes to write
+ * \return          \ref microshOK on success, member of \ref microshr_t otherwise
+ */
+static microshr_t prv_file_write(void* ctx, uint32_t addr, const void* data, size_t len) {
+    MICROSH_UNUSED(ctx);
+
+    if (pwrite(audit_fd, data, len, addr) != (ssize_t)len) {
+        return microshERR;
+    }
+
+    return fdatasync(audit_fd) == 0 ? microshOK : microshERR;
+}
+
+/**
+ * \brief           Erase sector of audit storage file, filling it with `0xFF`
+ * \param[in]       ctx: Unused storage context
+ * \param[in]       addr: Start address of sector to erase
+ * \return          \ref microshOK on success, member of \ref microshr_t otherwise
+ */
+static microshr_t prv_file_erase(void* ctx, uint32_t addr) {
+    uint8_t sector[_AUDIT_SECTOR_SIZE];
+
+    MICROSH_UNUSED(ctx);
+
+    memset(sector, 0xFF, sizeof(sector));
+
+    return prv_file_write(NULL, addr, sector, sizeof(sector));
+}
+
+#endif /* MICROSH_CFG_AUDIT_LOG */
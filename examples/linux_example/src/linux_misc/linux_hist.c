@@ -0,0 +1,127 @@
+/**
+ * \file            linux_hist.c
+ * \brief           File-backed command history storage emulating NOR flash sectors
+ */
+
+/*
+ * Copyright (c) 2022 Dmitry KARASEV
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * This file is part of microSH - Shell for Embedded Systems library.
+ *
+ * Author:          Dmitry KARASEV <karasevsdmitry@yandex.ru>
+ * Version:         2.0.0-dev
+ */
+
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include "microsh.h"
+#include "example_misc.h"
+
+#if MICROSH_CFG_HISTORY
+
+#define _HIST_FILE_PATH             "microsh_hist.bin"
+#define _HIST_SECTOR_SIZE           4096
+#define _HIST_SECTOR_NUM            32
+
+/* History storage file descriptor */
+static int hist_fd = -1;
+
+static microshr_t prv_file_read(void* ctx, uint32_t addr, void* data, size_t len);
+static microshr_t prv_file_write(void* ctx, uint32_t addr, const void* data, size_t len);
+static microshr_t prv_file_erase(void* ctx, uint32_t addr);
+
+/* History storage interface for microSH */
+static const microsh_hist_storage_t hist_storage = {
+    .read_fn = prv_file_read,
+    .write_fn = prv_file_write,
+    .erase_fn = prv_file_erase,
+    .sector_size = _HIST_SECTOR_SIZE,
+    .sector_num = _HIST_SECTOR_NUM,
+    .ctx = NULL,
+};
+
+/**
+ * \brief           Open history storage file. New file is created in erased state
+ * \return          Pointer to history storage on success, `NULL` otherwise
+ */
+const microsh_hist_storage_t* hist_storage_init(void) {
+    hist_fd = open(_HIST_FILE_PATH, O_RDWR | O_CREAT, 0644);
+    if (hist_fd < 0) {
+        return NULL;
+    }
+
+    if (lseek(hist_fd, 0, SEEK_END) < (off_t)(_HIST_SECTOR_SIZE * _HIST_SECTOR_NUM)) {
+        for (uint32_t i = 0; i < _HIST_SECTOR_NUM; ++i) {
+            if (prv_file_erase(NULL, i * _HIST_SECTOR_SIZE) != microshOK) {
+                close(hist_fd);
+                hist_fd = -1;
+                return NULL;
+            }
+        }
+    }
+
+    return &hist_storage;
+}
+
+/**
+ * \brief           Read data from history storage file
+ * \param[in]       ctx: Unused storage context
+ * \param[in]       addr: Storage address
+ * \param[out]      data: Buffer to read data to
+ * \param[in]       len: Number of bytes to read
+ * \return          \ref microshOK on success, member of \ref microshr_t otherwise
+ */
+static microshr_t prv_file_read(void* ctx, uint32_t addr, void* data, size_t len) {
+    MICROSH_UNUSED(ctx);
+
+    return pread(hist_fd, data, len, addr) == (ssize_t)len ? microshOK : microshERR;
+}
+
+/**
+ * \brief           Write data to history storage file
+ * \param[in]       ctx: Unused storage context
+ * \param[in]       addr: Storage address
+ * \param[in]       data: Data to write
+ * \param[in]       len: Number of bytes to write
+ * \return          \ref microshOK on success, member of \ref microshr_t otherwise
+ */
+static microshr_t prv_file_write(void* ctx, uint32_t addr, const void* data, size_t len) {
+    MICROSH_UNUSED(ctx);
+
+    if (pwrite(hist_fd, data, len, addr) != (ssize_t)len) {
+        return microshERR;
+    }
+
+    return fdatasync(hist_fd) == 0 ? microshOK : microshERR;
+}
+
+/**
+ * \brief           Erase sector of history storage file, filling it with `0xFF`
+ * \param[in]       ctx: Unused storage context
+ * \param[in]       addr: Start address of sector to erase
+ * \return          \ref microshOK on success, member of \ref microshr_t otherwise
+ */
+static microshr_t prv_file_erase(void* ctx, uint32_t addr) {
+    uint8_t sector[_HIST_SECTOR_SIZE];
+
+    MICROSH_UNUSED(ctx);
+
+    memset(sector, 0xFF, sizeof(sector));
+
+    return prv_file_write(NULL, addr, sector, sizeof(sector));
+}
+
+#endif /* MICROSH_CFG_HISTORY */
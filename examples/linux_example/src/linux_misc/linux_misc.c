@@ -0,0 +1,607 @@
+/**
+ * \file            linux_misc.c
+ * \brief           Linux host platform specific implementation routines
+ */
+
+/*
+ * Copyright (c) 2022 Dmitry KARASEV
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * This file is part of microSH - Shell for Embedded Systems library.
+ *
+ * Author:          Dmitry KARASEV <karasevsdmitry@yandex.ru>
+ * Version:         2.0.0-dev
+ */
+
+#include <signal.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <termios.h>
+#include <time.h>
+#include <unistd.h>
+#include "microsh.h"
+#include "linux_perf.h"
+#include "linux_term.h"
+
+#define _LINUX_DEMO_VER             "1.0"
+
+#define _ENDLINE_SEQ                MICRORL_CFG_END_LINE
+
+/* Definition commands word */
+#define _CMD_HELP                   "help"
+#define _CMD_CLEAR                  "clear"
+#define _CMD_SERNUM                 "sernum"
+#define _CMD_LOGOUT                 "logout"
+#define _CMD_PERF                   "perf"
+#define _CMD_AUDIT                  "audit"
+#define _CMD_SET                    "set"
+#define _CMD_UNSET                  "unset"
+#define _CMD_ENV                    "env"
+#define _CMD_ALIAS                  "alias"
+#define _CMD_UNALIAS                "unalias"
+#define _CMD_WATCH                  "watch"
+#define _CMD_AT                     "at"
+#define _CMD_EVERY                  "every"
+#define _CMD_ATRM                   "atrm"
+#define _CMD_ON                     "on"
+#define _CMD_ONRM                   "onrm"
+#define _CMD_HISTORY                "history"
+#define _CMD_MANIFEST               "manifest"
+
+/* Arguments for set/clear */
+#define _SCMD_RD                    "?"
+#define _SCMD_SAVE                  "save"
+
+#define _NUM_OF_CMD                 6
+#define _NUM_OF_SETCLEAR_SCMD       2
+
+#if MICRORL_CFG_USE_COMPLETE && !MICROSH_CFG_COMPLETION
+/* Completion by application, library completion is disabled */
+/* Available  commands */
+char* keyword[] = {_CMD_HELP, _CMD_CLEAR, _CMD_SERNUM, _CMD_LOGOUT, _CMD_PERF, _CMD_AUDIT};
+
+/* 'read/save' command argements */
+char* read_save_key[] = {_SCMD_RD, _SCMD_SAVE};
+
+/* Array for comletion */
+char* compl_word[_NUM_OF_CMD + 1];
+#endif /* MICRORL_CFG_USE_COMPLETE && !MICROSH_CFG_COMPLETION */
+
+/* Variable changeable with commands */
+uint32_t device_sn = 0;
+
+#if MICROSH_CFG_ARG_SCHEMA
+#if MICROSH_CFG_SUBCMDS
+/* 'sernum' argument: non-zero serial number value, 'read/save' are subcommands */
+static const microsh_arg_t sernum_args[] = {
+    { .type = microshARG_U32, .min = 1, .max = UINT32_MAX }
+};
+#else
+/* 'sernum' argument: 'read/save' keyword or non-zero serial number value */
+static const char* const sernum_keys[] = {_SCMD_RD, _SCMD_SAVE, NULL};
+static const microsh_arg_t sernum_args[] = {
+    { .type = microshARG_U32, .min = 1, .max = UINT32_MAX, .keywords = sernum_keys }
+};
+#endif /* MICROSH_CFG_SUBCMDS */
+static const microsh_arg_schema_t sernum_schema = { .args = sernum_args, .num = 1, .min_num = 1 };
+#endif /* MICROSH_CFG_ARG_SCHEMA */
+
+/* Terminal settings to restore on exit */
+static struct termios term_orig;
+
+#if MICROSH_CFG_CMD_PROFILING
+/* perf_event counters backend, `NULL` if not available */
+static const microsh_prof_backend_t* perf_backend;
+#endif /* MICROSH_CFG_CMD_PROFILING */
+
+#if MICROSH_CFG_EVENTS
+#define _EVENT_USR1                 0x0001
+
+/* Application events, `kill -USR1 PID` posts `usr1` event */
+static const microsh_event_name_t event_names[] = {
+    { .id = _EVENT_USR1, .name = "usr1" },
+};
+static microsh_t* event_msh;
+#endif /* MICROSH_CFG_EVENTS */
+
+static int help_cmd(microsh_t* msh, int argc, const char* const *argv);
+static int clear_screen_cmd(microsh_t* msh, int argc, const char* const *argv);
+static int sernum_cmd(microsh_t* msh, int argc, const char* const *argv);
+static int sernum_read_cmd(microsh_t* msh, int argc, const char* const *argv);
+static int sernum_save_cmd(microsh_t* msh, int argc, const char* const *argv);
+#if MICROSH_CFG_CONSOLE_SESSIONS
+static int logout_cmd(microsh_t* msh, int argc, const char* const *argv);
+#endif /* MICROSH_CFG_CONSOLE_SESSIONS */
+
+#if MICROSH_CFG_SUBCMDS
+/* 'sernum' subcommands, serial number value is handled by 'sernum' itself */
+static const microsh_cmd_t sernum_subcmds[] = {
+    { .name = _SCMD_RD,   .arg_num = 1, .desc = "Read serial number value",         .cmd_fn = sernum_read_cmd },
+    { .name = _SCMD_SAVE, .arg_num = 1, .desc = "Save serial number value to file", .cmd_fn = sernum_save_cmd }
+};
+#endif /* MICROSH_CFG_SUBCMDS */
+
+/**
+ * \brief           Restore terminal settings and release resources
+ */
+static void deinit(void) {
+    if (isatty(STDIN_FILENO)) {
+        tcsetattr(STDIN_FILENO, TCSANOW, &term_orig);
+    }
+#if MICROSH_CFG_CMD_PROFILING
+    linux_perf_deinit();
+#endif /* MICROSH_CFG_CMD_PROFILING */
+}
+
+/**
+ * \brief           Init Linux host platform. Switches terminal to raw mode
+ *                      if stdin is a terminal, otherwise input is read as script
+ */
+void init(void) {
+    if (isatty(STDIN_FILENO)) {
+        struct termios term;
+
+        tcgetattr(STDIN_FILENO, &term_orig);
+        term = term_orig;
+        term.c_lflag &= ~(ICANON | ECHO | ISIG);
+        term.c_cc[VMIN] = 1;
+        term.c_cc[VTIME] = 0;
+        tcsetattr(STDIN_FILENO, TCSANOW, &term);
+    }
+
+#if MICROSH_CFG_CMD_PROFILING
+    perf_backend = linux_perf_init();
+    if (perf_backend == NULL) {
+        fprintf(stderr, "perf_event counters are not available, profiling is disabled"_ENDLINE_SEQ);
+    }
+#endif /* MICROSH_CFG_CMD_PROFILING */
+
+    atexit(deinit);
+}
+
+#if MICROSH_CFG_CONSOLE_SESSIONS
+/**
+ * \brief           Register commands that may be used in authorization process
+ * \param[in]       msh: \ref microsh_t working instance
+ * \return          \ref microshOK on success, member of \ref microshr_t otherwise
+ */
+microshr_t register_auth_commands(microsh_t* msh) {
+    microshr_t result = microshOK;
+
+    result |= microsh_cmd_register(msh, 1, _CMD_HELP,   help_cmd,         NULL);
+
+    return result;
+}
+#endif /* MICROSH_CFG_CONSOLE_SESSIONS */
+
+/**
+ * \brief           Register all commands used by shell
+ * \param[in]       msh: \ref microsh_t working instance
+ * \return          \ref microshOK on success, member of \ref microshr_t otherwise
+ */
+microshr_t register_all_commands(microsh_t* msh) {
+    microshr_t result = microshOK;
+
+    result |= microsh_cmd_register(msh, 1, _CMD_HELP,   help_cmd,         NULL);
+    result |= microsh_cmd_register(msh, 1, _CMD_CLEAR,  clear_screen_cmd, NULL);
+    result |= microsh_cmd_register(msh, 2, _CMD_SERNUM, sernum_cmd,       NULL);
+#if MICROSH_CFG_ARG_SCHEMA
+    result |= microsh_cmd_set_schema(msh, _CMD_SERNUM, &sernum_schema);
+#endif /* MICROSH_CFG_ARG_SCHEMA */
+#if MICROSH_CFG_SUBCMDS
+    result |= microsh_cmd_set_subcmds(msh, _CMD_SERNUM, sernum_subcmds, MICROSH_ARRAYSIZE(sernum_subcmds));
+#endif /* MICROSH_CFG_SUBCMDS */
+#if MICROSH_CFG_CONSOLE_SESSIONS
+    result |= microsh_cmd_register(msh, 1, _CMD_LOGOUT, logout_cmd,       NULL);
+#endif /* MICROSH_CFG_CONSOLE_SESSIONS */
+#if MICROSH_CFG_CMD_PROFILING
+    if (perf_backend != NULL) {
+        result |= microsh_cmd_register(msh, 2, _CMD_PERF, microsh_prof_cmd, "Print command counters, 'perf reset' to clear");
+        result |= microsh_prof_set_backend(msh, perf_backend);
+    }
+#endif /* MICROSH_CFG_CMD_PROFILING */
+#if MICROSH_CFG_AUDIT_LOG
+    result |= microsh_cmd_register(msh, 2, _CMD_AUDIT, microsh_audit_cmd, "Print the newest audit records, 'audit N' to print N records");
+#endif /* MICROSH_CFG_AUDIT_LOG */
+#if MICROSH_CFG_VARS
+    result |= microsh_cmd_register(msh, 3, _CMD_SET,    microsh_var_set_cmd,   "Set variable, 'set NAME VALUE'");
+    result |= microsh_cmd_register(msh, 2, _CMD_UNSET,  microsh_var_unset_cmd, "Delete variable, 'unset NAME'");
+    result |= microsh_cmd_register(msh, 1, _CMD_ENV,    microsh_var_env_cmd,   "Print all variables");
+#endif /* MICROSH_CFG_VARS */
+#if MICROSH_CFG_ALIASES
+    result |= microsh_cmd_register(msh, MICRORL_CFG_CMD_TOKEN_NMB, _CMD_ALIAS, microsh_alias_cmd, "Print aliases, 'alias NAME BODY' to define alias");
+    result |= microsh_cmd_register(msh, 2, _CMD_UNALIAS, microsh_alias_unset_cmd, "Delete alias, 'unalias NAME'");
+#endif /* MICROSH_CFG_ALIASES */
+#if MICROSH_CFG_WATCH
+    result |= microsh_cmd_register(msh, MICRORL_CFG_CMD_TOKEN_NMB, _CMD_WATCH, microsh_watch_cmd, "Run command periodically, 'watch N CMD' to run it every N seconds");
+#endif /* MICROSH_CFG_WATCH */
+#if MICROSH_CFG_SCHED
+    result |= microsh_cmd_register(msh, MICRORL_CFG_CMD_TOKEN_NMB, _CMD_AT, microsh_sched_at_cmd, "Print jobs, 'at TIME CMD' to run command once after TIME");
+    result |= microsh_cmd_register(msh, MICRORL_CFG_CMD_TOKEN_NMB, _CMD_EVERY, microsh_sched_every_cmd, "Run command periodically, 'every TIME CMD'");
+    result |= microsh_cmd_register(msh, 2, _CMD_ATRM, microsh_sched_atrm_cmd, "Cancel job, 'atrm ID'");
+#endif /* MICROSH_CFG_SCHED */
+#if MICROSH_CFG_EVENTS
+    result |= microsh_cmd_register(msh, MICRORL_CFG_CMD_TOKEN_NMB, _CMD_ON, microsh_event_on_cmd, "Print bindings, 'on EVENT CMD' to run command on event");
+    result |= microsh_cmd_register(msh, 2, _CMD_ONRM, microsh_event_onrm_cmd, "Remove binding, 'onrm NUM'");
+#endif /* MICROSH_CFG_EVENTS */
+#if MICROSH_CFG_HISTORY
+    result |= microsh_cmd_register(msh, 2, _CMD_HISTORY, microsh_hist_cmd, "Print the newest stored lines, 'history N' to print N lines");
+#endif /* MICROSH_CFG_HISTORY */
+#if MICROSH_CFG_MANIFEST
+    result |= microsh_cmd_register(msh, 1, _CMD_MANIFEST, microsh_manifest_cmd, "Print registered commands as JSON for host tools");
+#endif /* MICROSH_CFG_MANIFEST */
+
+    return result;
+}
+
+/**
+ * \brief           Print to IO stream callback for MicroRL library
+ * \param[in]       mrl: \ref microrl_t working instance
+ * \param[in]       str: Output string
+ * \return          The number of characters that would have been written,
+ *                      not counting the terminating null character.
+ */
+int microrl_print(microrl_t* mrl, const char* str) {
+    MICROSH_UNUSED(mrl);
+
+    int len = fputs(str, stdout) < 0 ? 0 : (int)strlen(str);
+    fflush(stdout);
+
+    return len;
+}
+
+#if MICROSH_CFG_MUX
+/**
+ * \brief           Write multiplexer frame to stdout
+ * \param[in]       data: Encoded frame
+ * \param[in]       len: Frame length
+ */
+void transport_write(const uint8_t* data, size_t len) {
+    fwrite(data, 1, len, stdout);
+    fflush(stdout);
+}
+#endif /* MICROSH_CFG_MUX */
+
+/**
+ * \brief           Print formatted string through shell output callback
+ * \param[in]       msh: \ref microsh_t working instance
+ * \param[in]       fmt: Format string
+ */
+static void print(microsh_t* msh, const char* fmt, ...) {
+    microrl_t* mrl = microsh_get_mrl(msh);
+    char str[128];
+    va_list args;
+
+    va_start(args, fmt);
+    vsnprintf(str, sizeof(str), fmt, args);
+    va_end(args);
+
+    mrl->out_fn(mrl, str);
+}
+
+/**
+ * \brief           Get char user pressed. Exits application at the end of input
+ * \return          Input character
+ */
+char get_char(void) {
+    int ch;
+
+#if MICROSH_CFG_TERMINALS
+    /* Serve network terminals while console is idle */
+    linux_term_wait_stdin();
+#endif /* MICROSH_CFG_TERMINALS */
+    ch = getchar();
+
+    if (ch == EOF) {
+        exit(0);
+    }
+
+    return (char)ch;
+}
+
+/**
+ * \brief           Get monotonic time
+ * \return          Time in milliseconds
+ */
+uint32_t get_tick_ms(void) {
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+
+    return (uint32_t)(ts.tv_sec * 1000 + ts.tv_nsec / 1000000);
+}
+
+#if MICROSH_CFG_EVENTS
+/**
+ * \brief           SIGUSR1 handler, signal context is like an interrupt
+ * \param[in]       sig: Signal number
+ */
+static void usr1_handler(int sig) {
+    MICROSH_UNUSED(sig);
+
+    microsh_event_post(event_msh, _EVENT_USR1);
+}
+
+/**
+ * \brief           Name application events and post them from signal handler
+ * \param[in]       msh: \ref microsh_t working instance
+ */
+void events_init(microsh_t* msh) {
+    struct sigaction sa;
+
+    event_msh = msh;
+    microsh_event_set_names(msh, event_names, MICROSH_ARRAYSIZE(event_names));
+
+    /* poll() is interrupted anyway, so bound command runs without waiting for input */
+    memset(&sa, 0x00, sizeof(sa));
+    sa.sa_handler = usr1_handler;
+    sa.sa_flags = SA_RESTART;
+    sigemptyset(&sa.sa_mask);
+    sigaction(SIGUSR1, &sa, NULL);
+}
+#endif /* MICROSH_CFG_EVENTS */
+
+/**
+ * \brief           HELP command execution
+ * \param[in]       msh: \ref microsh_t working instance
+ * \param[in]       argc: argument count
+ * \param[in]       argv: pointer array to token string
+ * \return          \ref microshEXEC_OK on success, member of
+ *                      \ref microsh_execr_t enumeration otherwise
+ */
+static int help_cmd(microsh_t* msh, int argc, const char* const *argv) {
+    MICRORL_UNUSED(msh);
+    MICRORL_UNUSED(argc);
+    MICRORL_UNUSED(argv);
+
+    print(msh, "MicroSH library Linux DEMO v"_LINUX_DEMO_VER _ENDLINE_SEQ);
+    print(msh, "Use TAB key for completion"_ENDLINE_SEQ);
+#if MICROSH_CFG_CONSOLE_SESSIONS
+    if (!microsh_session_is_logged_in(msh)) {
+        print(msh, _ENDLINE_SEQ"You must log in to one of the sessions."_ENDLINE_SEQ);
+        print(msh, "After authorization, session commands will be available."_ENDLINE_SEQ);
+        print(msh, "Different commands may be available for different sessions."_ENDLINE_SEQ);
+    } else {
+#endif /* MICROSH_CFG_CONSOLE_SESSIONS */
+        print(msh, "List of commands:"_ENDLINE_SEQ);
+        print(msh, "\tclear               - clear screen"_ENDLINE_SEQ);
+        print(msh, "\tsernum ?            - read serial number value"_ENDLINE_SEQ);
+        print(msh, "\tsernum VALUE        - set serial number value"_ENDLINE_SEQ);
+        print(msh, "\tsernum save         - save serial number value to file"_ENDLINE_SEQ);
+        print(msh, "\tlogout              - end an authorized session"_ENDLINE_SEQ);
+#if MICROSH_CFG_CMD_PROFILING
+        print(msh, "\tperf [reset]        - print or clear command counters"_ENDLINE_SEQ);
+#endif /* MICROSH_CFG_CMD_PROFILING */
+#if MICROSH_CFG_AUDIT_LOG
+        print(msh, "\taudit [N]           - print the newest audit records"_ENDLINE_SEQ);
+#endif /* MICROSH_CFG_AUDIT_LOG */
+#if MICROSH_CFG_VARS
+        print(msh, "\tset NAME VALUE      - set variable, use it as $NAME"_ENDLINE_SEQ);
+        print(msh, "\tunset NAME          - delete variable"_ENDLINE_SEQ);
+        print(msh, "\tenv                 - print all variables"_ENDLINE_SEQ);
+#endif /* MICROSH_CFG_VARS */
+#if MICROSH_CFG_ALIASES
+        print(msh, "\talias [NAME [BODY]] - print aliases or define alias, '$1'..'$9' are its arguments"_ENDLINE_SEQ);
+        print(msh, "\tunalias NAME        - delete alias"_ENDLINE_SEQ);
+#endif /* MICROSH_CFG_ALIASES */
+#if MICROSH_CFG_WATCH
+        print(msh, "\twatch N CMD         - run command every N seconds, Ctrl+C to stop"_ENDLINE_SEQ);
+#endif /* MICROSH_CFG_WATCH */
+#if MICROSH_CFG_SCHED
+        print(msh, "\tat [TIME CMD]       - print jobs or run command once after TIME, e.g. '5m' or '30'"_ENDLINE_SEQ);
+        print(msh, "\tevery TIME CMD      - run command every TIME"_ENDLINE_SEQ);
+        print(msh, "\tatrm ID             - cancel job"_ENDLINE_SEQ);
+#endif /* MICROSH_CFG_SCHED */
+#if MICROSH_CFG_EVENTS
+        print(msh, "\ton [EVENT CMD]      - print bindings or run command on each EVENT"_ENDLINE_SEQ);
+        print(msh, "\tonrm NUM            - remove binding"_ENDLINE_SEQ);
+#endif /* MICROSH_CFG_EVENTS */
+#if MICROSH_CFG_HISTORY
+        print(msh, "\thistory [N]         - print the newest stored lines, Ctrl+R to search them"_ENDLINE_SEQ);
+#endif /* MICROSH_CFG_HISTORY */
+#if MICROSH_CFG_MANIFEST
+        print(msh, "\tmanifest            - print registered commands as JSON for host tools"_ENDLINE_SEQ);
+#endif /* MICROSH_CFG_MANIFEST */
+#if MICROSH_CFG_CONSOLE_SESSIONS
+    }
+#endif /* MICROSH_CFG_CONSOLE_SESSIONS */
+
+    return microshEXEC_OK;
+}
+
+/**
+ * \brief           CLEAR command execution
+ * \param[in]       msh: \ref microsh_t working instance
+ * \param[in]       argc: argument count
+ * \param[in]       argv: pointer array to token string
+ * \return          \ref microshEXEC_OK on success, member of
+ *                      \ref microsh_execr_t enumeration otherwise
+ */
+static int clear_screen_cmd(microsh_t* msh, int argc, const char* const *argv) {
+    MICRORL_UNUSED(argc);
+    MICRORL_UNUSED(argv);
+
+    print(msh, "\033[2J");    /* ESC seq for clear entire screen */
+    print(msh, "\033[H");     /* ESC seq for move cursor at left-top corner */
+
+    return microshEXEC_OK;
+}
+
+/**
+ * \brief           SERNUM command execution
+ * \param[in]       msh: \ref microsh_t working instance
+ * \param[in]       argc: argument count
+ * \param[in]       argv: pointer array to token string
+ * \return          \ref microshEXEC_OK on success, member of
+ *                      \ref microsh_execr_t enumeration otherwise
+ */
+static int sernum_cmd(microsh_t* msh, int argc, const char* const *argv) {
+#if !MICROSH_CFG_SUBCMDS
+    /* Without subcommand tables 'read/save' come here as argument */
+    if (argc > 1 && strcmp(argv[1], _SCMD_RD) == 0) {
+        return sernum_read_cmd(msh, argc - 1, &argv[1]);
+    } else if (argc > 1 && strcmp(argv[1], _SCMD_SAVE) == 0) {
+        return sernum_save_cmd(msh, argc - 1, &argv[1]);
+    }
+#endif /* !MICROSH_CFG_SUBCMDS */
+
+#if MICROSH_CFG_ARG_SCHEMA
+    /* Argument is validated by schema */
+    MICRORL_UNUSED(argc);
+    MICRORL_UNUSED(argv);
+
+    device_sn = microsh_arg_values(msh)[1].u32;
+#else
+    uint32_t sn;
+
+    if (argc < 2) {
+        print(msh, "Read or specify serial number"_ENDLINE_SEQ);
+        return microshEXEC_ERROR;
+    }
+
+    sn = (uint32_t)strtoul(argv[1], NULL, 10);
+    if (sn == 0) {
+        print(msh, "\tS/N not set"_ENDLINE_SEQ);
+        return microshEXEC_OK;
+    }
+    device_sn = sn;
+#endif /* MICROSH_CFG_ARG_SCHEMA */
+    print(msh, "\tset S/N %lu"_ENDLINE_SEQ, (unsigned long)device_sn);
+
+    return microshEXEC_OK;
+}
+
+/**
+ * \brief           SERNUM ? command execution
+ * \param[in]       msh: \ref microsh_t working instance
+ * \param[in]       argc: argument count
+ * \param[in]       argv: pointer array to token string
+ * \return          \ref microshEXEC_OK on success, member of
+ *                      \ref microsh_execr_t enumeration otherwise
+ */
+static int sernum_read_cmd(microsh_t* msh, int argc, const char* const *argv) {
+    MICRORL_UNUSED(argc);
+    MICRORL_UNUSED(argv);
+
+    print(msh, "\tS/N %lu"_ENDLINE_SEQ, (unsigned long)device_sn);
+
+    return microshEXEC_OK;
+}
+
+/**
+ * \brief           SERNUM SAVE command execution
+ * \param[in]       msh: \ref microsh_t working instance
+ * \param[in]       argc: argument count
+ * \param[in]       argv: pointer array to token string
+ * \return          \ref microshEXEC_OK on success, member of
+ *                      \ref microsh_execr_t enumeration otherwise
+ */
+static int sernum_save_cmd(microsh_t* msh, int argc, const char* const *argv) {
+    MICRORL_UNUSED(argc);
+    MICRORL_UNUSED(argv);
+
+    print(msh, "\tS/N save done"_ENDLINE_SEQ);
+
+    return microshEXEC_OK;
+}
+
+#if MICROSH_CFG_CONSOLE_SESSIONS
+/**
+ * \brief           LOGOUT command execution
+ * \param[in]       msh: \ref microsh_t working instance
+ * \param[in]       argc: argument count
+ * \param[in]       argv: pointer array to token string
+ * \return          \ref microshEXEC_OK on success, member of
+ *                      \ref microsh_execr_t enumeration otherwise
+ */
+static int logout_cmd(microsh_t* msh, int argc, const char* const *argv) {
+    MICRORL_UNUSED(argc);
+    MICRORL_UNUSED(argv);
+
+    microsh_session_logout(msh);
+#if !MICROSH_CFG_TERMINALS
+    microsh_cmd_unregister_all(msh);
+#endif /* !MICROSH_CFG_TERMINALS */
+    print(msh, "Logged out"_ENDLINE_SEQ);
+
+    return microshEXEC_OK;
+}
+#endif /* MICROSH_CFG_CONSOLE_SESSIONS */
+
+#if (MICRORL_CFG_USE_COMPLETE && !MICROSH_CFG_COMPLETION) || __DOXYGEN__
+/**
+ * \brief           Completion callback for MicroRL library
+ * \param[in,out]   mrl: \ref microrl_t working instance
+ * \param[in]       argc: argument count
+ * \param[in]       argv: pointer array to token string
+ * \return          NULL-terminated string, contain complite variant split by 'Whitespace'
+ */
+char** complet(microrl_t* mrl, int argc, const char* const *argv) {
+    MICRORL_UNUSED(mrl);
+    int j = 0;
+
+    compl_word[0] = NULL;
+
+    /* If there is token in cmdline */
+    if (argc == 1) {
+        /* Get last entered token */
+        char* bit = (char*)argv[argc - 1];
+        /* Iterate through our available token and match it */
+        for (int i = 0; i < _NUM_OF_CMD; ++i) {
+            /* If token is matched (text is part of our token starting from 0 char) */
+            if (strstr(keyword[i], bit) == keyword[i]) {
+                /* Add it to completion set */
+                compl_word[j++] = keyword[i];
+            }
+        }
+    }  else if ((argc > 1) && (strcmp(argv[0], _CMD_SERNUM) == 0)) {   /* If command needs subcommands */
+        /* Iterate through subcommand */
+        for (int i = 0; i < _NUM_OF_SETCLEAR_SCMD; ++i) {
+            if (strstr(read_save_key[i], argv[argc - 1]) == read_save_key[i]) {
+                compl_word[j++] = read_save_key[i];
+            }
+        }
+    } else {    /* If there is no token in cmdline, just print all available token */
+        for (; j < _NUM_OF_CMD; ++j) {
+            compl_word[j] = keyword[j];
+        }
+    }
+
+    /* Note! Last ptr in array always must be NULL!!! */
+    compl_word[j] = NULL;
+
+    /* Return set of variants */
+    return compl_word;
+}
+#endif /* (MICRORL_CFG_USE_COMPLETE && !MICROSH_CFG_COMPLETION) || __DOXYGEN__ */
+
+#if MICRORL_CFG_USE_CTRL_C || __DOXYGEN__
+/**
+ * \brief           Ctrl+C terminal signal function. Exits application
+ * \param[in]       mrl: \ref microrl_t working instance
+ */
+void sigint(microrl_t* mrl) {
+#if MICROSH_CFG_WATCH
+    /* Ctrl+C stops watched command of terminal first */
+    if (microsh_watch_stop(mrl) == microshOK) {
+        mrl->out_fn(mrl, mrl->prompt_str);
+        return;
+    }
+#endif /* MICROSH_CFG_WATCH */
+    mrl->out_fn(mrl, "^C"_ENDLINE_SEQ);
+    exit(0);
+}
+#endif /* MICRORL_CFG_USE_CTRL_C || __DOXYGEN__ */
@@ -0,0 +1,137 @@
+/**
+ * \file            linux_perf.c
+ * \brief           Linux perf_event based command profiling backend
+ */
+
+/*
+ * Copyright (c) 2022 Dmitry KARASEV
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * This file is part of microSH - Shell for Embedded Systems library.
+ *
+ * Author:          Dmitry KARASEV <karasevsdmitry@yandex.ru>
+ * Version:         2.0.0-dev
+ */
+
+#include <string.h>
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <linux/perf_event.h>
+#include "linux_perf.h"
+
+#if MICROSH_CFG_CMD_PROFILING
+
+#define _PERF_NUM_EVENTS            3
+
+/* Hardware events in perf group order, the first one is group leader */
+static const uint64_t perf_events[_PERF_NUM_EVENTS] = {
+    PERF_COUNT_HW_CPU_CYCLES,
+    PERF_COUNT_HW_INSTRUCTIONS,
+    PERF_COUNT_HW_CACHE_MISSES,
+};
+
+/* Opened perf events file descriptors */
+static int perf_fd[_PERF_NUM_EVENTS] = {-1, -1, -1};
+
+static microshr_t prv_perf_start(microsh_t* msh);
+static microshr_t prv_perf_stop(microsh_t* msh, uint64_t* counters);
+
+/* Counters backend for microSH */
+static const microsh_prof_backend_t perf_backend = {
+    .start_fn = prv_perf_start,
+    .stop_fn = prv_perf_stop,
+    .names = {"cycles", "instructions", "cache-misses"},
+};
+
+/**
+ * \brief           Open perf events group counting current thread in user space
+ * \return          Pointer to counters backend on success, `NULL` otherwise
+ */
+const microsh_prof_backend_t* linux_perf_init(void) {
+    struct perf_event_attr attr;
+
+    for (size_t i = 0; i < _PERF_NUM_EVENTS; ++i) {
+        memset(&attr, 0x00, sizeof(attr));
+        attr.size = sizeof(attr);
+        attr.type = PERF_TYPE_HARDWARE;
+        attr.config = perf_events[i];
+        attr.disabled = i == 0 ? 1 : 0;
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+        attr.read_format = PERF_FORMAT_GROUP;
+
+        perf_fd[i] = (int)syscall(SYS_perf_event_open, &attr, 0, -1, i == 0 ? -1 : perf_fd[0], 0);
+        if (perf_fd[i] < 0) {
+            linux_perf_deinit();
+            return NULL;
+        }
+    }
+
+    return &perf_backend;
+}
+
+/**
+ * \brief           Close all opened perf events
+ */
+void linux_perf_deinit(void) {
+    for (size_t i = 0; i < _PERF_NUM_EVENTS; ++i) {
+        if (perf_fd[i] >= 0) {
+            close(perf_fd[i]);
+            perf_fd[i] = -1;
+        }
+    }
+}
+
+/**
+ * \brief           Reset and enable perf events group
+ * \param[in]       msh: microSH instance
+ * \return          \ref microshOK on success, member of \ref microshr_t otherwise
+ */
+static microshr_t prv_perf_start(microsh_t* msh) {
+    MICROSH_UNUSED(msh);
+
+    if (ioctl(perf_fd[0], PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP) < 0 ||
+            ioctl(perf_fd[0], PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP) < 0) {
+        return microshERR;
+    }
+
+    return microshOK;
+}
+
+/**
+ * \brief           Disable perf events group and read all its counters at once
+ * \param[in]       msh: microSH instance
+ * \param[out]      counters: Counted values
+ * \return          \ref microshOK on success, member of \ref microshr_t otherwise
+ */
+static microshr_t prv_perf_stop(microsh_t* msh, uint64_t* counters) {
+    /* PERF_FORMAT_GROUP layout: number of events followed by values */
+    uint64_t data[1 + _PERF_NUM_EVENTS];
+
+    MICROSH_UNUSED(msh);
+
+    if (ioctl(perf_fd[0], PERF_EVENT_IOC_DISABLE, PERF_IOC_FLAG_GROUP) < 0 ||
+            read(perf_fd[0], data, sizeof(data)) != (ssize_t)sizeof(data)) {
+        return microshERR;
+    }
+
+    for (size_t i = 0; i < _PERF_NUM_EVENTS && i < MICROSH_CFG_PROF_NUM_COUNTERS; ++i) {
+        counters[i] = data[1 + i];
+    }
+
+    return microshOK;
+}
+
+#endif /* MICROSH_CFG_CMD_PROFILING */
@@ -0,0 +1,249 @@
+/**
+ * \file            linux_term.c
+ * \brief           Additional shell terminals over TCP connections
+ */
+
+/*
+ * Copyright (c) 2022 Dmitry KARASEV
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * This file is part of microSH - Shell for Embedded Systems library.
+ *
+ * Author:          Dmitry KARASEV <karasevsdmitry@yandex.ru>
+ * Version:         2.0.0-dev
+ */
+
+#include <errno.h>
+#include <limits.h>
+#include <stdio.h>
+#include <string.h>
+#include <poll.h>
+#include <unistd.h>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include "microsh.h"
+#include "example_misc.h"
+#include "linux_term.h"
+
+#if MICROSH_CFG_TERMINALS
+
+#define _TERM_PORT                  2323
+#define _TERM_NUM                   32
+
+/**
+ * \brief           Terminal of TCP connection
+ */
+typedef struct {
+    microsh_term_t term;                        /*!< Shell terminal. Must be the first member */
+    int fd;                                     /*!< Connection socket, `-1` if slot is free */
+    uint8_t closing;                            /*!< Connection is closed after current input is processed */
+} linux_term_t;
+
+static linux_term_t terms[_TERM_NUM];
+static microsh_t* term_msh;
+static int listen_fd = -1;
+
+static int  prv_term_print(microrl_t* mrl, const char* str);
+static void prv_term_accept(void);
+static void prv_term_close(linux_term_t* t);
+#if MICRORL_CFG_USE_CTRL_C
+static void prv_term_sigint(microrl_t* mrl);
+#endif /* MICRORL_CFG_USE_CTRL_C */
+
+/**
+ * \brief           Start listening for terminal connections on localhost
+ * \param[in]       msh: \ref microsh_t working instance
+ */
+void terminals_init(microsh_t* msh) {
+    struct sockaddr_in addr;
+    int opt = 1;
+
+    term_msh = msh;
+    for (size_t i = 0; i < _TERM_NUM; ++i) {
+        terms[i].fd = -1;
+    }
+
+    memset(&addr, 0x00, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(_TERM_PORT);
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+
+    listen_fd = socket(AF_INET, SOCK_STREAM, 0);
+    if (listen_fd < 0
+            || setsockopt(listen_fd, SOL_SOCKET, SO_REUSEADDR, &opt, sizeof(opt)) < 0
+            || bind(listen_fd, (struct sockaddr*)&addr, sizeof(addr)) < 0
+            || listen(listen_fd, 4) < 0) {
+        if (listen_fd >= 0) {
+            close(listen_fd);
+            listen_fd = -1;
+        }
+        fprintf(stderr, "Terminals port %d is not available"MICRORL_CFG_END_LINE, _TERM_PORT);
+        return;
+    }
+
+    /* Data in stdio buffer is not seen by poll() */
+    setvbuf(stdin, NULL, _IONBF, 0);
+}
+
+/**
+ * \brief           Serve terminal connections until stdin has data
+ * \note            Waiting time is limited by the next shell deadline only
+ */
+void linux_term_wait_stdin(void) {
+    struct pollfd fds[_TERM_NUM + 2];
+    linux_term_t* polled[_TERM_NUM];
+
+    while (1) {
+        size_t nfds = 0, nterms = 0;
+        uint32_t deadline;
+
+        fds[nfds].fd = STDIN_FILENO;
+        fds[nfds++].events = POLLIN;
+        if (listen_fd >= 0) {
+            fds[nfds].fd = listen_fd;
+            fds[nfds++].events = POLLIN;
+        }
+        for (size_t i = 0; i < _TERM_NUM; ++i) {
+            if (terms[i].fd >= 0) {
+                polled[nterms++] = &terms[i];
+                fds[nfds].fd = terms[i].fd;
+                fds[nfds++].events = POLLIN;
+            }
+        }
+
+        deadline = microsh_tick(term_msh, get_tick_ms());
+        if (poll(fds, nfds, deadline > INT_MAX ? -1 : (int)deadline) < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return;
+        }
+
+        if (fds[0].revents != 0) {
+            return;
+        }
+        if (listen_fd >= 0 && fds[1].revents != 0) {
+            prv_term_accept();
+        }
+
+        for (size_t i = 0; i < nterms; ++i) {
+            struct pollfd* pfd = &fds[nfds - nterms + i];
+            char buf[64];
+            ssize_t len;
+
+            if (pfd->revents == 0) {
+                continue;
+            }
+
+            len = recv(pfd->fd, buf, sizeof(buf), 0);
+            if (len <= 0) {
+                prv_term_close(polled[i]);
+                continue;
+            }
+            microsh_tick(term_msh, get_tick_ms());
+#if MICROSH_CFG_HISTORY
+            microsh_hist_input(term_msh, &polled[i]->term.mrl, buf, (size_t)len);
+#else
+            microrl_processing_input(&polled[i]->term.mrl, buf, (size_t)len);
+#endif /* MICROSH_CFG_HISTORY */
+            if (polled[i]->closing) {
+                prv_term_close(polled[i]);
+            }
+        }
+    }
+}
+
+/**
+ * \brief           Print callback of terminal
+ * \param[in]       mrl: \ref microrl_t working instance of terminal
+ * \param[in]       str: Output string
+ * \return          The number of characters written
+ */
+static int prv_term_print(microrl_t* mrl, const char* str) {
+    linux_term_t* t = (linux_term_t*)mrl;
+    size_t len = strlen(str);
+
+    if (send(t->fd, str, len, MSG_NOSIGNAL) < 0) {
+        return 0;
+    }
+
+    return (int)len;
+}
+
+/**
+ * \brief           Accept new connection and attach shell terminal to it
+ */
+static void prv_term_accept(void) {
+    int fd = accept(listen_fd, NULL, NULL);
+
+    if (fd < 0) {
+        return;
+    }
+
+    for (size_t i = 0; i < _TERM_NUM; ++i) {
+        linux_term_t* t = &terms[i];
+
+        if (t->fd < 0) {
+            t->fd = fd;
+            t->closing = 0;
+            microsh_term_init(term_msh, &t->term, prv_term_print);
+#if MICRORL_CFG_USE_COMPLETE && !MICROSH_CFG_COMPLETION
+            microrl_set_complete_callback(&t->term.mrl, complet);
+#endif /* MICRORL_CFG_USE_COMPLETE && !MICROSH_CFG_COMPLETION */
+#if MICRORL_CFG_USE_CTRL_C
+            microrl_set_sigint_callback(&t->term.mrl, prv_term_sigint);
+#endif /* MICRORL_CFG_USE_CTRL_C */
+            return;
+        }
+    }
+
+    /* All terminals are busy */
+    close(fd);
+}
+
+/**
+ * \brief           Detach shell terminal and close its connection
+ * \param[in,out]   t: Terminal to close
+ */
+static void prv_term_close(linux_term_t* t) {
+    microsh_term_deinit(&t->term);
+    close(t->fd);
+    t->fd = -1;
+}
+
+#if MICRORL_CFG_USE_CTRL_C
+/**
+ * \brief           Ctrl+C signal function of terminal. Unlike console one
+ *                      it never exits application, only closes its own connection
+ * \param[in]       mrl: \ref microrl_t working instance of terminal
+ */
+static void prv_term_sigint(microrl_t* mrl) {
+    linux_term_t* t = (linux_term_t*)mrl;
+
+#if MICROSH_CFG_WATCH
+    /* Ctrl+C stops watched command of terminal first */
+    if (microsh_watch_stop(mrl) == microshOK) {
+        mrl->out_fn(mrl, mrl->prompt_str);
+        return;
+    }
+#endif /* MICROSH_CFG_WATCH */
+    mrl->out_fn(mrl, "^C"MICRORL_CFG_END_LINE);
+
+    /* Terminal is still used by line processing, close it after input */
+    t->closing = 1;
+}
+#endif /* MICRORL_CFG_USE_CTRL_C */
+
+#endif /* MICROSH_CFG_TERMINALS */
@@ -0,0 +1,44 @@
+/**
+ * \file            linux_term.h
+ * \brief           Additional shell terminals over TCP connections
+ */
+
+/*
+ * Copyright (c) 2022 Dmitry KARASEV
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * This file is part of microSH - Shell for Embedded Systems library.
+ *
+ * Author:          Dmitry KARASEV <karasevsdmitry@yandex.ru>
+ * Version:         2.0.0-dev
+ */
+
+#ifndef MICROSH_LINUX_TERM_HDR_H
+#define MICROSH_LINUX_TERM_HDR_H
+
+#include "microsh.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+#if MICROSH_CFG_TERMINALS
+void       linux_term_wait_stdin(void);
+#endif /* MICROSH_CFG_TERMINALS */
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* MICROSH_LINUX_TERM_HDR_H */
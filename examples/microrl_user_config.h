@@ -35,8 +35,8 @@ extern "C" {
  * Open "microrl_config.h" and copy & replace
  * here settings you want to change values
  */
-#define MICRORL_CFG_CMDLINE_LEN               40
-#define MICRORL_CFG_CMD_TOKEN_NMB             5
+#define MICRORL_CFG_CMDLINE_LEN               64
+#define MICRORL_CFG_CMD_TOKEN_NMB             8
 #define MICRORL_CFG_PROMPT_STRING             "> "
 #define MICRORL_CFG_PROMPT_COLOR              "\033[32m"
 #define MICRORL_CFG_USE_COMPLETE              1
@@ -35,8 +35,16 @@ extern "C" {
  * Open "microsh_config.h" and copy & replace
  * here settings you want to change values
  */
-#define MICROSH_CFG_NUM_OF_CMDS               4
+#define MICROSH_CFG_NUM_OF_CMDS               20
 #define MICROSH_CFG_LOGGING_CMD_EXEC_RESULT   1
+#define MICROSH_CFG_CMD_SUGGEST               1
+#define MICROSH_CFG_CMD_SEQUENCE              1
+#define MICROSH_CFG_PIPES                     1
+#define MICROSH_CFG_VARS                      1
+#define MICROSH_CFG_COMPLETION                1
+#define MICROSH_CFG_SUBCMDS                   1
+#define MICROSH_CFG_CMD_ABBREV                1
+#define MICROSH_CFG_ARG_SCHEMA                1
 
 #define MICROSH_CFG_CONSOLE_SESSIONS          1
 #define MICROSH_CFG_MAX_CREDENTIALS           2
@@ -50,6 +50,19 @@
 #define _CMD_CLEAR                  "clear"
 #define _CMD_SERNUM                 "sernum"
 #define _CMD_LOGOUT                 "logout"
+#define _CMD_SET                    "set"
+#define _CMD_UNSET                  "unset"
+#define _CMD_ENV                    "env"
+#define _CMD_ALIAS                  "alias"
+#define _CMD_UNALIAS                "unalias"
+#define _CMD_WATCH                  "watch"
+#define _CMD_AT                     "at"
+#define _CMD_EVERY                  "every"
+#define _CMD_ATRM                   "atrm"
+#define _CMD_ON                     "on"
+#define _CMD_ONRM                   "onrm"
+#define _CMD_HISTORY                "history"
+#define _CMD_MANIFEST               "manifest"
 
 /* Arguments for set/clear */
 #define _SCMD_RD                    "?"
@@ -58,6 +71,8 @@
 #define _NUM_OF_CMD                 4
 #define _NUM_OF_SETCLEAR_SCMD       2
 
+#if MICRORL_CFG_USE_COMPLETE && !MICROSH_CFG_COMPLETION
+/* Completion by application, library completion is disabled */
 /* Available  commands */
 char* keyword[] = {_CMD_HELP, _CMD_CLEAR, _CMD_SERNUM, _CMD_LOGOUT};
 
@@ -66,17 +81,57 @@ char* read_save_key[] = {_SCMD_RD, _SCMD_SAVE};
 
 /* Array for comletion */
 char* compl_word[_NUM_OF_CMD + 1];
+#endif /* MICRORL_CFG_USE_COMPLETE && !MICROSH_CFG_COMPLETION */
 
 /* Variable changeable with commands */
 uint32_t device_sn = 0;
 
+#if MICROSH_CFG_ARG_SCHEMA
+#if MICROSH_CFG_SUBCMDS
+/* 'sernum' argument: non-zero serial number value, 'read/save' are subcommands */
+static const microsh_arg_t sernum_args[] = {
+    { .type = microshARG_U32, .min = 1, .max = UINT32_MAX }
+};
+#else
+/* 'sernum' argument: 'read/save' keyword or non-zero serial number value */
+static const char* const sernum_keys[] = {_SCMD_RD, _SCMD_SAVE, NULL};
+static const microsh_arg_t sernum_args[] = {
+    { .type = microshARG_U32, .min = 1, .max = UINT32_MAX, .keywords = sernum_keys }
+};
+#endif /* MICROSH_CFG_SUBCMDS */
+static const microsh_arg_schema_t sernum_schema = { .args = sernum_args, .num = 1, .min_num = 1 };
+#endif /* MICROSH_CFG_ARG_SCHEMA */
+
+/* Milliseconds counter incremented by SysTick */
+static volatile uint32_t tick_ms = 0;
+
+#if MICROSH_CFG_EVENTS
+#define _EVENT_SECOND               0x0001
+
+/* Application events, SysTick posts `second` event */
+static const microsh_event_name_t event_names[] = {
+    { .id = _EVENT_SECOND, .name = "second" },
+};
+static microsh_t* event_msh;
+#endif /* MICROSH_CFG_EVENTS */
+
 static int help_cmd(microsh_t* msh, int argc, const char* const *argv);
 static int clear_screen_cmd(microsh_t* msh, int argc, const char* const *argv);
 static int sernum_cmd(microsh_t* msh, int argc, const char* const *argv);
+static int sernum_read_cmd(microsh_t* msh, int argc, const char* const *argv);
+static int sernum_save_cmd(microsh_t* msh, int argc, const char* const *argv);
 #if MICROSH_CFG_CONSOLE_SESSIONS
 static int logout_cmd(microsh_t* msh, int argc, const char* const *argv);
 #endif /* MICROSH_CFG_CONSOLE_SESSIONS */
 
+#if MICROSH_CFG_SUBCMDS
+/* 'sernum' subcommands, serial number value is handled by 'sernum' itself */
+static const microsh_cmd_t sernum_subcmds[] = {
+    { .name = _SCMD_RD,   .arg_num = 1, .desc = "Read serial number value", .cmd_fn = sernum_read_cmd },
+    { .name = _SCMD_SAVE, .arg_num = 1, .desc = "Save serial number value", .cmd_fn = sernum_save_cmd }
+};
+#endif /* MICROSH_CFG_SUBCMDS */
+
 /**
  * \brief           Init STM32F4 platform
  */
@@ -109,7 +164,32 @@ void init(void) {
     LL_USART_ConfigAsyncMode(USART_PERIFH);
 
     LL_USART_Enable(USART_PERIFH);
+
+    SysTick_Config(SystemCoreClock / 1000);
+}
+
+/**
+ * \brief           SysTick interrupt handler
+ */
+void SysTick_Handler(void) {
+    ++tick_ms;
+#if MICROSH_CFG_EVENTS
+    if (event_msh != NULL && tick_ms % 1000 == 0) {
+        microsh_event_post(event_msh, _EVENT_SECOND);
+    }
+#endif /* MICROSH_CFG_EVENTS */
+}
+
+#if MICROSH_CFG_EVENTS
+/**
+ * \brief           Name application events and start posting them from SysTick
+ * \param[in]       msh: \ref microsh_t working instance
+ */
+void events_init(microsh_t* msh) {
+    microsh_event_set_names(msh, event_names, MICROSH_ARRAYSIZE(event_names));
+    event_msh = msh;
 }
+#endif /* MICROSH_CFG_EVENTS */
 #if MICROSH_CFG_CONSOLE_SESSIONS
 /**
  * \brief           Register commands that may be used in authorization process
@@ -136,9 +216,42 @@ microshr_t register_all_commands(microsh_t* msh) {
     result |= microsh_cmd_register(msh, 1, _CMD_HELP,   help_cmd,         NULL);
     result |= microsh_cmd_register(msh, 1, _CMD_CLEAR,  clear_screen_cmd, NULL);
     result |= microsh_cmd_register(msh, 2, _CMD_SERNUM, sernum_cmd,       NULL);
+#if MICROSH_CFG_ARG_SCHEMA
+    result |= microsh_cmd_set_schema(msh, _CMD_SERNUM, &sernum_schema);
+#endif /* MICROSH_CFG_ARG_SCHEMA */
+#if MICROSH_CFG_SUBCMDS
+    result |= microsh_cmd_set_subcmds(msh, _CMD_SERNUM, sernum_subcmds, MICROSH_ARRAYSIZE(sernum_subcmds));
+#endif /* MICROSH_CFG_SUBCMDS */
 #if MICROSH_CFG_CONSOLE_SESSIONS
     result |= microsh_cmd_register(msh, 1, _CMD_LOGOUT, logout_cmd,       NULL);
 #endif /* MICROSH_CFG_CONSOLE_SESSIONS */
+#if MICROSH_CFG_VARS
+    result |= microsh_cmd_register(msh, 3, _CMD_SET,    microsh_var_set_cmd,   "Set variable, 'set NAME VALUE'");
+    result |= microsh_cmd_register(msh, 2, _CMD_UNSET,  microsh_var_unset_cmd, "Delete variable, 'unset NAME'");
+    result |= microsh_cmd_register(msh, 1, _CMD_ENV,    microsh_var_env_cmd,   "Print all variables");
+#endif /* MICROSH_CFG_VARS */
+#if MICROSH_CFG_ALIASES
+    result |= microsh_cmd_register(msh, MICRORL_CFG_CMD_TOKEN_NMB, _CMD_ALIAS, microsh_alias_cmd, "Print aliases, 'alias NAME BODY' to define alias");
+    result |= microsh_cmd_register(msh, 2, _CMD_UNALIAS, microsh_alias_unset_cmd, "Delete alias, 'unalias NAME'");
+#endif /* MICROSH_CFG_ALIASES */
+#if MICROSH_CFG_WATCH
+    result |= microsh_cmd_register(msh, MICRORL_CFG_CMD_TOKEN_NMB, _CMD_WATCH, microsh_watch_cmd, "Run command periodically, 'watch N CMD' to run it every N seconds");
+#endif /* MICROSH_CFG_WATCH */
+#if MICROSH_CFG_SCHED
+    result |= microsh_cmd_register(msh, MICRORL_CFG_CMD_TOKEN_NMB, _CMD_AT, microsh_sched_at_cmd, "Print jobs, 'at TIME CMD' to run command once after TIME");
+    result |= microsh_cmd_register(msh, MICRORL_CFG_CMD_TOKEN_NMB, _CMD_EVERY, microsh_sched_every_cmd, "Run command periodically, 'every TIME CMD'");
+    result |= microsh_cmd_register(msh, 2, _CMD_ATRM, microsh_sched_atrm_cmd, "Cancel job, 'atrm ID'");
+#endif /* MICROSH_CFG_SCHED */
+#if MICROSH_CFG_EVENTS
+    result |= microsh_cmd_register(msh, MICRORL_CFG_CMD_TOKEN_NMB, _CMD_ON, microsh_event_on_cmd, "Print bindings, 'on EVENT CMD' to run command on event");
+    result |= microsh_cmd_register(msh, 2, _CMD_ONRM, microsh_event_onrm_cmd, "Remove binding, 'onrm NUM'");
+#endif /* MICROSH_CFG_EVENTS */
+#if MICROSH_CFG_HISTORY
+    result |= microsh_cmd_register(msh, 2, _CMD_HISTORY, microsh_hist_cmd, "Print the newest stored lines, 'history N' to print N lines");
+#endif /* MICROSH_CFG_HISTORY */
+#if MICROSH_CFG_MANIFEST
+    result |= microsh_cmd_register(msh, 1, _CMD_MANIFEST, microsh_manifest_cmd, "Print registered commands as JSON for host tools");
+#endif /* MICROSH_CFG_MANIFEST */
 
     return result;
 }
@@ -172,6 +285,20 @@ int microrl_print(microrl_t* mrl, const char* str) {
     return print(str);
 }
 
+#if MICROSH_CFG_MUX
+/**
+ * \brief           Write multiplexer frame to USART
+ * \param[in]       data: Encoded frame
+ * \param[in]       len: Frame length
+ */
+void transport_write(const uint8_t* data, size_t len) {
+    for (size_t i = 0; i < len; ++i) {
+        while (!LL_USART_IsActiveFlag_TXE(USART_PERIFH)) {}
+        LL_USART_TransmitData8(USART_PERIFH, data[i]);
+    }
+}
+#endif /* MICROSH_CFG_MUX */
+
 /**
  * \brief           Get char user pressed
  * \return          Input character
@@ -181,6 +308,15 @@ char get_char(void) {
     return (char)LL_USART_ReceiveData8(USART_PERIFH);
 }
 
+/**
+ * \brief           Get SysTick time
+ * \return          Time in milliseconds
+ */
+uint32_t get_tick_ms(void) {
+    return tick_ms;
+}
+
+#if !MICROSH_CFG_ARG_SCHEMA
 /**
  * \brief           Makes `unsigned 32-bit` value from ascii char array
  * \param[in]       str: Input string with value to convert
@@ -197,6 +333,7 @@ static void str_to_u32(char* str, uint32_t* val) {
 
     *val = temp;
 }
+#endif /* !MICROSH_CFG_ARG_SCHEMA */
 
 /**
  * \brief           Makes ascii char array from `unsigned 32-bit` value
@@ -225,19 +362,7 @@ static void u32_to_str(uint32_t* val, char* str) {
     }
 }
 
-/**
- * \brief           SERNUM ? command callback
- */
-static void read_sernum(void) {
-    char sn_str[11] = {0};
-    uint32_t sn = device_sn;
-    u32_to_str(&sn, sn_str);
-
-    print("\tS/N ");
-    print(sn_str);
-    print(_ENDLINE_SEQ);
-}
-
+#if !MICROSH_CFG_ARG_SCHEMA
 /**
  * \brief           SERNUM VALUE command callback
  * \param[in]       str_val: New serial number value
@@ -257,14 +382,7 @@ static void set_sernum(char* str_val) {
 
     print("\tS/N not set"_ENDLINE_SEQ);
 }
-
-/**
- * \brief           SERNUM SAVE command callback
- */
-static void save_sernum(void) {
-    /* To simplify the code, no implementation of writing SN to FLASH OTP memory is provided here */
-    print("\tS/N save done"_ENDLINE_SEQ);
-}
+#endif /* !MICROSH_CFG_ARG_SCHEMA */
 
 /**
  * \brief           HELP command execution
@@ -285,7 +403,7 @@ int help_cmd(microsh_t* msh, int argc, const char* const *argv) {
 
     print("Use TAB key for completion"_ENDLINE_SEQ);
 #if MICROSH_CFG_CONSOLE_SESSIONS
-    if (!msh->session.status.flags.logged_in) {
+    if (!microsh_session_is_logged_in(msh)) {
         print(_ENDLINE_SEQ"You must log in to one of the sessions."_ENDLINE_SEQ);
         print("After authorization, session commands will be available."_ENDLINE_SEQ);
         print("Different commands may be available for different sessions."_ENDLINE_SEQ);
@@ -297,6 +415,33 @@ int help_cmd(microsh_t* msh, int argc, const char* const *argv) {
         print("\tsernum VALUE        - set serial number value"_ENDLINE_SEQ);
         print("\tsernum save         - save serial number value to flash"_ENDLINE_SEQ);
         print("\tlogout              - end an authorized session"_ENDLINE_SEQ);
+#if MICROSH_CFG_VARS
+        print("\tset NAME VALUE      - set variable, use it as $NAME"_ENDLINE_SEQ);
+        print("\tunset NAME          - delete variable"_ENDLINE_SEQ);
+        print("\tenv                 - print all variables"_ENDLINE_SEQ);
+#endif /* MICROSH_CFG_VARS */
+#if MICROSH_CFG_ALIASES
+        print("\talias [NAME [BODY]] - print aliases or define alias, '$1'..'$9' are its arguments"_ENDLINE_SEQ);
+        print("\tunalias NAME        - delete alias"_ENDLINE_SEQ);
+#endif /* MICROSH_CFG_ALIASES */
+#if MICROSH_CFG_WATCH
+        print("\twatch N CMD         - run command every N seconds, Ctrl+C to stop"_ENDLINE_SEQ);
+#endif /* MICROSH_CFG_WATCH */
+#if MICROSH_CFG_SCHED
+        print("\tat [TIME CMD]       - print jobs or run command once after TIME, e.g. '5m' or '30'"_ENDLINE_SEQ);
+        print("\tevery TIME CMD      - run command every TIME"_ENDLINE_SEQ);
+        print("\tatrm ID             - cancel job"_ENDLINE_SEQ);
+#endif /* MICROSH_CFG_SCHED */
+#if MICROSH_CFG_EVENTS
+        print("\ton [EVENT CMD]      - print bindings or run command on each EVENT"_ENDLINE_SEQ);
+        print("\tonrm NUM            - remove binding"_ENDLINE_SEQ);
+#endif /* MICROSH_CFG_EVENTS */
+#if MICROSH_CFG_HISTORY
+        print("\thistory [N]         - print the newest stored lines, Ctrl+R to search them"_ENDLINE_SEQ);
+#endif /* MICROSH_CFG_HISTORY */
+#if MICROSH_CFG_MANIFEST
+        print("\tmanifest            - print registered commands as JSON for host tools"_ENDLINE_SEQ);
+#endif /* MICROSH_CFG_MANIFEST */
 #if MICROSH_CFG_CONSOLE_SESSIONS
     }
 #endif /* MICROSH_CFG_CONSOLE_SESSIONS */
@@ -336,20 +481,72 @@ int sernum_cmd(microsh_t* msh, int argc, const char* const *argv) {
     MICRORL_UNUSED(argc);
     MICRORL_UNUSED(argv);
 
-    int i = 0;
+#if !MICROSH_CFG_SUBCMDS
+    /* Without subcommand tables 'read/save' come here as argument */
+    if (argc > 1 && strcmp(argv[1], _SCMD_RD) == 0) {
+        return sernum_read_cmd(msh, argc - 1, &argv[1]);
+    } else if (argc > 1 && strcmp(argv[1], _SCMD_SAVE) == 0) {
+        return sernum_save_cmd(msh, argc - 1, &argv[1]);
+    }
+#endif /* !MICROSH_CFG_SUBCMDS */
 
-    if (++i < argc) {
-        if (strcmp(argv[i], _SCMD_RD) == 0) {
-            read_sernum();
-        } else if (strcmp(argv[i], _SCMD_SAVE) == 0) {
-            save_sernum();
-        } else {
-            set_sernum((char*)argv[i]);
-        }
-    } else {
+#if MICROSH_CFG_ARG_SCHEMA
+    /* Argument is validated by schema */
+    device_sn = microsh_arg_values(msh)[1].u32;
+
+    print("\tset S/N ");
+    print(argv[1]);
+    print(_ENDLINE_SEQ);
+#else
+    if (argc < 2) {
         print("Read or specify serial number"_ENDLINE_SEQ);
         return microshEXEC_ERROR;
     }
+    set_sernum((char*)argv[1]);
+#endif /* MICROSH_CFG_ARG_SCHEMA */
+
+    return microshEXEC_OK;
+}
+
+/**
+ * \brief           SERNUM ? command execution
+ * \param[in]       msh: \ref microsh_t working instance
+ * \param[in]       argc: argument count
+ * \param[in]       argv: pointer array to token string
+ * \return          \ref microshEXEC_OK on success, member of
+ *                      \ref microsh_execr_t enumeration otherwise
+ */
+int sernum_read_cmd(microsh_t* msh, int argc, const char* const *argv) {
+    MICRORL_UNUSED(msh);
+    MICRORL_UNUSED(argc);
+    MICRORL_UNUSED(argv);
+
+    char sn_str[11] = {0};
+    uint32_t sn = device_sn;
+    u32_to_str(&sn, sn_str);
+
+    print("\tS/N ");
+    print(sn_str);
+    print(_ENDLINE_SEQ);
+
+    return microshEXEC_OK;
+}
+
+/**
+ * \brief           SERNUM SAVE command execution
+ * \param[in]       msh: \ref microsh_t working instance
+ * \param[in]       argc: argument count
+ * \param[in]       argv: pointer array to token string
+ * \return          \ref microshEXEC_OK on success, member of
+ *                      \ref microsh_execr_t enumeration otherwise
+ */
+int sernum_save_cmd(microsh_t* msh, int argc, const char* const *argv) {
+    MICRORL_UNUSED(msh);
+    MICRORL_UNUSED(argc);
+    MICRORL_UNUSED(argv);
+
+    /* To simplify the code, no implementation of writing SN to FLASH OTP memory is provided here */
+    print("\tS/N save done"_ENDLINE_SEQ);
 
     return microshEXEC_OK;
 }
@@ -375,7 +572,7 @@ int logout_cmd(microsh_t* msh, int argc, const char* const *argv) {
 }
 #endif /* MICROSH_CFG_CONSOLE_SESSIONS */
 
-#if MICRORL_CFG_USE_COMPLETE || __DOXYGEN__
+#if (MICRORL_CFG_USE_COMPLETE && !MICROSH_CFG_COMPLETION) || __DOXYGEN__
 /**
  * \brief           Completion callback for MicroRL library
  * \param[in,out]   mrl: \ref microrl_t working instance
@@ -420,7 +617,7 @@ char** complet(microrl_t* mrl, int argc, const char* const *argv) {
     /* Return set of variants */
     return compl_word;
 }
-#endif /* MICRORL_CFG_USE_COMPLETE || __DOXYGEN__ */
+#endif /* (MICRORL_CFG_USE_COMPLETE && !MICROSH_CFG_COMPLETION) || __DOXYGEN__ */
 
 #if MICRORL_CFG_USE_CTRL_C || __DOXYGEN__
 /**
@@ -428,6 +625,13 @@ char** complet(microrl_t* mrl, int argc, const char* const *argv) {
  * \param[in]       mrl: \ref microrl_t working instance
  */
 void sigint(microrl_t* mrl) {
+#if MICROSH_CFG_WATCH
+    /* Ctrl+C stops watched command of terminal first */
+    if (microsh_watch_stop(mrl) == microshOK) {
+        microrl_print(mrl, mrl->prompt_str);
+        return;
+    }
+#endif /* MICROSH_CFG_WATCH */
     microrl_print(mrl, "^C is caught!"_ENDLINE_SEQ);
 }
 #endif /* MICRORL_CFG_USE_CTRL_C || __DOXYGEN__ */
@@ -55,6 +55,11 @@ extern "C" {
  */
 #define MICROSH_ARRAYSIZE(x)        (sizeof(x) / sizeof((x)[0]))
 
+/**
+ * \brief           Value returned by \ref microsh_tick when shell has no pending deadline
+ */
+#define MICROSH_NO_DEADLINE         UINT32_MAX
+
 /**
  * \brief           MicroSH result enumeration
  */
@@ -72,11 +77,58 @@ typedef enum {
     microshEXEC_ERROR          = 0x10,          /*!< Command execute generic error */
     microshEXEC_ERROR_UNK_CMD  = 0x11,          /*!< Unknown command */
     microshEXEC_ERROR_MAX_ARGS = 0x12,          /*!< To many arguments in command */
+    microshEXEC_ERROR_FEW_ARGS = 0x13,          /*!< Too few arguments in command */
+    microshEXEC_ERROR_BAD_ARG  = 0x14,          /*!< Argument does not match command arguments schema */
+    microshEXEC_ERROR_UNK_SUBCMD = 0x15,        /*!< Unknown subcommand of command without own function */
+    microshEXEC_ERROR_AMBIG_CMD  = 0x16,        /*!< Abbreviation matches several commands */
+    microshEXEC_ERROR_BAD_PIPE   = 0x17,        /*!< Unknown pipe filter or wrong filter arguments */
+    microshEXEC_ERROR_EXPAND     = 0x18,        /*!< Line does not fit buffer after variables or aliases expansion */
 } microsh_execr_t;
 
+/**
+ * \brief           Identifiers of messages printed by shell itself
+ * \note            Values are printed instead of message strings
+ *                      when \ref MICROSH_CFG_LOG_MSG_IDS is enabled
+ */
+typedef enum {
+    microshMSG_LOGIN_NO_USERNAME     = 0x01,    /*!< "Enter your username after 'login' command" */
+    microshMSG_LOGIN_ENTER_PASSW     = 0x02,    /*!< "Enter the password:" */
+    microshMSG_LOGIN_WRONG_USERNAME  = 0x03,    /*!< "Wrong username! Try again" */
+    microshMSG_LOGIN_OK              = 0x04,    /*!< "Logged In!" */
+    microshMSG_LOGIN_WRONG_PASSW     = 0x05,    /*!< "Wrong password! Try again" */
+    microshMSG_LOGIN_ATTEMPTS_OUT    = 0x06,    /*!< "Wrong password! Try to Log in again" */
+    microshMSG_LOGIN_REQUIRED        = 0x07,    /*!< "You need to Log In! Type 'login YOUR_USERNAME'" */
+    microshMSG_UNK_CMD               = 0x08,    /*!< "Unknown command" */
+    microshMSG_MAX_ARGS              = 0x09,    /*!< "Too many arguments" */
+    microshMSG_PROF_NO_BACKEND       = 0x0A,    /*!< "Profiling backend is not set" */
+    microshMSG_LOGIN_LOCKED          = 0x0B,    /*!< "Too many wrong passwords! Log in is locked" */
+    microshMSG_SESSION_TIMEOUT       = 0x0C,    /*!< "Session timed out! Logged out" */
+    microshMSG_FEW_ARGS              = 0x0D,    /*!< "Too few arguments" */
+    microshMSG_BAD_ARG               = 0x0E,    /*!< "Invalid argument" */
+    microshMSG_UNK_SUBCMD            = 0x0F,    /*!< "Unknown subcommand" */
+    microshMSG_AMBIG_CMD             = 0x10,    /*!< "Ambiguous command" */
+    microshMSG_BAD_PIPE              = 0x11,    /*!< "Invalid pipe filter" */
+    microshMSG_EXPAND                = 0x12,    /*!< "Too long line after expansion" */
+} microsh_msg_t;
+
 /* Forward declarations */
 struct microsh;
 
+/* Optional modules */
+#include "microsh_args.h"
+#include "microsh_audit.h"
+#include "microsh_log.h"
+#include "microsh_pipe.h"
+#include "microsh_trie.h"
+#include "microsh_vars.h"
+#include "microsh_alias.h"
+#include "microsh_script.h"
+#include "microsh_watch.h"
+#include "microsh_sched.h"
+#include "microsh_event.h"
+#include "microsh_hist.h"
+#include "microsh_manifest.h"
+
 /**
  * \brief           Command execute function prototype
  * \param[in]       msh: microSH instance
@@ -96,23 +148,100 @@ typedef void     (*microsh_logged_in_fn)(struct microsh* msh);
 /**
  * \brief           Shell command structure
  */
-typedef struct {
+typedef struct microsh_cmd {
     const char* name;                           /*!< Command name to search for match */
     size_t arg_num;                             /*!< Maximum number of arguments */
     const char* desc;                           /*!< Command description for help */
-    microsh_cmd_fn cmd_fn;                      /*!< Command execute function to call */
+    microsh_cmd_fn cmd_fn;                      /*!< Command execute function to call. May be `NULL` in subcommand tables */
+#if MICROSH_CFG_ARG_SCHEMA
+    const microsh_arg_schema_t* schema;         /*!< Arguments schema, `NULL` if arguments are not validated */
+#endif /* MICROSH_CFG_ARG_SCHEMA */
+#if MICROSH_CFG_SUBCMDS
+    const struct microsh_cmd* subcmds;          /*!< Child table of subcommands, `NULL` if none */
+    size_t subcmds_num;                         /*!< Number of subcommands in child table */
+#endif /* MICROSH_CFG_SUBCMDS */
 } microsh_cmd_t;
 
+#if MICROSH_CFG_CMD_PROFILING
+/**
+ * \brief           Profiling counters start function prototype
+ * \note            Called right before command function
+ * \param[in]       msh: microSH instance
+ * \return          \ref microshOK on success, member of \ref microshr_t otherwise
+ */
+typedef microshr_t (*microsh_prof_start_fn)(struct microsh* msh);
+
+/**
+ * \brief           Profiling counters stop function prototype
+ * \note            Called right after command function
+ * \param[in]       msh: microSH instance
+ * \param[out]      counters: Array of \ref MICROSH_CFG_PROF_NUM_COUNTERS counted values
+ * \return          \ref microshOK on success, member of \ref microshr_t otherwise
+ */
+typedef microshr_t (*microsh_prof_stop_fn)(struct microsh* msh, uint64_t* counters);
+
+/**
+ * \brief           Command profiling counters backend
+ */
+typedef struct {
+    microsh_prof_start_fn start_fn;             /*!< Start counting function */
+    microsh_prof_stop_fn stop_fn;               /*!< Stop counting and read counters function */
+    const char* names[MICROSH_CFG_PROF_NUM_COUNTERS]; /*!< Counters names for report. `NULL` for unused counter */
+} microsh_prof_backend_t;
+
+/**
+ * \brief           Accumulated profiling statistics of single command
+ */
+typedef struct {
+    uint32_t calls;                             /*!< Number of profiled command calls */
+    uint64_t total[MICROSH_CFG_PROF_NUM_COUNTERS]; /*!< Sum of counted values of all calls */
+    uint64_t max[MICROSH_CFG_PROF_NUM_COUNTERS]; /*!< Maximum counted values of single call */
+} microsh_prof_stat_t;
+#endif /* MICROSH_CFG_CMD_PROFILING */
+
 #if MICROSH_CFG_CONSOLE_SESSIONS
+#if MICROSH_CFG_PASSW_HASH || __DOXYGEN__
+/**
+ * \brief           Length of password hash in bytes
+ */
+#define MICROSH_PASSW_HASH_LEN      32
+#endif /* MICROSH_CFG_PASSW_HASH || __DOXYGEN__ */
+
+#if MICROSH_CFG_CRED_HASH_INDEX || __DOXYGEN__
+#if MICROSH_CFG_MAX_CREDENTIALS > 255
+#error "MICROSH_CFG_MAX_CREDENTIALS must not exceed 255 with MICROSH_CFG_CRED_HASH_INDEX"
+#endif /* MICROSH_CFG_MAX_CREDENTIALS > 255 */
+
+/**
+ * \brief           Number of username hash index slots
+ */
+#define MICROSH_CRED_INDEX_LEN      (2 * MICROSH_CFG_MAX_CREDENTIALS)
+#endif /* MICROSH_CFG_CRED_HASH_INDEX || __DOXYGEN__ */
+
 /**
  * \brief           Console session credentials
  */
 typedef struct {
     uint32_t login_type;                         /*!< Type of user-defined console session. `0` is used as LOGGED_OUT type in library! */
-    char* username;                              /*!< Username of login type */
+    const char* username;                        /*!< Username of login type */
+#if MICROSH_CFG_PASSW_HASH
+    uint8_t salt[MICROSH_CFG_PASSW_SALT_LEN];    /*!< Random salt of password hash */
+    uint8_t hash[MICROSH_PASSW_HASH_LEN];        /*!< PBKDF2-HMAC-SHA256 hash of password */
+#else
     char* password;                              /*!< Password of login type */
+#endif /* MICROSH_CFG_PASSW_HASH */
 } microsh_credentials_t;
 
+#if MICROSH_CFG_SESSION_IDLE_TIMEOUT || __DOXYGEN__
+/**
+ * \brief           Idle timeout of login type
+ */
+typedef struct {
+    uint32_t login_type;                         /*!< Type of user-defined console session */
+    uint32_t timeout_ms;                         /*!< Idle time in milliseconds to log out after, `0` to never log out */
+} microsh_idle_timeout_t;
+#endif /* MICROSH_CFG_SESSION_IDLE_TIMEOUT || __DOXYGEN__ */
+
 /**
  * \brief           Сurrent console session status
  */
@@ -122,47 +251,162 @@ typedef struct {
     struct flags {
         uint8_t logged_in    : 1;                /*!< User logged into session */
         uint8_t passw_wait   : 1;                /*!< User exists and is allowed to enter password */
-        uint8_t reserved     : 6;
+        uint8_t locked       : 1;                /*!< Log in is locked after wrong passwords */
+        uint8_t reserved     : 5;
     } flags;
+    const microsh_credentials_t* cred;           /*!< Credentials of user entering password or logged in */
+#if MICROSH_CFG_SESSION_IDLE_TIMEOUT
+    uint32_t idle_timeout_ms;                    /*!< Idle timeout of logged in session, `0` if disabled */
+    uint32_t last_activity;                      /*!< Time of the last entered line in milliseconds */
+#endif /* MICROSH_CFG_SESSION_IDLE_TIMEOUT */
+#if MICROSH_CFG_LOGIN_LOCKOUT
+    uint32_t lockouts;                           /*!< Number of lockouts since last successful log in */
+    uint32_t lock_start;                         /*!< Lockout start time in milliseconds */
+    uint32_t lock_ms;                            /*!< Lockout duration in milliseconds */
+#endif /* MICROSH_CFG_LOGIN_LOCKOUT */
 } microsh_session_status_t;
 
 /**
  * \brief           Console session context
  */
 typedef struct {
-    microsh_credentials_t credentials[MICROSH_CFG_MAX_CREDENTIALS];/*!< All available sessions credentials */
+    const microsh_credentials_t* credentials;    /*!< All available sessions credentials, not copied */
+    size_t cred_num;                             /*!< Number of sessions credentials */
+#if MICROSH_CFG_CRED_HASH_INDEX
+    uint8_t cred_index[MICROSH_CRED_INDEX_LEN];  /*!< Username hash index. Credentials index + 1, `0` for empty slot */
+#endif /* MICROSH_CFG_CRED_HASH_INDEX */
     microsh_session_status_t status;             /*!< Сurrent console session status */
     microsh_logged_in_fn logged_in_fn;           /*!< Successful log in callback */
+#if MICROSH_CFG_SESSION_IDLE_TIMEOUT
+    const microsh_idle_timeout_t* idle_timeouts; /*!< Idle timeouts of login types, not copied */
+    size_t idle_timeouts_num;                    /*!< Number of idle timeouts */
+#endif /* MICROSH_CFG_SESSION_IDLE_TIMEOUT */
 } microsh_session_t;
 #endif /* MICROSH_CFG_CONSOLE_SESSIONS */
 
+#if MICROSH_CFG_TERMINALS || __DOXYGEN__
+/**
+ * \brief           Additional terminal sharing commands and credentials of shell instance
+ */
+typedef struct microsh_term {
+    microrl_t         mrl;                       /*!< MicroRL context instance of terminal. Must be the first member */
+    struct microsh*   msh;                       /*!< Shell instance. Must be the second member, same as in \ref microsh_t */
+#if MICROSH_CFG_CONSOLE_SESSIONS
+    microsh_session_status_t status;             /*!< Console session status of terminal */
+#endif /* MICROSH_CFG_CONSOLE_SESSIONS */
+    struct microsh_term* next;                   /*!< Next terminal of shell instance */
+} microsh_term_t;
+#endif /* MICROSH_CFG_TERMINALS || __DOXYGEN__ */
+
 /**
  * \brief           MicroSH instance
  */
 typedef struct microsh {
     microrl_t         mrl;                       /*!< MicroRL context instance */
+#if MICROSH_CFG_TERMINALS
+    struct microsh*   msh;                       /*!< Points to instance itself, same layout as in \ref microsh_term_t */
+    microsh_term_t*   terms;                     /*!< List of additional terminals */
+    microrl_t*        cur_mrl;                   /*!< Additional terminal being served, `NULL` for own terminal */
+#endif /* MICROSH_CFG_TERMINALS */
+    uint32_t          now_ms;                    /*!< Time of the last \ref microsh_tick call */
     microsh_cmd_t     cmds[MICROSH_CFG_NUM_OF_CMDS]; /*!< Array of all registered commands */
     size_t            cmds_index;                /*!< Registered command index counter */
+#if MICROSH_CFG_CMD_ABBREV
+    microsh_trie_t    cmds_trie;                 /*!< Prefix trie of registered command names */
+#elif MICROSH_CFG_COMPLETION
+    uint16_t          cmds_sorted[MICROSH_CFG_NUM_OF_CMDS]; /*!< Indexes of registered commands in name order */
+#endif /* MICROSH_CFG_CMD_ABBREV */
+#if MICROSH_CFG_COMPLETION
+    char*             compl_words[MICROSH_CFG_COMPLETION_MAX_WORDS + 1]; /*!< `NULL`-terminated completion variants */
+#endif /* MICROSH_CFG_COMPLETION */
+#if MICROSH_CFG_ARG_SCHEMA
+    microsh_arg_val_t arg_vals[MICRORL_CFG_CMD_TOKEN_NMB]; /*!< Converted arguments of command being executed */
+#endif /* MICROSH_CFG_ARG_SCHEMA */
+#if MICROSH_CFG_CMD_PROFILING
+    const microsh_prof_backend_t* prof_backend;  /*!< Profiling counters backend. `NULL` if disabled */
+    microsh_prof_stat_t prof_stats[MICROSH_CFG_NUM_OF_CMDS]; /*!< Profiling statistics of registered commands */
+#endif /* MICROSH_CFG_CMD_PROFILING */
 #if MICROSH_CFG_CONSOLE_SESSIONS
     microsh_session_t session;                   /*!< Console session context instance */
 #endif /* MICROSH_CFG_CONSOLE_SESSIONS */
+#if MICROSH_CFG_AUDIT_LOG
+    microsh_audit_t   audit;                     /*!< Audit log context */
+#endif /* MICROSH_CFG_AUDIT_LOG */
+#if MICROSH_CFG_ASYNC_LOG
+    microsh_log_t     log;                       /*!< Asynchronous log queue */
+#endif /* MICROSH_CFG_ASYNC_LOG */
+#if MICROSH_CFG_CMD_SEQUENCE
+    uint8_t           seq_printed;               /*!< Results of commands of the last line are printed by sequence */
+#endif /* MICROSH_CFG_CMD_SEQUENCE */
+#if MICROSH_CFG_PIPES
+    microsh_pipe_t    pipe;                      /*!< Filters of command being executed */
+#endif /* MICROSH_CFG_PIPES */
+#if MICROSH_CFG_VARS
+    microsh_vars_t    vars;                      /*!< Shell variables */
+#endif /* MICROSH_CFG_VARS */
+#if MICROSH_CFG_ALIASES
+    microsh_aliases_t aliases;                   /*!< Command aliases */
+#endif /* MICROSH_CFG_ALIASES */
+#if MICROSH_CFG_WATCH
+    microsh_watch_t   watch;                     /*!< Periodically run command */
+#endif /* MICROSH_CFG_WATCH */
+#if MICROSH_CFG_SCHED
+    microsh_sched_t   sched;                     /*!< Scheduled jobs */
+#endif /* MICROSH_CFG_SCHED */
+#if MICROSH_CFG_EVENTS
+    microsh_events_t  events;                    /*!< Posted events and bound commands */
+#endif /* MICROSH_CFG_EVENTS */
+#if MICROSH_CFG_HISTORY
+    microsh_hist_t    hist;                      /*!< Persistent command history */
+#endif /* MICROSH_CFG_HISTORY */
 } microsh_t;
 
 microshr_t     microsh_init(microsh_t* msh, microrl_output_fn out_fn);
+uint32_t       microsh_tick(microsh_t* msh, uint32_t now_ms);
+microrl_t*     microsh_get_mrl(microsh_t* msh);
 
 microshr_t     microsh_cmd_register(microsh_t* msh, size_t arg_num, const char* cmd_name,
                                         microsh_cmd_fn cmd_fn, const char* desc);
 microshr_t     microsh_cmd_unregister_all(microsh_t* msh);
 microsh_cmd_t* microsh_cmd_find(microsh_t* msh, const char* cmd_name);
 
+#if MICROSH_CFG_SUBCMDS
+microshr_t     microsh_cmd_set_subcmds(microsh_t* msh, const char* cmd_name, const microsh_cmd_t* subcmds, size_t num);
+const microsh_cmd_t* microsh_cmd_resolve(microsh_t* msh, int argc, const char* const *argv, int* depth);
+#endif /* MICROSH_CFG_SUBCMDS */
+
+#if MICROSH_CFG_ARG_SCHEMA
+microshr_t     microsh_cmd_set_schema(microsh_t* msh, const char* cmd_name, const microsh_arg_schema_t* schema);
+const microsh_arg_val_t* microsh_arg_values(microsh_t* msh);
+#endif /* MICROSH_CFG_ARG_SCHEMA */
+
 #if MICROSH_CFG_CONSOLE_SESSIONS
 microshr_t     microsh_session_init(microsh_t* msh, const microsh_credentials_t* cred, size_t cred_num,
                                         microsh_logged_in_fn logged_in_cb);
 uint8_t        microsh_session_is_logged_in(microsh_t* msh);
 uint32_t       microsh_session_get_login_type(microsh_t* msh);
 microshr_t     microsh_session_logout(microsh_t* msh);
+#if MICROSH_CFG_SESSION_IDLE_TIMEOUT
+microshr_t     microsh_session_set_idle_timeouts(microsh_t* msh, const microsh_idle_timeout_t* timeouts, size_t num);
+#endif /* MICROSH_CFG_SESSION_IDLE_TIMEOUT */
 #endif /* MICROSH_CFG_CONSOLE_SESSIONS */
 
+#if MICROSH_CFG_PIPES
+uint8_t        microsh_pipe_stopped(microsh_t* msh);
+#endif /* MICROSH_CFG_PIPES */
+
+#if MICROSH_CFG_TERMINALS
+microshr_t     microsh_term_init(microsh_t* msh, microsh_term_t* term, microrl_output_fn out_fn);
+microshr_t     microsh_term_deinit(microsh_term_t* term);
+#endif /* MICROSH_CFG_TERMINALS */
+
+#if MICROSH_CFG_CMD_PROFILING
+microshr_t     microsh_prof_set_backend(microsh_t* msh, const microsh_prof_backend_t* backend);
+microshr_t     microsh_prof_reset(microsh_t* msh);
+const microsh_prof_stat_t* microsh_prof_get_stat(microsh_t* msh, const microsh_cmd_t* cmd);
+int            microsh_prof_cmd(microsh_t* msh, int argc, const char* const *argv);
+#endif /* MICROSH_CFG_CMD_PROFILING */
+
 /**
  * \}
  */
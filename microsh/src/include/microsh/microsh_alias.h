@@ -0,0 +1,111 @@
+/**
+ * \file            microsh_alias.h
+ * \brief           microSH command aliases
+ */
+
+/*
+ * Copyright (c) 2022 Dmitry KARASEV
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * This file is part of microSH - Shell for Embedded Systems library.
+ *
+ * Author:          Dmitry KARASEV <karasevsdmitry@yandex.ru>
+ * Version:         2.0.0-dev
+ */
+
+#ifndef MICROSH_HDR_ALIAS_H
+#define MICROSH_HDR_ALIAS_H
+
+/* This file is included by "microsh.h" and must not be included directly */
+#ifndef MICROSH_HDR_H
+#error "Include \"microsh.h\" instead of \"microsh_alias.h\""
+#endif /* MICROSH_HDR_H */
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+/**
+ * \addtogroup      MICROSH
+ * \{
+ */
+
+#if MICROSH_CFG_ALIASES || __DOXYGEN__
+
+/**
+ * \brief           Aliases storage load function prototype
+ * \param[in]       ctx: User storage context
+ * \param[out]      data: Buffer to read aliases image to
+ * \param[in]       len: Buffer length
+ * \param[out]      read_len: Length of stored image, `0` if nothing is stored
+ * \return          \ref microshOK on success, member of \ref microshr_t otherwise
+ */
+typedef microshr_t (*microsh_alias_load_fn)(void* ctx, void* data, size_t len, size_t* read_len);
+
+/**
+ * \brief           Aliases storage save function prototype
+ * \note            Stored image is replaced with new one
+ * \param[in]       ctx: User storage context
+ * \param[in]       data: Aliases image
+ * \param[in]       len: Image length, may be `0`
+ * \return          \ref microshOK on success, member of \ref microshr_t otherwise
+ */
+typedef microshr_t (*microsh_alias_save_fn)(void* ctx, const void* data, size_t len);
+
+/**
+ * \brief           Aliases persistent storage interface
+ */
+typedef struct {
+    microsh_alias_load_fn load_fn;              /*!< Load function */
+    microsh_alias_save_fn save_fn;              /*!< Save function */
+    void* ctx;                                  /*!< User context passed to storage functions */
+} microsh_alias_storage_t;
+
+/**
+ * \brief           Command aliases context
+ *
+ * Arena keeps `NAME\0BODY\0` entries in definition order and is the image
+ * saved to persistent storage. Hash table indexes entries by name
+ */
+typedef struct {
+    const microsh_alias_storage_t* storage;     /*!< Persistent storage. `NULL` if aliases are not saved */
+    char arena[MICROSH_CFG_ALIAS_ARENA_LEN];    /*!< Names and bodies of aliases */
+    uint16_t arena_len;                         /*!< Used length of arena */
+    uint16_t slots[MICROSH_CFG_ALIASES_NUM];    /*!< Open addressing hash table with linear probing
+                                                        of arena offsets + 1, `0` if slot is free */
+    size_t num;                                 /*!< Number of aliases */
+    char line[MICROSH_CFG_ALIAS_LINE_LEN];      /*!< Expanded tokens of command line being executed */
+    const char* argv[MICRORL_CFG_CMD_TOKEN_NMB]; /*!< Command line being executed after expansion */
+} microsh_aliases_t;
+
+microshr_t     microsh_alias_set_storage(struct microsh* msh, const microsh_alias_storage_t* storage);
+microshr_t     microsh_alias_set(struct microsh* msh, const char* name, const char* body);
+const char*    microsh_alias_get(struct microsh* msh, const char* name);
+microshr_t     microsh_alias_unset(struct microsh* msh, const char* name);
+int            microsh_alias_expand(struct microsh* msh, int* argc, const char* const **argv);
+
+int            microsh_alias_cmd(struct microsh* msh, int argc, const char* const *argv);
+int            microsh_alias_unset_cmd(struct microsh* msh, int argc, const char* const *argv);
+
+#endif /* MICROSH_CFG_ALIASES || __DOXYGEN__ */
+
+/**
+ * \}
+ */
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* MICROSH_HDR_ALIAS_H */
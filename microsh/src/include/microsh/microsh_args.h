@@ -0,0 +1,100 @@
+/**
+ * \file            microsh_args.h
+ * \brief           microSH typed arguments schema
+ */
+
+/*
+ * Copyright (c) 2022 Dmitry KARASEV
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * This file is part of microSH - Shell for Embedded Systems library.
+ *
+ * Author:          Dmitry KARASEV <karasevsdmitry@yandex.ru>
+ * Version:         2.0.0-dev
+ */
+
+#ifndef MICROSH_HDR_ARGS_H
+#define MICROSH_HDR_ARGS_H
+
+/* This file is included by "microsh.h" and must not be included directly */
+#ifndef MICROSH_HDR_H
+#error "Include \"microsh.h\" instead of \"microsh_args.h\""
+#endif /* MICROSH_HDR_H */
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+/**
+ * \addtogroup      MICROSH
+ * \{
+ */
+
+#if MICROSH_CFG_ARG_SCHEMA || __DOXYGEN__
+
+/**
+ * \brief           Argument type
+ */
+typedef enum {
+    microshARG_STR  = 0x00,                     /*!< Any string, `min` and `max` limit its length */
+    microshARG_U32  = 0x01,                     /*!< Unsigned decimal 32-bit value */
+    microshARG_I32  = 0x02,                     /*!< Signed decimal 32-bit value */
+    microshARG_HEX  = 0x03,                     /*!< Unsigned hexadecimal 32-bit value, `0x` prefix is optional */
+    microshARG_ENUM = 0x04,                     /*!< One of keywords only */
+} microsh_arg_type_t;
+
+/**
+ * \brief           Argument descriptor
+ */
+typedef struct {
+    microsh_arg_type_t type;                    /*!< Argument type */
+    int64_t min;                                /*!< Minimum value or string length. Not checked if `min` and `max` are `0` */
+    int64_t max;                                /*!< Maximum value or string length */
+    const char* const* keywords;                /*!< `NULL`-terminated list of keywords. Values of \ref microshARG_ENUM,
+                                                        allowed instead of value for other types. May be `NULL` */
+} microsh_arg_t;
+
+/**
+ * \brief           Command arguments schema
+ */
+typedef struct {
+    const microsh_arg_t* args;                  /*!< Descriptors of arguments following command name */
+    uint8_t num;                                /*!< Number of descriptors, maximum number of arguments */
+    uint8_t min_num;                            /*!< Number of required arguments */
+} microsh_arg_schema_t;
+
+/**
+ * \brief           Validated and converted argument
+ */
+typedef struct {
+    const char* str;                            /*!< Argument string */
+    uint32_t kw;                                /*!< Keyword index + 1, `0` if argument is not a keyword */
+    uint32_t u32;                               /*!< Value of \ref microshARG_U32 and \ref microshARG_HEX arguments */
+    int32_t i32;                                /*!< Value of \ref microshARG_I32 argument */
+} microsh_arg_val_t;
+
+int            microsh_arg_parse(const microsh_arg_schema_t* schema, int argc, const char* const *argv,
+                                    microsh_arg_val_t* vals);
+
+#endif /* MICROSH_CFG_ARG_SCHEMA || __DOXYGEN__ */
+
+/**
+ * \}
+ */
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* MICROSH_HDR_ARGS_H */
@@ -0,0 +1,150 @@
+/**
+ * \file            microsh_audit.h
+ * \brief           microSH audit log
+ */
+
+/*
+ * Copyright (c) 2022 Dmitry KARASEV
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * This file is part of microSH - Shell for Embedded Systems library.
+ *
+ * Author:          Dmitry KARASEV <karasevsdmitry@yandex.ru>
+ * Version:         2.0.0-dev
+ */
+
+#ifndef MICROSH_HDR_AUDIT_H
+#define MICROSH_HDR_AUDIT_H
+
+/* This file is included by "microsh.h" and must not be included directly */
+#ifndef MICROSH_HDR_H
+#error "Include \"microsh.h\" instead of \"microsh_audit.h\""
+#endif /* MICROSH_HDR_H */
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+/**
+ * \addtogroup      MICROSH
+ * \{
+ */
+
+#if MICROSH_CFG_AUDIT_LOG || __DOXYGEN__
+
+/**
+ * \brief           Audit record command index used when command is not found
+ */
+#define MICROSH_AUDIT_NO_CMD        0xFFFF
+
+/**
+ * \brief           Audit event type enumeration
+ */
+typedef enum {
+    microshAUDIT_LOGIN_OK        = 0x01,        /*!< Successful log in */
+    microshAUDIT_LOGIN_ERR_USER  = 0x02,        /*!< Log in with unknown username */
+    microshAUDIT_LOGIN_ERR_PASSW = 0x03,        /*!< Wrong password entered */
+    microshAUDIT_LOGOUT          = 0x04,        /*!< Session log out */
+    microshAUDIT_CMD_EXEC        = 0x05,        /*!< Command executed */
+} microsh_audit_event_t;
+
+/**
+ * \brief           Audit record as it is stored in persistent ring. Unused bytes
+ *                      of erased storage must read as `0xFF`
+ */
+typedef struct {
+    uint32_t seq;                               /*!< Record sequence number */
+    uint32_t login_type;                        /*!< Session login type at the moment of event */
+    uint16_t cmd_index;                         /*!< Registered command index or \ref MICROSH_AUDIT_NO_CMD */
+    uint8_t event;                              /*!< Event type, member of \ref microsh_audit_event_t */
+    uint8_t result;                             /*!< Command execution result, member of \ref microsh_execr_t */
+    uint16_t reserved;                          /*!< Reserved, written as `0xFFFF` */
+    uint16_t chk;                               /*!< Record check value */
+} microsh_audit_rec_t;
+
+/**
+ * \brief           Audit storage read function prototype
+ * \param[in]       ctx: User storage context
+ * \param[in]       addr: Storage address
+ * \param[out]      data: Buffer to read data to
+ * \param[in]       len: Number of bytes to read
+ * \return          \ref microshOK on success, member of \ref microshr_t otherwise
+ */
+typedef microshr_t (*microsh_audit_read_fn)(void* ctx, uint32_t addr, void* data, size_t len);
+
+/**
+ * \brief           Audit storage write function prototype
+ * \note            Write is performed only to erased area
+ * \param[in]       ctx: User storage context
+ * \param[in]       addr: Storage address
+ * \param[in]       data: Data to write
+ * \param[in]       len: Number of bytes to write
+ * \return          \ref microshOK on success, member of \ref microshr_t otherwise
+ */
+typedef microshr_t (*microsh_audit_write_fn)(void* ctx, uint32_t addr, const void* data, size_t len);
+
+/**
+ * \brief           Audit storage sector erase function prototype
+ * \param[in]       ctx: User storage context
+ * \param[in]       addr: Start address of sector to erase
+ * \return          \ref microshOK on success, member of \ref microshr_t otherwise
+ */
+typedef microshr_t (*microsh_audit_erase_fn)(void* ctx, uint32_t addr);
+
+/**
+ * \brief           Audit log persistent storage interface
+ *
+ * Storage is used as ring of sectors. Records are appended sequentially and
+ * sector is erased only when write position enters it, so every sector is
+ * erased once per ring pass
+ */
+typedef struct {
+    microsh_audit_read_fn read_fn;              /*!< Read function */
+    microsh_audit_write_fn write_fn;            /*!< Write function */
+    microsh_audit_erase_fn erase_fn;            /*!< Sector erase function */
+    uint32_t sector_size;                       /*!< Sector size in bytes */
+    uint32_t sector_num;                        /*!< Number of sectors. Minimum `2` */
+    void* ctx;                                  /*!< User context passed to storage functions */
+} microsh_audit_storage_t;
+
+/**
+ * \brief           Audit log context
+ */
+typedef struct {
+    const microsh_audit_storage_t* storage;     /*!< Persistent storage. `NULL` if audit log is not initialized */
+    uint32_t slot;                              /*!< Next record slot in storage ring */
+    uint32_t seq;                               /*!< Next record sequence number */
+    microsh_audit_rec_t queue[MICROSH_CFG_AUDIT_QUEUE_LEN]; /*!< Records waiting for flush */
+    volatile size_t queue_w;                    /*!< Queue write counter */
+    volatile size_t queue_r;                    /*!< Queue read counter */
+    size_t dropped;                             /*!< Number of records dropped on queue overflow */
+} microsh_audit_t;
+
+microshr_t     microsh_audit_init(struct microsh* msh, const microsh_audit_storage_t* storage);
+microshr_t     microsh_audit_flush(struct microsh* msh);
+microshr_t     microsh_audit_read(struct microsh* msh, size_t n, microsh_audit_rec_t* rec);
+size_t         microsh_audit_get_dropped(struct microsh* msh);
+int            microsh_audit_cmd(struct microsh* msh, int argc, const char* const *argv);
+
+#endif /* MICROSH_CFG_AUDIT_LOG || __DOXYGEN__ */
+
+/**
+ * \}
+ */
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* MICROSH_HDR_AUDIT_H */
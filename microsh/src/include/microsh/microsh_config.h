@@ -27,6 +27,14 @@
 #ifndef MICROSH_HDR_DEFAULT_CONFIG_H
 #define MICROSH_HDR_DEFAULT_CONFIG_H
 
+/**
+ * \brief           Log levels of messages printed by shell itself
+ */
+#define MICROSH_LOG_LEVEL_NONE                0   /*!< No messages */
+#define MICROSH_LOG_LEVEL_ERROR               1   /*!< Errors of log in and command execution */
+#define MICROSH_LOG_LEVEL_WARN                2   /*!< Warnings and hints */
+#define MICROSH_LOG_LEVEL_INFO                3   /*!< Log in process prompts and informational messages */
+
 /* Uncomment to ignore user options (or set macro in compiler flags) */
 /* #define MICROSH_IGNORE_USER_OPTS */
 
@@ -52,6 +60,61 @@ extern "C" {
 #define MICROSH_CFG_NUM_OF_CMDS               10
 #endif
 
+/**
+ * \brief           Enable built-in completion of commands, subcommands and argument keywords
+ *
+ * Completion callback of microRL is set by \ref microsh_init. Registered commands
+ * are indexed in name order. Requires `MICRORL_CFG_USE_COMPLETE` of microRL
+ */
+#ifndef MICROSH_CFG_COMPLETION
+#define MICROSH_CFG_COMPLETION                0
+#endif
+
+/**
+ * \brief           Maximum number of completion variants printed at once
+ */
+#ifndef MICROSH_CFG_COMPLETION_MAX_WORDS
+#define MICROSH_CFG_COMPLETION_MAX_WORDS      16
+#endif
+
+/**
+ * \brief           Accept unique prefixes of command and subcommand names, e.g. `sh ver` for `show version`
+ *
+ * Registered command names are indexed in prefix trie, so lookup time depends
+ * on entered name length only. Exact name is preferred over longer names
+ */
+#ifndef MICROSH_CFG_CMD_ABBREV
+#define MICROSH_CFG_CMD_ABBREV                0
+#endif
+
+/**
+ * \brief           Number of nodes of command names trie
+ *
+ * Every registered name takes one node per character not shared with other names
+ */
+#ifndef MICROSH_CFG_CMD_TRIE_NODES
+#define MICROSH_CFG_CMD_TRIE_NODES            (MICROSH_CFG_NUM_OF_CMDS * 8)
+#endif
+
+/**
+ * \brief           Enable nested subcommand tables
+ *
+ * Command may point to child table of subcommands, see \ref microsh_cmd_set_subcmds
+ */
+#ifndef MICROSH_CFG_SUBCMDS
+#define MICROSH_CFG_SUBCMDS                   0
+#endif
+
+/**
+ * \brief           Enable typed arguments schema of commands
+ *
+ * Arguments of command with schema are validated and converted by library
+ * before command function is called, see \ref microsh_cmd_set_schema
+ */
+#ifndef MICROSH_CFG_ARG_SCHEMA
+#define MICROSH_CFG_ARG_SCHEMA                0
+#endif
+
 /**
   * \brief           Enable logging of command execution result
   */
@@ -59,6 +122,362 @@ extern "C" {
 #define MICROSH_CFG_LOGGING_CMD_EXEC_RESULT   1
 #endif
 
+/**
+ * \brief           Suggest the nearest registered commands after "Unknown command" result
+ *
+ * Distance is Damerau-Levenshtein (optimal string alignment) distance
+ * not greater than \ref MICROSH_CFG_CMD_SUGGEST_MAX_DIST
+ */
+#ifndef MICROSH_CFG_CMD_SUGGEST
+#define MICROSH_CFG_CMD_SUGGEST               0
+#endif
+
+/**
+ * \brief           Maximum edit distance of suggested command names
+ *
+ * Distance is also limited by half of entered name length
+ */
+#ifndef MICROSH_CFG_CMD_SUGGEST_MAX_DIST
+#define MICROSH_CFG_CMD_SUGGEST_MAX_DIST      2
+#endif
+
+/**
+ * \brief           Maximum number of suggested command names
+ */
+#ifndef MICROSH_CFG_CMD_SUGGEST_NUM
+#define MICROSH_CFG_CMD_SUGGEST_NUM           3
+#endif
+
+/**
+ * \brief           Run several commands of one line separated by `;`, `&&` and `||` tokens
+ *
+ * `;` runs the next command always, `&&` only if the previous one
+ * returned \ref microshEXEC_OK, `||` only if it failed.
+ * Separators must be separate tokens, e.g. `sernum 5 && sernum save`
+ */
+#ifndef MICROSH_CFG_CMD_SEQUENCE
+#define MICROSH_CFG_CMD_SEQUENCE              0
+#endif
+
+/**
+ * \brief           Pass command output through built-in filters separated by `|` tokens
+ *
+ * Filters are `grep [-v] TEXT`, `head [N]` and `count`, e.g. `log dump | grep ERR | head 20`.
+ * Output is processed line by line while command prints it, nothing is buffered
+ * except the line being printed
+ */
+#ifndef MICROSH_CFG_PIPES
+#define MICROSH_CFG_PIPES                     0
+#endif
+
+/**
+ * \brief           Maximum number of filters of one command
+ */
+#ifndef MICROSH_CFG_PIPE_STAGES
+#define MICROSH_CFG_PIPE_STAGES               3
+#endif
+
+/**
+ * \brief           Length of piped line buffer including terminating `\0`
+ *
+ * Longer lines are split into several lines
+ */
+#ifndef MICROSH_CFG_PIPE_LINE_LEN
+#define MICROSH_CFG_PIPE_LINE_LEN             128
+#endif
+
+/**
+ * \brief           Enable shell variables
+ *
+ * `$NAME` in command arguments is replaced with variable value and `$?`
+ * with result of the previous command before command is executed
+ */
+#ifndef MICROSH_CFG_VARS
+#define MICROSH_CFG_VARS                      0
+#endif
+
+/**
+ * \brief           Number of variables hash table slots
+ *
+ * One slot is always kept free, so maximum number of variables is one less
+ */
+#ifndef MICROSH_CFG_VARS_NUM
+#define MICROSH_CFG_VARS_NUM                  16
+#endif
+
+/**
+ * \brief           Maximum variable name length including terminating `\0`
+ */
+#ifndef MICROSH_CFG_VAR_NAME_LEN
+#define MICROSH_CFG_VAR_NAME_LEN              12
+#endif
+
+/**
+ * \brief           Maximum variable value length including terminating `\0`
+ */
+#ifndef MICROSH_CFG_VAR_VALUE_LEN
+#define MICROSH_CFG_VAR_VALUE_LEN             32
+#endif
+
+/**
+ * \brief           Length of buffer for expanded arguments of command
+ */
+#ifndef MICROSH_CFG_VARS_LINE_LEN
+#define MICROSH_CFG_VARS_LINE_LEN             128
+#endif
+
+/**
+ * \brief           Enable command aliases
+ *
+ * Alias name entered as command is replaced with its body before command lookup.
+ * Body may hold several commands and `$1`..`$9`, `$*` positional parameters
+ */
+#ifndef MICROSH_CFG_ALIASES
+#define MICROSH_CFG_ALIASES                   0
+#endif
+
+/**
+ * \brief           Number of aliases hash table slots
+ *
+ * One slot is always kept free, so maximum number of aliases is one less
+ */
+#ifndef MICROSH_CFG_ALIASES_NUM
+#define MICROSH_CFG_ALIASES_NUM               8
+#endif
+
+/**
+ * \brief           Maximum alias name length including terminating `\0`
+ */
+#ifndef MICROSH_CFG_ALIAS_NAME_LEN
+#define MICROSH_CFG_ALIAS_NAME_LEN            12
+#endif
+
+/**
+ * \brief           Size of arena keeping names and bodies of all aliases
+ *
+ * It is also the size of persistent storage image. Maximum is `65535`
+ */
+#ifndef MICROSH_CFG_ALIAS_ARENA_LEN
+#define MICROSH_CFG_ALIAS_ARENA_LEN           256
+#endif
+
+/**
+ * \brief           Length of buffer for command line after aliases expansion
+ */
+#ifndef MICROSH_CFG_ALIAS_LINE_LEN
+#define MICROSH_CFG_ALIAS_LINE_LEN            128
+#endif
+
+/**
+ * \brief           Enable compiled command scripts
+ *
+ * Script text is compiled once to bytecode with resolved commands and
+ * tokenized arguments, which runs without command lookup
+ */
+#ifndef MICROSH_CFG_SCRIPT
+#define MICROSH_CFG_SCRIPT                    0
+#endif
+
+/**
+ * \brief           Size of compiled script bytecode in bytes. Maximum is `65535`
+ */
+#ifndef MICROSH_CFG_SCRIPT_CODE_LEN
+#define MICROSH_CFG_SCRIPT_CODE_LEN           256
+#endif
+
+/**
+ * \brief           Size of compiled script arguments pool in bytes. Maximum is `65535`
+ */
+#ifndef MICROSH_CFG_SCRIPT_STRS_LEN
+#define MICROSH_CFG_SCRIPT_STRS_LEN           256
+#endif
+
+/**
+ * \brief           Maximum nesting depth of script `if`, `while` and `repeat` blocks
+ */
+#ifndef MICROSH_CFG_SCRIPT_DEPTH
+#define MICROSH_CFG_SCRIPT_DEPTH              4
+#endif
+
+/**
+ * \brief           Enable `watch` command running command periodically
+ *
+ * Output of every run is compared with the previous one and only changed
+ * characters are printed with VT100 cursor moves. Shell time is updated
+ * with \ref microsh_tick
+ */
+#ifndef MICROSH_CFG_WATCH
+#define MICROSH_CFG_WATCH                     0
+#endif
+
+/**
+ * \brief           Number of watched output rows, the next rows are dropped
+ */
+#ifndef MICROSH_CFG_WATCH_ROWS
+#define MICROSH_CFG_WATCH_ROWS                16
+#endif
+
+/**
+ * \brief           Number of watched output columns, the rest of row is dropped. Maximum is `255`
+ */
+#ifndef MICROSH_CFG_WATCH_COLS
+#define MICROSH_CFG_WATCH_COLS                80
+#endif
+
+/**
+ * \brief           Length of watched command line buffer including terminating `\0`
+ */
+#ifndef MICROSH_CFG_WATCH_LINE_LEN
+#define MICROSH_CFG_WATCH_LINE_LEN            64
+#endif
+
+/**
+ * \brief           Enable scheduler of deferred and periodic commands
+ *
+ * Command lines and compiled scripts are kept in hierarchical timer wheel
+ * driven by \ref microsh_tick. Adds `at`, `every` and `atrm` built-in commands
+ */
+#ifndef MICROSH_CFG_SCHED
+#define MICROSH_CFG_SCHED                     0
+#endif
+
+/**
+ * \brief           Maximum number of scheduled jobs. Maximum is `254`
+ */
+#ifndef MICROSH_CFG_SCHED_JOBS
+#define MICROSH_CFG_SCHED_JOBS                8
+#endif
+
+/**
+ * \brief           Length of scheduled command line buffer including terminating `\0` of every token
+ */
+#ifndef MICROSH_CFG_SCHED_LINE_LEN
+#define MICROSH_CFG_SCHED_LINE_LEN            48
+#endif
+
+/**
+ * \brief           Scheduler tick in milliseconds, resolution of job times
+ */
+#ifndef MICROSH_CFG_SCHED_TICK_MS
+#define MICROSH_CFG_SCHED_TICK_MS             100
+#endif
+
+/**
+ * \brief           Number of slots of every timer wheel level as power of two
+ */
+#ifndef MICROSH_CFG_SCHED_WHEEL_BITS
+#define MICROSH_CFG_SCHED_WHEEL_BITS          5
+#endif
+
+/**
+ * \brief           Number of timer wheel levels
+ *
+ * Maximum delay is `MICROSH_CFG_SCHED_TICK_MS << (MICROSH_CFG_SCHED_WHEEL_BITS * MICROSH_CFG_SCHED_WHEEL_LEVELS)`
+ * milliseconds minus one tick, about 29 hours with default values
+ */
+#ifndef MICROSH_CFG_SCHED_WHEEL_LEVELS
+#define MICROSH_CFG_SCHED_WHEEL_LEVELS        4
+#endif
+
+/**
+ * \brief           Enable commands bound to application events
+ *
+ * Events are posted by \ref microsh_event_post from any context to lock-free
+ * queue, bound command lines are run by \ref microsh_tick. Adds `on` and
+ * `onrm` built-in commands. Atomic operations are set by `MICROSH_CFG_ATOMIC_*` macros
+ */
+#ifndef MICROSH_CFG_EVENTS
+#define MICROSH_CFG_EVENTS                    0
+#endif
+
+/**
+ * \brief           Number of posted events in queue. Must be power of `2`
+ */
+#ifndef MICROSH_CFG_EVENT_QUEUE_LEN
+#define MICROSH_CFG_EVENT_QUEUE_LEN           8
+#endif
+
+/**
+ * \brief           Maximum number of event bindings. Maximum is `255`
+ */
+#ifndef MICROSH_CFG_EVENT_BINDINGS
+#define MICROSH_CFG_EVENT_BINDINGS            8
+#endif
+
+/**
+ * \brief           Length of bound command line buffer including terminating `\0` of every token
+ */
+#ifndef MICROSH_CFG_EVENT_LINE_LEN
+#define MICROSH_CFG_EVENT_LINE_LEN            48
+#endif
+
+/**
+ * \brief           Enable persistent command history with reverse search
+ *
+ * Entered lines are appended to ring of storage sectors. Ctrl+R starts
+ * incremental search of stored lines, trigram signatures of lines are kept
+ * in RAM so only candidate lines are read from storage. Queries shorter than
+ * `3` characters have no trigrams and read every line. Terminal input must be
+ * passed to \ref microsh_hist_input. Adds `history` built-in command
+ */
+#ifndef MICROSH_CFG_HISTORY
+#define MICROSH_CFG_HISTORY                   0
+#endif
+
+/**
+ * \brief           Maximum number of stored lines, one signature of `8` bytes and
+ *                      owner byte with console sessions are kept in RAM per line.
+ *                      Storage sectors beyond it are not used
+ */
+#ifndef MICROSH_CFG_HISTORY_ENTRIES
+#define MICROSH_CFG_HISTORY_ENTRIES           256
+#endif
+
+/**
+ * \brief           Maximum stored line length including terminating `\0`.
+ *                      Longer lines are not stored
+ */
+#ifndef MICROSH_CFG_HISTORY_LINE_LEN
+#define MICROSH_CFG_HISTORY_LINE_LEN          56
+#endif
+
+/**
+ * \brief           Enable export of registered commands manifest for host tools
+ *
+ * Names, maximum numbers of arguments, descriptions, subcommands and arguments
+ * schemas are printed as JSON document. Adds `manifest` built-in command
+ */
+#ifndef MICROSH_CFG_MANIFEST
+#define MICROSH_CFG_MANIFEST                  0
+#endif
+
+/**
+ * \brief           Length of manifest chunk passed to output function at once
+ */
+#ifndef MICROSH_CFG_MANIFEST_CHUNK_LEN
+#define MICROSH_CFG_MANIFEST_CHUNK_LEN        64
+#endif
+
+/**
+ * \brief           Maximum log level of messages printed by shell itself
+ *
+ * Messages with higher level are removed at compile time together with their strings.
+ * Use one of `MICROSH_LOG_LEVEL_x` values
+ */
+#ifndef MICROSH_CFG_LOG_LEVEL
+#define MICROSH_CFG_LOG_LEVEL                 MICROSH_LOG_LEVEL_INFO
+#endif
+
+/**
+ * \brief           Print numeric message identifiers instead of message strings
+ *
+ * Message is printed as level letter and \ref microsh_msg_t value, e.g. `E#8`.
+ * No message strings are placed to firmware image
+ */
+#ifndef MICROSH_CFG_LOG_MSG_IDS
+#define MICROSH_CFG_LOG_MSG_IDS               0
+#endif
+
 
 /**
  * \brief           Enable console sessions with authentication process
@@ -69,11 +488,24 @@ extern "C" {
 
 /**
  * \brief           Maximum number of sessions credentials
+ *
+ * Credentials table is referenced by pointer and is not copied to RAM,
+ * the limit applies only to username hash index
  */
 #ifndef MICROSH_CFG_MAX_CREDENTIALS
 #define MICROSH_CFG_MAX_CREDENTIALS           5
 #endif
 
+/**
+ * \brief           Enable username hash index of credentials table
+ *
+ * Index takes `2 * MICROSH_CFG_MAX_CREDENTIALS` bytes of RAM per instance.
+ * Log in compares username with one or few credentials instead of all of them
+ */
+#ifndef MICROSH_CFG_CRED_HASH_INDEX
+#define MICROSH_CFG_CRED_HASH_INDEX           0
+#endif
+
 /**
  * \brief           Number of attempts to enter the session password
  */
@@ -81,6 +513,200 @@ extern "C" {
 #define MICROSH_CFG_MAX_AUTH_ATTEMPTS         3
 #endif
 
+/**
+ * \brief           Enable log in lockout after \ref MICROSH_CFG_MAX_AUTH_ATTEMPTS wrong passwords
+ *
+ * Lockout time is doubled on every next lockout and is reset by successful log in only.
+ * Input lines are dropped without password check while log in is locked.
+ * Time is provided by application with \ref microsh_tick function
+ */
+#ifndef MICROSH_CFG_LOGIN_LOCKOUT
+#define MICROSH_CFG_LOGIN_LOCKOUT             0
+#endif
+
+/**
+ * \brief           First log in lockout time in milliseconds
+ */
+#ifndef MICROSH_CFG_LOGIN_LOCKOUT_BASE_MS
+#define MICROSH_CFG_LOGIN_LOCKOUT_BASE_MS     1000
+#endif
+
+/**
+ * \brief           Maximum log in lockout time in milliseconds
+ */
+#ifndef MICROSH_CFG_LOGIN_LOCKOUT_MAX_MS
+#define MICROSH_CFG_LOGIN_LOCKOUT_MAX_MS      300000
+#endif
+
+/**
+ * \brief           Enable automatic log out of idle sessions
+ *
+ * Idle timeouts are set per login type with \ref microsh_session_set_idle_timeouts.
+ * Time is provided by application with \ref microsh_tick function
+ */
+#ifndef MICROSH_CFG_SESSION_IDLE_TIMEOUT
+#define MICROSH_CFG_SESSION_IDLE_TIMEOUT      0
+#endif
+
+/**
+ * \brief           Store salted password hashes in credentials instead of plaintext passwords
+ *
+ * Password is hashed with PBKDF2-HMAC-SHA256 and compared in constant time.
+ * Use `tools/microsh_passwd.py` to generate credentials table
+ */
+#ifndef MICROSH_CFG_PASSW_HASH
+#define MICROSH_CFG_PASSW_HASH                0
+#endif
+
+/**
+ * \brief           Number of PBKDF2 iterations of password hashing
+ *
+ * Password check takes `2 * MICROSH_CFG_PASSW_HASH_ITERATIONS + 2` SHA-256 block
+ * computations regardless of password, tune it for platform performance
+ */
+#ifndef MICROSH_CFG_PASSW_HASH_ITERATIONS
+#define MICROSH_CFG_PASSW_HASH_ITERATIONS     1000
+#endif
+
+/**
+ * \brief           Length of password hash salt in bytes
+ */
+#ifndef MICROSH_CFG_PASSW_SALT_LEN
+#define MICROSH_CFG_PASSW_SALT_LEN            16
+#endif
+
+/**
+ * \brief           Enable additional terminals sharing commands and credentials of shell instance
+ *
+ * Every terminal has its own line editor and console session, see \ref microsh_term_init.
+ * With console sessions enabled, logged out terminals accept `login` command only,
+ * register all commands once and check login type in command handlers if needed
+ */
+#ifndef MICROSH_CFG_TERMINALS
+#define MICROSH_CFG_TERMINALS                 0
+#endif
+
+/**
+ * \brief           Enable per-command execution profiling
+ *
+ * Every command function call is wrapped by user-defined counters backend,
+ * see \ref microsh_prof_backend_t. Results are accumulated per registered command
+ */
+#ifndef MICROSH_CFG_CMD_PROFILING
+#define MICROSH_CFG_CMD_PROFILING             0
+#endif
+
+/**
+ * \brief           Number of counters sampled by profiling backend on every command call
+ */
+#ifndef MICROSH_CFG_PROF_NUM_COUNTERS
+#define MICROSH_CFG_PROF_NUM_COUNTERS         3
+#endif
+
+/**
+ * \brief           Enable audit log of log ins and commands execution
+ *
+ * Audit records are queued in RAM and written to user-defined
+ * persistent storage by \ref microsh_audit_flush function
+ */
+#ifndef MICROSH_CFG_AUDIT_LOG
+#define MICROSH_CFG_AUDIT_LOG                 0
+#endif
+
+/**
+ * \brief           Number of audit records queued in RAM before flush to storage
+ */
+#ifndef MICROSH_CFG_AUDIT_QUEUE_LEN
+#define MICROSH_CFG_AUDIT_QUEUE_LEN           8
+#endif
+
+/**
+ * \brief           Enable asynchronous log messages printing from interrupts and other tasks
+ *
+ * Messages are queued by \ref microsh_log_async and printed by \ref microsh_log_process
+ * above the line being edited
+ */
+#ifndef MICROSH_CFG_ASYNC_LOG
+#define MICROSH_CFG_ASYNC_LOG                 0
+#endif
+
+/**
+ * \brief           Number of asynchronous log messages in queue. Must be power of `2`
+ */
+#ifndef MICROSH_CFG_ASYNC_LOG_QUEUE_LEN
+#define MICROSH_CFG_ASYNC_LOG_QUEUE_LEN       8
+#endif
+
+/**
+ * \brief           Maximum length of asynchronous log message including `NULL` termination
+ */
+#ifndef MICROSH_CFG_ASYNC_LOG_MSG_LEN
+#define MICROSH_CFG_ASYNC_LOG_MSG_LEN         64
+#endif
+
+/**
+ * \brief           Enable virtual channels multiplexer over single transport
+ *
+ * Shell, log and user data streams are sent in framed packets with channel
+ * identifier, see \ref microsh_mux_t
+ */
+#ifndef MICROSH_CFG_MUX
+#define MICROSH_CFG_MUX                       0
+#endif
+
+/**
+ * \brief           Number of multiplexer virtual channels
+ */
+#ifndef MICROSH_CFG_MUX_CHANNELS
+#define MICROSH_CFG_MUX_CHANNELS              3
+#endif
+
+/**
+ * \brief           Size of transmit queue of each multiplexer channel in bytes
+ */
+#ifndef MICROSH_CFG_MUX_TX_BUF_LEN
+#define MICROSH_CFG_MUX_TX_BUF_LEN            128
+#endif
+
+/**
+ * \brief           Maximum payload length of multiplexer frame in bytes
+ */
+#ifndef MICROSH_CFG_MUX_MAX_PAYLOAD
+#define MICROSH_CFG_MUX_MAX_PAYLOAD           64
+#endif
+
+/**
+ * \brief           Atomically compare `*ptr` with `*exp` and replace it with `des` if equal
+ *
+ * Used by lock-free queues. Must return non-zero on success, otherwise write
+ * actual value of `*ptr` to `*exp` and return `0`. Default implementation uses
+ * GCC atomic builtins, redefine it for other compilers or cores without atomic instructions
+ */
+#ifndef MICROSH_CFG_ATOMIC_CAS
+#define MICROSH_CFG_ATOMIC_CAS(ptr, exp, des) __atomic_compare_exchange_n((ptr), (exp), (des), 0, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE)
+#endif
+
+/**
+ * \brief           Atomically load `*ptr` with acquire semantics
+ */
+#ifndef MICROSH_CFG_ATOMIC_LOAD
+#define MICROSH_CFG_ATOMIC_LOAD(ptr)          __atomic_load_n((ptr), __ATOMIC_ACQUIRE)
+#endif
+
+/**
+ * \brief           Atomically store `val` to `*ptr` with release semantics
+ */
+#ifndef MICROSH_CFG_ATOMIC_STORE
+#define MICROSH_CFG_ATOMIC_STORE(ptr, val)    __atomic_store_n((ptr), (val), __ATOMIC_RELEASE)
+#endif
+
+/**
+ * \brief           Atomically add `val` to `*ptr`, used for statistics counters
+ */
+#ifndef MICROSH_CFG_ATOMIC_FETCH_ADD
+#define MICROSH_CFG_ATOMIC_FETCH_ADD(ptr, val) __atomic_fetch_add((ptr), (val), __ATOMIC_RELAXED)
+#endif
+
 /**
  * \}
  */
@@ -0,0 +1,121 @@
+/**
+ * \file            microsh_event.h
+ * \brief           microSH commands bound to application events
+ */
+
+/*
+ * Copyright (c) 2022 Dmitry KARASEV
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * This file is part of microSH - Shell for Embedded Systems library.
+ *
+ * Author:          Dmitry KARASEV <karasevsdmitry@yandex.ru>
+ * Version:         2.0.0-dev
+ */
+
+
+#ifndef MICROSH_HDR_EVENT_H
+#define MICROSH_HDR_EVENT_H
+
+/* This file is included by "microsh.h" and must not be included directly */
+#ifndef MICROSH_HDR_H
+#error "Include \"microsh.h\" instead of \"microsh_event.h\""
+#endif /* MICROSH_HDR_H */
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+/**
+ * \addtogroup      MICROSH
+ * \{
+ */
+
+#if MICROSH_CFG_EVENTS || __DOXYGEN__
+
+#if (MICROSH_CFG_EVENT_QUEUE_LEN & (MICROSH_CFG_EVENT_QUEUE_LEN - 1)) != 0
+#error "MICROSH_CFG_EVENT_QUEUE_LEN must be power of 2"
+#endif
+
+#if MICROSH_CFG_EVENT_BINDINGS > 255
+#error "MICROSH_CFG_EVENT_BINDINGS must not exceed 255"
+#endif /* MICROSH_CFG_EVENT_BINDINGS > 255 */
+
+/* Identifiers from `0xFF00` are reserved for events posted by shell itself */
+#define MICROSH_EVENT_LOGIN         0xFF00      /*!< Terminal is logged in */
+#define MICROSH_EVENT_LOGOUT        0xFF01      /*!< Terminal is logged out */
+
+/**
+ * \brief           Posted events queue cell
+ */
+typedef struct {
+    size_t seq;                                 /*!< Cell sequence number used for producers and consumer synchronization */
+    uint16_t id;                                /*!< Event identifier */
+} microsh_event_cell_t;
+
+/**
+ * \brief           Event name used by `on` command instead of identifier
+ */
+typedef struct {
+    uint16_t id;                                /*!< Event identifier */
+    const char* name;                           /*!< Event name */
+} microsh_event_name_t;
+
+/**
+ * \brief           Command line bound to event
+ */
+typedef struct {
+    microrl_t* mrl;                             /*!< Terminal which bound command, `NULL` for binding of application */
+    uint16_t id;                                /*!< Event identifier */
+    uint8_t argc;                               /*!< Number of command line tokens, `0` if binding is free */
+    char line[MICROSH_CFG_EVENT_LINE_LEN];      /*!< Command line tokens, each one is terminated with `\0` */
+} microsh_event_bind_t;
+
+/**
+ * \brief           Events queue and bindings
+ *
+ * Events are posted to bounded multi-producer single-consumer queue
+ * and dispatched to bound command lines in shell context
+ */
+typedef struct {
+    microsh_event_cell_t cells[MICROSH_CFG_EVENT_QUEUE_LEN]; /*!< Queue cells */
+    size_t enq_pos;                             /*!< Producers position, changed atomically */
+    size_t deq_pos;                             /*!< Consumer position */
+    size_t dropped;                             /*!< Number of events dropped on queue overflow */
+    microsh_event_bind_t binds[MICROSH_CFG_EVENT_BINDINGS]; /*!< Bindings table */
+    const microsh_event_name_t* names;          /*!< Application event names, may be `NULL` */
+    size_t names_num;                           /*!< Number of application event names */
+    char run_line[MICROSH_CFG_EVENT_LINE_LEN];  /*!< Copy of bound command line being run */
+    const char* argv[MICRORL_CFG_CMD_TOKEN_NMB]; /*!< Tokens of bound command line being run */
+} microsh_events_t;
+
+microshr_t     microsh_event_post(struct microsh* msh, uint16_t id);
+microshr_t     microsh_event_set_names(struct microsh* msh, const microsh_event_name_t* names, size_t num);
+microshr_t     microsh_event_bind(struct microsh* msh, uint16_t id, const char* line, uint8_t* num);
+microshr_t     microsh_event_unbind(struct microsh* msh, uint8_t num);
+
+int            microsh_event_on_cmd(struct microsh* msh, int argc, const char* const *argv);
+int            microsh_event_onrm_cmd(struct microsh* msh, int argc, const char* const *argv);
+
+#endif /* MICROSH_CFG_EVENTS || __DOXYGEN__ */
+
+/**
+ * \}
+ */
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* MICROSH_HDR_EVENT_H */
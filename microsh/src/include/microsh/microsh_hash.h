@@ -0,0 +1,72 @@
+/**
+ * \file            microsh_hash.h
+ * \brief           microSH password hashing
+ */
+
+/*
+ * Copyright (c) 2022 Dmitry KARASEV
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * This file is part of microSH - Shell for Embedded Systems library.
+ *
+ * Author:          Dmitry KARASEV <karasevsdmitry@yandex.ru>
+ * Version:         2.0.0-dev
+ */
+
+#ifndef MICROSH_HDR_HASH_H
+#define MICROSH_HDR_HASH_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include "microsh.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+/**
+ * \addtogroup      MICROSH
+ * \{
+ */
+
+#if MICROSH_CFG_PASSW_HASH || __DOXYGEN__
+
+/**
+ * \brief           SHA-256 context
+ */
+typedef struct {
+    uint32_t state[8];                          /*!< Intermediate hash value */
+    uint64_t len;                               /*!< Number of processed bytes */
+    uint8_t block[64];                          /*!< Incomplete data block */
+} microsh_sha256_t;
+
+void           microsh_sha256_init(microsh_sha256_t* ctx);
+void           microsh_sha256_update(microsh_sha256_t* ctx, const void* data, size_t len);
+void           microsh_sha256_final(microsh_sha256_t* ctx, uint8_t* digest);
+
+void           microsh_passw_hash(const char* passw, const uint8_t* salt, size_t salt_len,
+                                    uint32_t iterations, uint8_t* hash);
+uint8_t        microsh_passw_verify(const char* passw, const uint8_t* salt, const uint8_t* hash);
+
+#endif /* MICROSH_CFG_PASSW_HASH || __DOXYGEN__ */
+
+/**
+ * \}
+ */
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* MICROSH_HDR_HASH_H */
@@ -0,0 +1,147 @@
+/**
+ * \file            microsh_hist.h
+ * \brief           microSH persistent command history
+ */
+
+/*
+ * Copyright (c) 2022 Dmitry KARASEV
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * This file is part of microSH - Shell for Embedded Systems library.
+ *
+ * Author:          Dmitry KARASEV <karasevsdmitry@yandex.ru>
+ * Version:         2.0.0-dev
+ */
+
+
+#ifndef MICROSH_HDR_HIST_H
+#define MICROSH_HDR_HIST_H
+
+/* This file is included by "microsh.h" and must not be included directly */
+#ifndef MICROSH_HDR_H
+#error "Include \"microsh.h\" instead of \"microsh_hist.h\""
+#endif /* MICROSH_HDR_H */
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+/**
+ * \addtogroup      MICROSH
+ * \{
+ */
+
+#if MICROSH_CFG_HISTORY || __DOXYGEN__
+
+/**
+ * \brief           Owner of lines entered while console sessions are disabled
+ */
+#define MICROSH_HIST_OWNER_NONE                 0xFF
+
+/**
+ * \brief           History line as it is stored in persistent ring. Unused bytes
+ *                      of erased storage must read as `0xFF`
+ */
+typedef struct {
+    uint32_t seq;                               /*!< Line sequence number */
+    uint16_t chk;                               /*!< Record check value */
+    uint8_t len;                                /*!< Line length */
+    uint8_t owner;                              /*!< Index of credentials of user entered line,
+                                                        \ref MICROSH_HIST_OWNER_NONE without console sessions */
+    char line[MICROSH_CFG_HISTORY_LINE_LEN];    /*!< Line with terminating `\0` */
+} microsh_hist_rec_t;
+
+/**
+ * \brief           History storage read function prototype
+ * \param[in]       ctx: User storage context
+ * \param[in]       addr: Storage address
+ * \param[out]      data: Buffer to read data to
+ * \param[in]       len: Number of bytes to read
+ * \return          \ref microshOK on success, member of \ref microshr_t otherwise
+ */
+typedef microshr_t (*microsh_hist_read_fn)(void* ctx, uint32_t addr, void* data, size_t len);
+
+/**
+ * \brief           History storage write function prototype
+ * \note            Write is performed only to erased area
+ * \param[in]       ctx: User storage context
+ * \param[in]       addr: Storage address
+ * \param[in]       data: Data to write
+ * \param[in]       len: Number of bytes to write
+ * \return          \ref microshOK on success, member of \ref microshr_t otherwise
+ */
+typedef microshr_t (*microsh_hist_write_fn)(void* ctx, uint32_t addr, const void* data, size_t len);
+
+/**
+ * \brief           History storage sector erase function prototype
+ * \param[in]       ctx: User storage context
+ * \param[in]       addr: Start address of sector to erase
+ * \return          \ref microshOK on success, member of \ref microshr_t otherwise
+ */
+typedef microshr_t (*microsh_hist_erase_fn)(void* ctx, uint32_t addr);
+
+/**
+ * \brief           History persistent storage interface
+ *
+ * Storage is used as ring of sectors like audit log storage. The oldest
+ * sector is erased when write position enters it
+ */
+typedef struct {
+    microsh_hist_read_fn read_fn;               /*!< Read function */
+    microsh_hist_write_fn write_fn;             /*!< Write function */
+    microsh_hist_erase_fn erase_fn;             /*!< Sector erase function */
+    uint32_t sector_size;                       /*!< Sector size in bytes */
+    uint32_t sector_num;                        /*!< Number of sectors. Minimum `2` */
+    void* ctx;                                  /*!< User context passed to storage functions */
+} microsh_hist_storage_t;
+
+/**
+ * \brief           Persistent command history context
+ */
+typedef struct {
+    const microsh_hist_storage_t* storage;      /*!< Persistent storage. `NULL` if history is not initialized */
+    uint32_t slots;                             /*!< Number of used record slots in storage ring */
+    uint32_t slot;                              /*!< Next record slot in storage ring */
+    uint32_t seq;                               /*!< Next line sequence number */
+    uint32_t num;                               /*!< Number of stored lines */
+    uint64_t sigs[MICROSH_CFG_HISTORY_ENTRIES]; /*!< Trigram signatures of stored lines by slot */
+#if MICROSH_CFG_CONSOLE_SESSIONS
+    uint8_t owners[MICROSH_CFG_HISTORY_ENTRIES]; /*!< Owners of stored lines by slot */
+#endif /* MICROSH_CFG_CONSOLE_SESSIONS */
+    microrl_t* search_mrl;                      /*!< Terminal in reverse search mode, `NULL` if none */
+    uint32_t match;                             /*!< Current match, number of lines back from the newest */
+    uint8_t found;                              /*!< Current match is valid */
+    uint8_t failed;                             /*!< Query is not found after current match */
+    size_t query_len;                           /*!< Search query length */
+    char query[MICROSH_CFG_HISTORY_LINE_LEN];   /*!< Search query */
+    microsh_hist_rec_t rec;                     /*!< Record of current match */
+} microsh_hist_t;
+
+microshr_t     microsh_hist_init(struct microsh* msh, const microsh_hist_storage_t* storage);
+microshr_t     microsh_hist_input(struct microsh* msh, microrl_t* mrl, const void* data, size_t len);
+microshr_t     microsh_hist_read(struct microsh* msh, size_t n, microsh_hist_rec_t* rec);
+microshr_t     microsh_hist_clear(struct microsh* msh);
+int            microsh_hist_cmd(struct microsh* msh, int argc, const char* const *argv);
+
+#endif /* MICROSH_CFG_HISTORY || __DOXYGEN__ */
+
+/**
+ * \}
+ */
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* MICROSH_HDR_HIST_H */
@@ -0,0 +1,81 @@
+/**
+ * \file            microsh_log.h
+ * \brief           microSH asynchronous log
+ */
+
+/*
+ * Copyright (c) 2022 Dmitry KARASEV
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * This file is part of microSH - Shell for Embedded Systems library.
+ *
+ * Author:          Dmitry KARASEV <karasevsdmitry@yandex.ru>
+ * Version:         2.0.0-dev
+ */
+
+#ifndef MICROSH_HDR_LOG_H
+#define MICROSH_HDR_LOG_H
+
+/* This file is included by "microsh.h" and must not be included directly */
+#ifndef MICROSH_HDR_H
+#error "Include \"microsh.h\" instead of \"microsh_log.h\""
+#endif /* MICROSH_HDR_H */
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+/**
+ * \addtogroup      MICROSH
+ * \{
+ */
+
+#if MICROSH_CFG_ASYNC_LOG || __DOXYGEN__
+
+#if (MICROSH_CFG_ASYNC_LOG_QUEUE_LEN & (MICROSH_CFG_ASYNC_LOG_QUEUE_LEN - 1)) != 0
+#error "MICROSH_CFG_ASYNC_LOG_QUEUE_LEN must be power of 2"
+#endif
+
+/**
+ * \brief           Asynchronous log queue cell
+ */
+typedef struct {
+    size_t seq;                                 /*!< Cell sequence number used for producers and consumer synchronization */
+    char msg[MICROSH_CFG_ASYNC_LOG_MSG_LEN];    /*!< Message string */
+} microsh_log_cell_t;
+
+/**
+ * \brief           Asynchronous log bounded multi-producer single-consumer queue
+ */
+typedef struct {
+    microsh_log_cell_t cells[MICROSH_CFG_ASYNC_LOG_QUEUE_LEN]; /*!< Queue cells */
+    size_t enq_pos;                             /*!< Producers position, changed atomically */
+    size_t deq_pos;                             /*!< Consumer position */
+    size_t dropped;                             /*!< Number of messages dropped on queue overflow */
+} microsh_log_t;
+
+microshr_t     microsh_log_async(struct microsh* msh, const char* str);
+microshr_t     microsh_log_process(struct microsh* msh);
+
+#endif /* MICROSH_CFG_ASYNC_LOG || __DOXYGEN__ */
+
+/**
+ * \}
+ */
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* MICROSH_HDR_LOG_H */
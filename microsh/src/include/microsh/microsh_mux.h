@@ -0,0 +1,120 @@
+/**
+ * \file            microsh_mux.h
+ * \brief           microSH virtual channels multiplexer
+ */
+
+/*
+ * Copyright (c) 2022 Dmitry KARASEV
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * This file is part of microSH - Shell for Embedded Systems library.
+ *
+ * Author:          Dmitry KARASEV <karasevsdmitry@yandex.ru>
+ * Version:         2.0.0-dev
+ */
+
+#ifndef MICROSH_HDR_MUX_H
+#define MICROSH_HDR_MUX_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include "microsh.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+/**
+ * \addtogroup      MICROSH
+ * \{
+ */
+
+#if MICROSH_CFG_MUX || __DOXYGEN__
+
+/**
+ * \brief           Frame delimiter byte
+ *
+ * Frame format is `FLAG | channel | payload | CRC-8 | FLAG`. `FLAG` and `ESC`
+ * bytes inside frame are sent as `ESC` followed by byte XOR `0x20`
+ */
+#define MICROSH_MUX_FLAG            0x7E
+
+/**
+ * \brief           Frame escape byte
+ */
+#define MICROSH_MUX_ESC             0x7D
+
+/* Forward declarations */
+struct microsh_mux;
+
+/**
+ * \brief           Channel received data callback prototype
+ * \param[in]       arg: User argument of channel
+ * \param[in]       data: Received payload
+ * \param[in]       len: Payload length
+ */
+typedef void   (*microsh_mux_rx_fn)(void* arg, const uint8_t* data, size_t len);
+
+/**
+ * \brief           Transport write function prototype
+ * \param[in]       mux: Multiplexer instance
+ * \param[in]       data: Encoded frame to send
+ * \param[in]       len: Frame length
+ */
+typedef void   (*microsh_mux_tx_fn)(struct microsh_mux* mux, const uint8_t* data, size_t len);
+
+/**
+ * \brief           Multiplexer virtual channel
+ */
+typedef struct {
+    uint8_t tx_buf[MICROSH_CFG_MUX_TX_BUF_LEN]; /*!< Transmit queue */
+    size_t tx_w;                                /*!< Transmit queue write counter */
+    size_t tx_r;                                /*!< Transmit queue read counter */
+    uint8_t prio;                               /*!< Channel priority, `0` is the highest */
+    microsh_mux_rx_fn rx_fn;                    /*!< Received data callback. `NULL` to drop data */
+    void* arg;                                  /*!< User argument for received data callback */
+} microsh_mux_ch_t;
+
+/**
+ * \brief           Multiplexer instance
+ */
+typedef struct microsh_mux {
+    microsh_mux_ch_t ch[MICROSH_CFG_MUX_CHANNELS]; /*!< Virtual channels */
+    microsh_mux_tx_fn tx_fn;                    /*!< Transport write function */
+    void* arg;                                  /*!< User argument for transport */
+    uint8_t rx_frame[MICROSH_CFG_MUX_MAX_PAYLOAD + 2]; /*!< Received frame without delimiters */
+    size_t rx_len;                              /*!< Received frame length, `SIZE_MAX` when frame is dropped */
+    uint8_t rx_esc;                             /*!< Previous received byte was escape byte */
+    size_t rx_errors;                           /*!< Number of dropped received frames */
+} microsh_mux_t;
+
+microshr_t     microsh_mux_init(microsh_mux_t* mux, microsh_mux_tx_fn tx_fn, void* arg);
+microshr_t     microsh_mux_channel_set(microsh_mux_t* mux, uint8_t ch, uint8_t prio,
+                                            microsh_mux_rx_fn rx_fn, void* arg);
+size_t         microsh_mux_write(microsh_mux_t* mux, uint8_t ch, const void* data, size_t len);
+microshr_t     microsh_mux_input(microsh_mux_t* mux, const void* data, size_t len);
+microshr_t     microsh_mux_process(microsh_mux_t* mux);
+void           microsh_mux_shell_rx(void* arg, const uint8_t* data, size_t len);
+
+#endif /* MICROSH_CFG_MUX || __DOXYGEN__ */
+
+/**
+ * \}
+ */
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* MICROSH_HDR_MUX_H */
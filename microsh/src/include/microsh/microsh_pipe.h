@@ -0,0 +1,94 @@
+/**
+ * \file            microsh_pipe.h
+ * \brief           microSH command output pipes
+ */
+
+/*
+ * Copyright (c) 2022 Dmitry KARASEV
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * This file is part of microSH - Shell for Embedded Systems library.
+ *
+ * Author:          Dmitry KARASEV <karasevsdmitry@yandex.ru>
+ * Version:         2.0.0-dev
+ */
+
+#ifndef MICROSH_HDR_PIPE_H
+#define MICROSH_HDR_PIPE_H
+
+/* This file is included by "microsh.h" and must not be included directly */
+#ifndef MICROSH_HDR_H
+#error "Include \"microsh.h\" instead of \"microsh_pipe.h\""
+#endif /* MICROSH_HDR_H */
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+/**
+ * \addtogroup      MICROSH
+ * \{
+ */
+
+#if MICROSH_CFG_PIPES || __DOXYGEN__
+
+/**
+ * \brief           Pipe filter type
+ */
+typedef enum {
+    microshPIPE_GREP   = 0x00,                  /*!< Pass lines containing text */
+    microshPIPE_GREP_V = 0x01,                  /*!< Pass lines not containing text */
+    microshPIPE_HEAD   = 0x02,                  /*!< Pass the first lines */
+    microshPIPE_COUNT  = 0x03,                  /*!< Print number of lines at the end */
+} microsh_pipe_filter_t;
+
+/**
+ * \brief           Pipe filter stage
+ */
+typedef struct {
+    microsh_pipe_filter_t type;                 /*!< Filter type */
+    const char* text;                           /*!< Text to search of `grep` filter */
+    uint32_t limit;                             /*!< Number of lines to pass of `head` filter */
+    uint32_t lines;                             /*!< Number of lines passed or counted */
+} microsh_pipe_stage_t;
+
+/**
+ * \brief           Filters of command output
+ */
+typedef struct {
+    microsh_pipe_stage_t stages[MICROSH_CFG_PIPE_STAGES]; /*!< Filters in order of output passing */
+    size_t stages_num;                          /*!< Number of filters */
+    microrl_t* mrl;                             /*!< Terminal with redirected output, `NULL` if pipe is not open */
+    microrl_output_fn out_fn;                   /*!< Original output callback of terminal */
+    char line[MICROSH_CFG_PIPE_LINE_LEN];       /*!< Line being printed by command */
+    size_t len;                                 /*!< Length of line being printed */
+    uint8_t stopped;                            /*!< Set to `1` when no more lines pass filters */
+} microsh_pipe_t;
+
+int            microsh_pipe_open(microsh_pipe_t* pipe, microrl_t* mrl, microrl_output_fn pipe_fn,
+                                    int argc, const char* const *argv);
+int            microsh_pipe_write(microsh_pipe_t* pipe, const char* str);
+void           microsh_pipe_close(microsh_pipe_t* pipe);
+
+#endif /* MICROSH_CFG_PIPES || __DOXYGEN__ */
+
+/**
+ * \}
+ */
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* MICROSH_HDR_PIPE_H */
@@ -0,0 +1,112 @@
+/**
+ * \file            microsh_sched.h
+ * \brief           microSH scheduler of deferred and periodic commands
+ */
+
+/*
+ * Copyright (c) 2022 Dmitry KARASEV
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * This file is part of microSH - Shell for Embedded Systems library.
+ *
+ * Author:          Dmitry KARASEV <karasevsdmitry@yandex.ru>
+ * Version:         2.0.0-dev
+ */
+
+
+#ifndef MICROSH_HDR_SCHED_H
+#define MICROSH_HDR_SCHED_H
+
+/* This file is included by "microsh.h" and must not be included directly */
+#ifndef MICROSH_HDR_H
+#error "Include \"microsh.h\" instead of \"microsh_sched.h\""
+#endif /* MICROSH_HDR_H */
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+/**
+ * \addtogroup      MICROSH
+ * \{
+ */
+
+#if MICROSH_CFG_SCHED || __DOXYGEN__
+
+#if MICROSH_CFG_SCHED_JOBS > 254
+#error "MICROSH_CFG_SCHED_JOBS must not exceed 254"
+#endif /* MICROSH_CFG_SCHED_JOBS > 254 */
+
+/**
+ * \brief           Scheduled job
+ */
+typedef struct {
+    uint32_t expires;                           /*!< Scheduler tick of the next run */
+    uint32_t period;                            /*!< Period of runs in ticks, `0` for single run */
+    microrl_t* mrl;                             /*!< Terminal which added job, `NULL` for job of application */
+#if MICROSH_CFG_SCRIPT || __DOXYGEN__
+    const microsh_script_t* script;             /*!< Compiled script to run, `NULL` for command line */
+#endif /* MICROSH_CFG_SCRIPT || __DOXYGEN__ */
+    uint16_t list;                              /*!< Index of wheel slot or expired list holding job */
+    uint8_t next;                               /*!< Index + 1 of the next job in list, `0` for the last one */
+    uint8_t prev;                               /*!< Index + 1 of the previous job in list, `0` for the first one */
+    uint8_t state;                              /*!< Job state */
+    uint8_t argc;                               /*!< Number of command line tokens */
+    char line[MICROSH_CFG_SCHED_LINE_LEN];      /*!< Command line tokens, each one is terminated with `\0` */
+} microsh_sched_job_t;
+
+/**
+ * \brief           Scheduler of deferred and periodic commands
+ *
+ * Jobs are kept in hierarchical timer wheel. Every level has
+ * `1 << MICROSH_CFG_SCHED_WHEEL_BITS` slots, a slot of the next level
+ * covers full turn of the previous one. Job is moved down to lower level
+ * once its slot is reached, so insertion, cancellation and every tick
+ * take constant time
+ */
+typedef struct {
+    microsh_sched_job_t jobs[MICROSH_CFG_SCHED_JOBS]; /*!< Jobs pool */
+    uint8_t lists[(MICROSH_CFG_SCHED_WHEEL_LEVELS << MICROSH_CFG_SCHED_WHEEL_BITS) + 1]; /*!< Index + 1 of the first job
+                                                        of every wheel slot and of expired jobs list, which is the last */
+    uint8_t free;                               /*!< Index + 1 of the first released job, `0` if none */
+    uint8_t used;                               /*!< Number of jobs ever taken from pool */
+    uint8_t num;                                /*!< Number of scheduled jobs */
+    uint32_t tick;                              /*!< Current scheduler tick */
+    uint32_t tick_ms;                           /*!< Shell time of current tick */
+    const char* argv[MICRORL_CFG_CMD_TOKEN_NMB]; /*!< Tokens of command line being run */
+} microsh_sched_t;
+
+microshr_t     microsh_sched_add(struct microsh* msh, uint32_t delay_ms, uint32_t period_ms, const char* line,
+                                    uint8_t* id);
+#if MICROSH_CFG_SCRIPT || __DOXYGEN__
+microshr_t     microsh_sched_add_script(struct microsh* msh, uint32_t delay_ms, uint32_t period_ms,
+                                    const microsh_script_t* script, uint8_t* id);
+#endif /* MICROSH_CFG_SCRIPT || __DOXYGEN__ */
+microshr_t     microsh_sched_cancel(struct microsh* msh, uint8_t id);
+
+int            microsh_sched_at_cmd(struct microsh* msh, int argc, const char* const *argv);
+int            microsh_sched_every_cmd(struct microsh* msh, int argc, const char* const *argv);
+int            microsh_sched_atrm_cmd(struct microsh* msh, int argc, const char* const *argv);
+
+#endif /* MICROSH_CFG_SCHED || __DOXYGEN__ */
+
+/**
+ * \}
+ */
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* MICROSH_HDR_SCHED_H */
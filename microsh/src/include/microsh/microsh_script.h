@@ -0,0 +1,76 @@
+/**
+ * \file            microsh_script.h
+ * \brief           microSH compiled command scripts
+ */
+
+/*
+ * Copyright (c) 2022 Dmitry KARASEV
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * This file is part of microSH - Shell for Embedded Systems library.
+ *
+ * Author:          Dmitry KARASEV <karasevsdmitry@yandex.ru>
+ * Version:         2.0.0-dev
+ */
+
+#ifndef MICROSH_HDR_SCRIPT_H
+#define MICROSH_HDR_SCRIPT_H
+
+/* This file is included by "microsh.h" and must not be included directly */
+#ifndef MICROSH_HDR_H
+#error "Include \"microsh.h\" instead of \"microsh_script.h\""
+#endif /* MICROSH_HDR_H */
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+/**
+ * \addtogroup      MICROSH
+ * \{
+ */
+
+#if MICROSH_CFG_SCRIPT || __DOXYGEN__
+
+/**
+ * \brief           Compiled command script
+ *
+ * Script does not point to anything outside itself and may be kept in
+ * persistent storage. Every run verifies bytecode bounds, checksum and fingerprint
+ * of used commands, so script is run only while commands it calls are registered
+ * at the same positions with the same names as at compile time
+ */
+typedef struct {
+    uint8_t code[MICROSH_CFG_SCRIPT_CODE_LEN];  /*!< Bytecode */
+    char strs[MICROSH_CFG_SCRIPT_STRS_LEN];     /*!< Pool of `\0` terminated arguments */
+    uint16_t code_len;                          /*!< Used length of bytecode */
+    uint16_t strs_len;                          /*!< Used length of arguments pool */
+    uint32_t cmds_sig;                          /*!< Fingerprint of names and positions of used commands */
+    uint32_t chk;                               /*!< Checksum of script */
+} microsh_script_t;
+
+microshr_t     microsh_script_compile(struct microsh* msh, microsh_script_t* script, const char* text, size_t* err_line);
+int            microsh_script_run(struct microsh* msh, const microsh_script_t* script, const char** failed_cmd);
+
+#endif /* MICROSH_CFG_SCRIPT || __DOXYGEN__ */
+
+/**
+ * \}
+ */
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* MICROSH_HDR_SCRIPT_H */
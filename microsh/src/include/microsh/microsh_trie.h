@@ -0,0 +1,87 @@
+/**
+ * \file            microsh_trie.h
+ * \brief           microSH prefix trie of command names
+ */
+
+/*
+ * Copyright (c) 2022 Dmitry KARASEV
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * This file is part of microSH - Shell for Embedded Systems library.
+ *
+ * Author:          Dmitry KARASEV <karasevsdmitry@yandex.ru>
+ * Version:         2.0.0-dev
+ */
+
+#ifndef MICROSH_HDR_TRIE_H
+#define MICROSH_HDR_TRIE_H
+
+/* This file is included by "microsh.h" and must not be included directly */
+#ifndef MICROSH_HDR_H
+#error "Include \"microsh.h\" instead of \"microsh_trie.h\""
+#endif /* MICROSH_HDR_H */
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+/**
+ * \addtogroup      MICROSH
+ * \{
+ */
+
+#if MICROSH_CFG_CMD_ABBREV || __DOXYGEN__
+
+#if MICROSH_CFG_CMD_TRIE_NODES > 0xFFFF
+#error "MICROSH_CFG_CMD_TRIE_NODES must not exceed 65535"
+#endif /* MICROSH_CFG_CMD_TRIE_NODES > 0xFFFF */
+
+/**
+ * \brief           Trie node, one character of key
+ * \note            Index `0` is root node, so `0` in `child` and `next` means no node
+ */
+typedef struct {
+    char ch;                                    /*!< Key character */
+    uint8_t end;                                /*!< Set to `1` if key ends at this node */
+    uint16_t child;                             /*!< The first child node, children are sorted by character */
+    uint16_t next;                              /*!< The next sibling node */
+    uint16_t value;                             /*!< Value of key ending here, of the last key passed through otherwise */
+    uint16_t count;                             /*!< Number of keys starting with prefix of this node */
+} microsh_trie_node_t;
+
+/**
+ * \brief           Prefix trie with static nodes pool
+ */
+typedef struct {
+    microsh_trie_node_t nodes[MICROSH_CFG_CMD_TRIE_NODES]; /*!< Nodes pool, the first one is root */
+    uint16_t len;                               /*!< Number of used nodes */
+} microsh_trie_t;
+
+void           microsh_trie_reset(microsh_trie_t* trie);
+microshr_t     microsh_trie_insert(microsh_trie_t* trie, const char* key, uint16_t value);
+uint8_t        microsh_trie_find(const microsh_trie_t* trie, const char* key, uint16_t* value);
+size_t         microsh_trie_match(const microsh_trie_t* trie, const char* prefix, uint16_t* value);
+size_t         microsh_trie_collect(const microsh_trie_t* trie, const char* prefix, uint16_t* values, size_t max);
+
+#endif /* MICROSH_CFG_CMD_ABBREV || __DOXYGEN__ */
+
+/**
+ * \}
+ */
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* MICROSH_HDR_TRIE_H */
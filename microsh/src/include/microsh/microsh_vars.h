@@ -0,0 +1,84 @@
+/**
+ * \file            microsh_vars.h
+ * \brief           microSH shell variables
+ */
+
+/*
+ * Copyright (c) 2022 Dmitry KARASEV
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * This file is part of microSH - Shell for Embedded Systems library.
+ *
+ * Author:          Dmitry KARASEV <karasevsdmitry@yandex.ru>
+ * Version:         2.0.0-dev
+ */
+
+#ifndef MICROSH_HDR_VARS_H
+#define MICROSH_HDR_VARS_H
+
+/* This file is included by "microsh.h" and must not be included directly */
+#ifndef MICROSH_HDR_H
+#error "Include \"microsh.h\" instead of \"microsh_vars.h\""
+#endif /* MICROSH_HDR_H */
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+/**
+ * \addtogroup      MICROSH
+ * \{
+ */
+
+#if MICROSH_CFG_VARS || __DOXYGEN__
+
+/**
+ * \brief           Variable slot
+ */
+typedef struct {
+    char name[MICROSH_CFG_VAR_NAME_LEN];        /*!< Variable name, empty string if slot is free */
+    char value[MICROSH_CFG_VAR_VALUE_LEN];      /*!< Variable value */
+} microsh_var_t;
+
+/**
+ * \brief           Shell variables context
+ */
+typedef struct {
+    microsh_var_t slots[MICROSH_CFG_VARS_NUM];  /*!< Open addressing hash table with linear probing */
+    size_t num;                                 /*!< Number of variables */
+    int last_res;                               /*!< Result of the last executed command, value of `$?` */
+    char line[MICROSH_CFG_VARS_LINE_LEN];       /*!< Expanded arguments of command being executed */
+    const char* argv[MICRORL_CFG_CMD_TOKEN_NMB]; /*!< Arguments of command being executed after expansion */
+} microsh_vars_t;
+
+microshr_t     microsh_var_set(struct microsh* msh, const char* name, const char* value);
+const char*    microsh_var_get(struct microsh* msh, const char* name);
+microshr_t     microsh_var_unset(struct microsh* msh, const char* name);
+int            microsh_var_expand(struct microsh* msh, int* argc, const char* const **argv);
+
+int            microsh_var_set_cmd(struct microsh* msh, int argc, const char* const *argv);
+int            microsh_var_unset_cmd(struct microsh* msh, int argc, const char* const *argv);
+int            microsh_var_env_cmd(struct microsh* msh, int argc, const char* const *argv);
+
+#endif /* MICROSH_CFG_VARS || __DOXYGEN__ */
+
+/**
+ * \}
+ */
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* MICROSH_HDR_VARS_H */
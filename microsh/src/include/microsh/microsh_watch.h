@@ -0,0 +1,87 @@
+/**
+ * \file            microsh_watch.h
+ * \brief           microSH periodic command with diff redraw
+ */
+
+/*
+ * Copyright (c) 2022 Dmitry KARASEV
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * This file is part of microSH - Shell for Embedded Systems library.
+ *
+ * Author:          Dmitry KARASEV <karasevsdmitry@yandex.ru>
+ * Version:         2.0.0-dev
+ */
+
+#ifndef MICROSH_HDR_WATCH_H
+#define MICROSH_HDR_WATCH_H
+
+/* This file is included by "microsh.h" and must not be included directly */
+#ifndef MICROSH_HDR_H
+#error "Include \"microsh.h\" instead of \"microsh_watch.h\""
+#endif /* MICROSH_HDR_H */
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+/**
+ * \addtogroup      MICROSH
+ * \{
+ */
+
+#if MICROSH_CFG_WATCH || __DOXYGEN__
+
+/**
+ * \brief           Watched command context
+ *
+ * Output of command is drawn below the header and the prompt line. Screen
+ * copy holds what is shown on terminal, so only differences are printed
+ */
+typedef struct {
+    microrl_t* mrl;                             /*!< Terminal of watch, `NULL` if watch is stopped */
+    microrl_output_fn out_fn;                   /*!< Terminal output function while output is captured */
+    uint32_t period_ms;                         /*!< Period of command runs */
+    uint32_t next_ms;                           /*!< Time of the next run */
+    char line[MICROSH_CFG_WATCH_LINE_LEN];      /*!< Tokens of watched command line */
+    const char* argv[MICRORL_CFG_CMD_TOKEN_NMB]; /*!< Watched command line */
+    int argc;                                   /*!< Number of tokens of watched command line */
+    char screen[MICROSH_CFG_WATCH_ROWS][MICROSH_CFG_WATCH_COLS]; /*!< Output shown on terminal */
+    uint8_t row_len[MICROSH_CFG_WATCH_ROWS];    /*!< Shown length of rows */
+    uint8_t row;                                /*!< Row of output being captured */
+    uint8_t col;                                /*!< Column of output being captured */
+    uint8_t esc;                                /*!< State of skipped escape sequence of output */
+    uint8_t saved;                              /*!< Cursor position is saved while frame is drawn */
+    uint8_t cur_row;                            /*!< Terminal cursor row, `0xFF` if unknown */
+    uint8_t cur_col;                            /*!< Terminal cursor column */
+    char run[MICROSH_CFG_WATCH_COLS + 1];       /*!< Changed characters waiting for output */
+    uint8_t run_len;                            /*!< Number of waiting characters */
+    uint8_t run_row;                            /*!< Row of the first waiting character */
+    uint8_t run_col;                            /*!< Column of the first waiting character */
+} microsh_watch_t;
+
+int            microsh_watch_cmd(struct microsh* msh, int argc, const char* const *argv);
+microshr_t     microsh_watch_stop(microrl_t* mrl);
+
+#endif /* MICROSH_CFG_WATCH || __DOXYGEN__ */
+
+/**
+ * \}
+ */
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* MICROSH_HDR_WATCH_H */
@@ -46,13 +46,90 @@
 #include <stdint.h>
 #include <string.h>
 #include "microsh.h"
+#include "microsh_priv.h"
+#if MICROSH_CFG_PASSW_HASH
+#include "microsh_hash.h"
+#endif /* MICROSH_CFG_PASSW_HASH */
+
+#if MICROSH_CFG_COMPLETION && !MICRORL_CFG_USE_COMPLETE
+#error "MICROSH_CFG_COMPLETION requires MICRORL_CFG_USE_COMPLETE"
+#endif
+
+/* Maximum length of command names compared by suggestions */
+#define _SUGGEST_MAX_LEN            32
+
+#ifdef MICRORL_CFG_ECHO_OFF_MASK
+#define _ECHO_OFF_MASK              MICRORL_CFG_ECHO_OFF_MASK
+#else
+#define _ECHO_OFF_MASK              '*'
+#endif /* MICRORL_CFG_ECHO_OFF_MASK */
 
 #if MICROSH_CFG_CONSOLE_SESSIONS
 static int     prv_execute_login(microrl_t* mrl, int argc, const char* const *argv);
+static int     prv_login(microsh_t* msh, microrl_t* mrl, int argc, const char* const *argv);
+static void    prv_session_logout(microsh_t* msh, microrl_t* mrl);
+static microsh_session_status_t* prv_status(microsh_t* msh, microrl_t* mrl);
 static void    prv_clean_array(void *arr, size_t n);
+static const microsh_credentials_t* prv_cred_find(microsh_t* msh, const char* username);
+#if MICROSH_CFG_LOGIN_LOCKOUT || MICROSH_CFG_SESSION_IDLE_TIMEOUT
+static uint32_t prv_session_tick(microsh_t* msh, microrl_t* mrl, uint32_t next);
+#endif /* MICROSH_CFG_LOGIN_LOCKOUT || MICROSH_CFG_SESSION_IDLE_TIMEOUT */
+#if MICROSH_CFG_LOGIN_LOCKOUT
+static void    prv_login_lock(microsh_t* msh, microsh_session_status_t* st);
+#endif /* MICROSH_CFG_LOGIN_LOCKOUT */
 #endif /* MICROSH_CFG_CONSOLE_SESSIONS */
 
+#if MICROSH_CFG_CMD_PROFILING
+static int     prv_prof_run(microsh_t* msh, size_t index, microsh_cmd_fn cmd_fn, int argc, const char* const *argv);
+#endif /* MICROSH_CFG_CMD_PROFILING */
+
+/* Registered commands are found by index instead of linear lookup */
+#define _CMD_INDEX                  (MICROSH_CFG_CMD_ABBREV || MICROSH_CFG_COMPLETION)
+
+#if !_CMD_INDEX || MICROSH_CFG_SUBCMDS
+static const microsh_cmd_t* prv_cmd_lookup(const microsh_cmd_t* table, size_t num, const char* name, size_t* matches);
+#endif /* !_CMD_INDEX || MICROSH_CFG_SUBCMDS */
+static microsh_cmd_t* prv_cmd_match(microsh_t* msh, const char* name, size_t* matches);
+static uint8_t prv_is_help(int argc, const char* const *argv);
+#if MICROSH_CFG_SUBCMDS
+static const microsh_cmd_t* prv_subcmd_walk(const microsh_cmd_t* cmd, int argc, const char* const *argv, int* depth);
+#endif /* MICROSH_CFG_SUBCMDS */
+#if MICROSH_CFG_COMPLETION && !MICROSH_CFG_CMD_ABBREV
+static size_t  prv_cmd_lower_bound(microsh_t* msh, const char* str, size_t len);
+static void    prv_cmd_sort_insert(microsh_t* msh, size_t index);
+#endif /* MICROSH_CFG_COMPLETION && !MICROSH_CFG_CMD_ABBREV */
+#if MICROSH_CFG_COMPLETION
+static char**  prv_complete(microrl_t* mrl, int argc, const char* const *argv);
+#endif /* MICROSH_CFG_COMPLETION */
+#if MICROSH_CFG_CMD_SUGGEST
+static size_t  prv_edit_dist(const char* a, size_t a_len, const char* b, size_t b_len, size_t max);
+static void    prv_suggest(microsh_t* msh, microrl_t* mrl, const char* name);
+#endif /* MICROSH_CFG_CMD_SUGGEST */
 static int     prv_execute(microrl_t* mrl, int argc, const char* const *argv);
+static int     prv_execute_cmd(microsh_t* msh, microrl_t* mrl, int argc, const char* const *argv);
+static int     prv_execute_pipe(microsh_t* msh, microrl_t* mrl, int argc, const char* const *argv);
+#if MICROSH_CFG_PIPES
+static int     prv_pipe_pos(int argc, const char* const *argv);
+static int     prv_pipe_out(microrl_t* mrl, const char* str);
+#endif /* MICROSH_CFG_PIPES */
+#if MICROSH_CFG_CMD_SEQUENCE
+static int     prv_execute_seq(microsh_t* msh, microrl_t* mrl, int argc, const char* const *argv);
+static uint8_t prv_seq_find(int argc, const char* const *argv);
+#endif /* MICROSH_CFG_CMD_SEQUENCE */
+static void    prv_exec_result_print(microrl_t* mrl, int res, const char* name);
+#if MICROSH_CFG_WATCH
+static uint32_t prv_watch_tick(microsh_t* msh, uint32_t next);
+#endif /* MICROSH_CFG_WATCH */
+#if MICROSH_CFG_SCHED
+static uint32_t prv_sched_tick(microsh_t* msh, uint32_t next);
+#endif /* MICROSH_CFG_SCHED */
+#if MICROSH_CFG_EVENTS
+static uint32_t prv_event_tick(microsh_t* msh, uint32_t next);
+#endif /* MICROSH_CFG_EVENTS */
+#if MICROSH_CFG_SCHED || MICROSH_CFG_EVENTS
+static uint32_t prv_bg_begin(microsh_t* msh, microrl_t* mrl);
+static void    prv_bg_end(microsh_t* msh, microrl_t* mrl, uint32_t last_activity);
+#endif /* MICROSH_CFG_SCHED || MICROSH_CFG_EVENTS */
 
 /**
  * \brief           Init and prepare Shell stack for operation
@@ -70,13 +147,84 @@ microshr_t microsh_init(microsh_t* msh, microrl_output_fn out_fn) {
     }
 
     memset(msh, 0x00, sizeof(microsh_t));
+#if MICROSH_CFG_TERMINALS
+    msh->msh = msh;
+#endif /* MICROSH_CFG_TERMINALS */
+#if MICROSH_CFG_CMD_ABBREV
+    microsh_trie_reset(&msh->cmds_trie);
+#endif /* MICROSH_CFG_CMD_ABBREV */
+#if MICROSH_CFG_ASYNC_LOG
+    microsh_log_init(msh);
+#endif /* MICROSH_CFG_ASYNC_LOG */
+#if MICROSH_CFG_EVENTS
+    microsh_event_init(msh);
+#endif /* MICROSH_CFG_EVENTS */
     if (microrl_init(&msh->mrl, out_fn, prv_execute) != microrlOK) {
         res = microshERR;
     }
+#if MICROSH_CFG_COMPLETION
+    microrl_set_complete_callback(&msh->mrl, prv_complete);
+#endif /* MICROSH_CFG_COMPLETION */
 
     return res;
 }
 
+/**
+ * \brief           Update shell time and process expired timeouts
+ * \note            Shell does not poll time itself. Call this function before input
+ *                      processing and not later than returned deadline, e.g. from
+ *                      a tickless scheduler which sleeps until the next deadline
+ * \param[in,out]   msh: microSH instance
+ * \param[in]       now_ms: Current time in milliseconds from free-running counter, may wrap
+ * \return          Milliseconds until the next deadline, \ref MICROSH_NO_DEADLINE if none is pending
+ */
+uint32_t microsh_tick(microsh_t* msh, uint32_t now_ms) {
+    uint32_t next = MICROSH_NO_DEADLINE;
+
+    if (msh == NULL) {
+        return MICROSH_NO_DEADLINE;
+    }
+
+    msh->now_ms = now_ms;
+
+#if MICROSH_CFG_CONSOLE_SESSIONS && (MICROSH_CFG_LOGIN_LOCKOUT || MICROSH_CFG_SESSION_IDLE_TIMEOUT)
+    next = prv_session_tick(msh, &msh->mrl, next);
+#if MICROSH_CFG_TERMINALS
+    for (microsh_term_t* term = msh->terms; term != NULL; term = term->next) {
+        next = prv_session_tick(msh, &term->mrl, next);
+    }
+#endif /* MICROSH_CFG_TERMINALS */
+#endif /* MICROSH_CFG_CONSOLE_SESSIONS && (MICROSH_CFG_LOGIN_LOCKOUT || MICROSH_CFG_SESSION_IDLE_TIMEOUT) */
+#if MICROSH_CFG_WATCH
+    next = prv_watch_tick(msh, next);
+#endif /* MICROSH_CFG_WATCH */
+#if MICROSH_CFG_SCHED
+    next = prv_sched_tick(msh, next);
+#endif /* MICROSH_CFG_SCHED */
+#if MICROSH_CFG_EVENTS
+    next = prv_event_tick(msh, next);
+#endif /* MICROSH_CFG_EVENTS */
+
+    return next;
+}
+
+/**
+ * \brief           Get line editor of terminal being served
+ * \note            Use it in command handlers to print to terminal which entered the command
+ * \param[in]       msh: microSH instance
+ * \return          Line editor of additional terminal executing command,
+ *                      own line editor of instance otherwise
+ */
+microrl_t* microsh_get_mrl(microsh_t* msh) {
+#if MICROSH_CFG_TERMINALS
+    if (msh->cur_mrl != NULL) {
+        return msh->cur_mrl;
+    }
+#endif /* MICROSH_CFG_TERMINALS */
+
+    return &msh->mrl;
+}
+
 /**
  * \brief           Register new command to shell
  * \param[in,out]   msh: microSH instance
@@ -98,10 +246,31 @@ microshr_t microsh_cmd_register(microsh_t* msh, size_t arg_num, const char* cmd_
         return microshERRMEM;
     }
 
+#if MICROSH_CFG_CMD_ABBREV
+    /* Name must be unique to be found by abbreviation */
+    {
+        microshr_t res = microsh_trie_insert(&msh->cmds_trie, cmd_name, (uint16_t)msh->cmds_index);
+
+        if (res != microshOK) {
+            return res;
+        }
+    }
+#endif /* MICROSH_CFG_CMD_ABBREV */
+
     msh->cmds[msh->cmds_index].name = cmd_name;
     msh->cmds[msh->cmds_index].arg_num = arg_num;
     msh->cmds[msh->cmds_index].cmd_fn = cmd_fn;
     msh->cmds[msh->cmds_index].desc = desc;
+#if MICROSH_CFG_ARG_SCHEMA
+    msh->cmds[msh->cmds_index].schema = NULL;
+#endif /* MICROSH_CFG_ARG_SCHEMA */
+#if MICROSH_CFG_SUBCMDS
+    msh->cmds[msh->cmds_index].subcmds = NULL;
+    msh->cmds[msh->cmds_index].subcmds_num = 0;
+#endif /* MICROSH_CFG_SUBCMDS */
+#if MICROSH_CFG_COMPLETION && !MICROSH_CFG_CMD_ABBREV
+    prv_cmd_sort_insert(msh, msh->cmds_index);
+#endif /* MICROSH_CFG_COMPLETION && !MICROSH_CFG_CMD_ABBREV */
 
     ++msh->cmds_index;
 
@@ -120,6 +289,12 @@ microshr_t microsh_cmd_unregister_all(microsh_t* msh) {
 
     memset(msh->cmds, 0x00, sizeof(msh->cmds));
     msh->cmds_index = 0;
+#if MICROSH_CFG_CMD_ABBREV
+    microsh_trie_reset(&msh->cmds_trie);
+#endif /* MICROSH_CFG_CMD_ABBREV */
+#if MICROSH_CFG_CMD_PROFILING
+    microsh_prof_reset(msh);
+#endif /* MICROSH_CFG_CMD_PROFILING */
 
     return microshOK;
 }
@@ -132,40 +307,400 @@ microshr_t microsh_cmd_unregister_all(microsh_t* msh) {
  *                      'NULL' if command not registered
  */
 microsh_cmd_t* microsh_cmd_find(microsh_t* msh, const char* cmd_name) {
+    const microsh_cmd_t* cmd;
+
     if (msh == NULL || cmd_name == NULL || strlen(cmd_name) == 0 ||
             msh->cmds_index == 0) {
         return NULL;
     }
 
-    microsh_cmd_t* cmd = NULL;
-    for (size_t i = 0; i < msh->cmds_index; ++i) {
-        if (strcmp(msh->cmds[i].name, cmd_name) == 0) {
-            cmd = &msh->cmds[i];
+#if MICROSH_CFG_CMD_ABBREV
+    /* Walk prefix trie */
+    {
+        uint16_t i;
+
+        cmd = microsh_trie_find(&msh->cmds_trie, cmd_name, &i) ? &msh->cmds[i] : NULL;
+    }
+#elif MICROSH_CFG_COMPLETION
+    /* Binary search in name order index */
+    {
+        size_t i = prv_cmd_lower_bound(msh, cmd_name, strlen(cmd_name) + 1);
+
+        cmd = i < msh->cmds_index && strcmp(msh->cmds[msh->cmds_sorted[i]].name, cmd_name) == 0
+                ? &msh->cmds[msh->cmds_sorted[i]] : NULL;
+    }
+#else
+    cmd = prv_cmd_lookup(msh->cmds, msh->cmds_index, cmd_name, NULL);
+#endif /* MICROSH_CFG_CMD_ABBREV */
+
+    return cmd != NULL ? &msh->cmds[cmd - msh->cmds] : NULL;
+}
+
+#if MICROSH_CFG_SUBCMDS
+/**
+ * \brief           Set child table of subcommands of registered command
+ * \note            Subcommand is selected by the next argument, e.g. `net if stats`.
+ *                      Command function of parent is called when the next argument is
+ *                      not a subcommand. Subcommands may have own child tables
+ * \param[in,out]   msh: microSH instance
+ * \param[in]       cmd_name: Command name
+ * \param[in]       subcmds: Child table of subcommands. Table is not copied and must stay
+ *                      valid while command is registered, e.g. `const` table in flash
+ * \param[in]       num: Number of subcommands in table
+ * \return          \ref microshOK on success, member of \ref microshr_t otherwise
+ */
+microshr_t microsh_cmd_set_subcmds(microsh_t* msh, const char* cmd_name, const microsh_cmd_t* subcmds, size_t num) {
+    microsh_cmd_t* cmd = microsh_cmd_find(msh, cmd_name);
+
+    if (cmd == NULL || (subcmds == NULL && num > 0)) {
+        return microshERRPAR;
+    }
+
+    cmd->subcmds = subcmds;
+    cmd->subcmds_num = num;
+
+    return microshOK;
+}
+
+/**
+ * \brief           Find command or the deepest subcommand of entered arguments
+ * \param[in]       msh: microSH instance
+ * \param[in]       argc: Number of arguments
+ * \param[in]       argv: Pointer to arguments
+ * \param[out]      depth: Number of arguments after command name matched as subcommands.
+ *                      Arguments of found command start from `argv[depth]`. May be `NULL`
+ * \return          Pointer to command or subcommand, `NULL` if command is not registered
+ *                      or abbreviation is ambiguous
+ */
+const microsh_cmd_t* microsh_cmd_resolve(microsh_t* msh, int argc, const char* const *argv, int* depth) {
+    const microsh_cmd_t* cmd;
+    int d = 0;
+
+    if (msh == NULL || argv == NULL || argc < 1) {
+        return NULL;
+    }
+
+    cmd = prv_cmd_match(msh, argv[0], NULL);
+    if (cmd != NULL) {
+        cmd = prv_subcmd_walk(cmd, argc, argv, &d);
+    }
+    if (depth != NULL) {
+        *depth = d;
+    }
+
+    return cmd;
+}
+#endif /* MICROSH_CFG_SUBCMDS */
+
+#if MICROSH_CFG_ARG_SCHEMA
+/**
+ * \brief           Set arguments schema of registered command
+ * \note            Arguments are validated and converted before command function is called.
+ *                      Maximum number of arguments of command is taken from schema
+ * \param[in,out]   msh: microSH instance
+ * \param[in]       cmd_name: Command name
+ * \param[in]       schema: Arguments schema. Schema is not copied and must stay valid
+ *                      while command is registered. Set to `NULL` to disable validation
+ * \return          \ref microshOK on success, member of \ref microshr_t otherwise
+ */
+microshr_t microsh_cmd_set_schema(microsh_t* msh, const char* cmd_name, const microsh_arg_schema_t* schema) {
+    microsh_cmd_t* cmd = microsh_cmd_find(msh, cmd_name);
+
+    if (cmd == NULL || (schema != NULL && (schema->num >= MICRORL_CFG_CMD_TOKEN_NMB
+            || schema->min_num > schema->num || (schema->num > 0 && schema->args == NULL)))) {
+        return microshERRPAR;
+    }
+
+    cmd->schema = schema;
+    if (schema != NULL) {
+        cmd->arg_num = (size_t)schema->num + 1;
+    }
+
+    return microshOK;
+}
+
+/**
+ * \brief           Get converted arguments of command being executed
+ * \note            Call it from command function with arguments schema only
+ * \param[in]       msh: microSH instance
+ * \return          Array of converted arguments with the same indexes as in `argv`
+ */
+const microsh_arg_val_t* microsh_arg_values(microsh_t* msh) {
+    return msh->arg_vals;
+}
+#endif /* MICROSH_CFG_ARG_SCHEMA */
+
+#if MICROSH_CFG_TERMINALS
+/**
+ * \brief           Init additional terminal sharing commands and credentials of shell instance
+ * \note            Call this function after microsh_session_init(). Pass terminal input
+ *                      to its line editor with `microrl_processing_input(&term->mrl, ...)`
+ * \param[in,out]   msh: microSH instance
+ * \param[out]      term: Terminal to init. Must stay valid until \ref microsh_term_deinit
+ * \param[in]       out_fn: String output callback function of terminal transport
+ * \return          \ref microshOK on success, member of \ref microshr_t otherwise
+ */
+microshr_t microsh_term_init(microsh_t* msh, microsh_term_t* term, microrl_output_fn out_fn) {
+    if (msh == NULL || term == NULL || out_fn == NULL) {
+        return microshERRPAR;
+    }
+
+    memset(term, 0x00, sizeof(microsh_term_t));
+    term->msh = msh;
+    if (microrl_init(&term->mrl, out_fn, prv_execute) != microrlOK) {
+        return microshERR;
+    }
+#if MICROSH_CFG_COMPLETION
+    microrl_set_complete_callback(&term->mrl, prv_complete);
+#endif /* MICROSH_CFG_COMPLETION */
+
+#if MICROSH_CFG_CONSOLE_SESSIONS
+    /* Terminal starts with authentication */
+    term->status.attempt = MICROSH_CFG_MAX_AUTH_ATTEMPTS;
+    prv_session_logout(msh, &term->mrl);
+#endif /* MICROSH_CFG_CONSOLE_SESSIONS */
+
+    term->next = msh->terms;
+    msh->terms = term;
+
+    return microshOK;
+}
+
+/**
+ * \brief           Log out and remove additional terminal from shell instance
+ * \note            Call it when terminal transport is disconnected
+ * \param[in,out]   term: Terminal to remove
+ * \return          \ref microshOK on success, member of \ref microshr_t otherwise
+ */
+microshr_t microsh_term_deinit(microsh_term_t* term) {
+    microsh_t* msh;
+
+    if (term == NULL || term->msh == NULL) {
+        return microshERRPAR;
+    }
+
+    msh = term->msh;
+#if MICROSH_CFG_WATCH
+    microsh_watch_stop(&term->mrl);
+#endif /* MICROSH_CFG_WATCH */
+#if MICROSH_CFG_SCHED
+    microsh_sched_cancel_term(&msh->sched, &term->mrl);
+#endif /* MICROSH_CFG_SCHED */
+#if MICROSH_CFG_EVENTS
+    microsh_event_unbind_term(&msh->events, &term->mrl);
+#endif /* MICROSH_CFG_EVENTS */
+#if MICROSH_CFG_HISTORY
+    if (msh->hist.search_mrl == &term->mrl) {
+        msh->hist.search_mrl = NULL;
+    }
+#endif /* MICROSH_CFG_HISTORY */
+#if MICROSH_CFG_CONSOLE_SESSIONS
+    msh->cur_mrl = &term->mrl;
+    prv_session_logout(msh, &term->mrl);
+    msh->cur_mrl = NULL;
+#endif /* MICROSH_CFG_CONSOLE_SESSIONS */
+
+    for (microsh_term_t** t = &msh->terms; *t != NULL; t = &(*t)->next) {
+        if (*t == term) {
+            *t = term->next;
             break;
         }
     }
+    term->msh = NULL;
 
-    return cmd;
+    return microshOK;
+}
+#endif /* MICROSH_CFG_TERMINALS */
+
+#if MICROSH_CFG_CMD_PROFILING
+/**
+ * \brief           Set counters backend for command profiling
+ * \param[in,out]   msh: microSH instance
+ * \param[in]       backend: Pointer to counters backend. Set to `NULL` to disable profiling
+ * \return          \ref microshOK on success, member of \ref microshr_t otherwise
+ */
+microshr_t microsh_prof_set_backend(microsh_t* msh, const microsh_prof_backend_t* backend) {
+    if (msh == NULL || (backend != NULL && (backend->start_fn == NULL || backend->stop_fn == NULL))) {
+        return microshERRPAR;
+    }
+
+    msh->prof_backend = backend;
+    microsh_prof_reset(msh);
+
+    return microshOK;
+}
+
+/**
+ * \brief           Clear accumulated profiling statistics of all commands
+ * \param[in,out]   msh: microSH instance
+ * \return          \ref microshOK on success, member of \ref microshr_t otherwise
+ */
+microshr_t microsh_prof_reset(microsh_t* msh) {
+    if (msh == NULL) {
+        return microshERRPAR;
+    }
+
+    memset(msh->prof_stats, 0x00, sizeof(msh->prof_stats));
+
+    return microshOK;
+}
+
+/**
+ * \brief           Get accumulated profiling statistics of command
+ * \param[in]       msh: microSH instance
+ * \param[in]       cmd: Registered command instance, see \ref microsh_cmd_find
+ * \return          Pointer to \ref microsh_prof_stat_t statistics, `NULL` on error
+ */
+const microsh_prof_stat_t* microsh_prof_get_stat(microsh_t* msh, const microsh_cmd_t* cmd) {
+    if (msh == NULL || cmd == NULL || cmd < msh->cmds || cmd >= &msh->cmds[msh->cmds_index]) {
+        return NULL;
+    }
+
+    return &msh->prof_stats[cmd - msh->cmds];
+}
+
+/**
+ * \brief           Built-in command to print or reset profiling statistics
+ * \note            Register it with \ref microsh_cmd_register using `2` as maximum
+ *                      number of arguments. Use `reset` argument to clear statistics
+ * \param[in]       msh: microSH instance
+ * \param[in]       argc: argument count
+ * \param[in]       argv: pointer array to token string
+ * \return          \ref microshEXEC_OK on success, member of
+ *                      \ref microsh_execr_t enumeration otherwise
+ */
+int microsh_prof_cmd(microsh_t* msh, int argc, const char* const *argv) {
+    microrl_t* mrl = microsh_get_mrl(msh);
+    char num_str[21];
+
+    if (msh->prof_backend == NULL) {
+        MICROSH_MSG(mrl, MICROSH_LOG_LEVEL_ERROR, microshMSG_PROF_NO_BACKEND, "Profiling backend is not set");
+        return microshEXEC_ERROR;
+    }
+
+    if (argc > 1) {
+        if (strcmp(argv[1], "reset") != 0) {
+            return microshEXEC_ERROR;
+        }
+        microsh_prof_reset(msh);
+        return microshEXEC_OK;
+    }
+
+    for (size_t i = 0; i < msh->cmds_index; ++i) {
+        const microsh_prof_stat_t* stat = &msh->prof_stats[i];
+
+        if (stat->calls == 0) {
+            continue;
+        }
+
+        mrl->out_fn(mrl, msh->cmds[i].name);
+        mrl->out_fn(mrl, ": calls ");
+        mrl->out_fn(mrl, microsh_u64_to_str(stat->calls, num_str));
+        mrl->out_fn(mrl, MICRORL_CFG_END_LINE);
+
+        for (size_t j = 0; j < MICROSH_CFG_PROF_NUM_COUNTERS; ++j) {
+            if (msh->prof_backend->names[j] == NULL) {
+                continue;
+            }
+
+            mrl->out_fn(mrl, "    ");
+            mrl->out_fn(mrl, msh->prof_backend->names[j]);
+            mrl->out_fn(mrl, ": avg ");
+            mrl->out_fn(mrl, microsh_u64_to_str(stat->total[j] / stat->calls, num_str));
+            mrl->out_fn(mrl, ", max ");
+            mrl->out_fn(mrl, microsh_u64_to_str(stat->max[j], num_str));
+            mrl->out_fn(mrl, MICRORL_CFG_END_LINE);
+        }
+    }
+
+    return microshEXEC_OK;
+}
+
+/**
+ * \brief           Run command function wrapped by profiling counters
+ * \note            Subcommands are accounted to their top level command
+ * \param[in,out]   msh: microSH instance
+ * \param[in]       index: Index of registered top level command
+ * \param[in]       cmd_fn: Command function to run
+ * \param[in]       argc: argument count
+ * \param[in]       argv: pointer array to token string
+ * \return          Command function result
+ */
+static int prv_prof_run(microsh_t* msh, size_t index, microsh_cmd_fn cmd_fn, int argc, const char* const *argv) {
+    const microsh_prof_backend_t* backend = msh->prof_backend;
+    uint64_t counters[MICROSH_CFG_PROF_NUM_COUNTERS] = {0};
+    int res;
+
+    if (backend == NULL || backend->start_fn(msh) != microshOK) {
+        return cmd_fn(msh, argc, argv);
+    }
+
+    res = cmd_fn(msh, argc, argv);
+
+    if (backend->stop_fn(msh, counters) == microshOK) {
+        microsh_prof_stat_t* stat = &msh->prof_stats[index];
+
+        ++stat->calls;
+        for (size_t i = 0; i < MICROSH_CFG_PROF_NUM_COUNTERS; ++i) {
+            stat->total[i] += counters[i];
+            if (counters[i] > stat->max[i]) {
+                stat->max[i] = counters[i];
+            }
+        }
+    }
+
+    return res;
 }
 
+#endif /* MICROSH_CFG_CMD_PROFILING */
+
 #if MICROSH_CFG_CONSOLE_SESSIONS
 /**
  * \brief           Console sessions initialization
  * \note            Call this function right after microsh_init()
  * \param[in,out]   msh: microSH instance
- * \param[in]       cred: Pointer to array with sessions credentials
+ * \param[in]       cred: Pointer to array with sessions credentials. Array is
+ *                      not copied and must stay valid while shell is used, e.g. `const` table in flash
  * \param[in]       cred_num: Size of array with sessions credentials
  * \param[in]       logged_in_cb: Optional successful log in callback
  * \return          \ref microshOK on success, member of \ref microshr_t otherwise
  */
 microshr_t microsh_session_init(microsh_t* msh, const microsh_credentials_t* cred, size_t cred_num,
                                     microsh_logged_in_fn logged_in_cb) {
-    if (msh == NULL || cred == NULL || cred_num > MICROSH_CFG_MAX_CREDENTIALS) {
+    if (msh == NULL || cred == NULL) {
+        return microshERRPAR;
+    }
+
+#if MICROSH_CFG_CRED_HASH_INDEX
+    if (cred_num > MICROSH_CFG_MAX_CREDENTIALS) {
         return microshERRPAR;
     }
 
-    memcpy(msh->session.credentials, cred, cred_num * sizeof(microsh_credentials_t));
+    /* Build open addressing index, table is never full as it has twice more slots */
+    memset(msh->session.cred_index, 0x00, sizeof(msh->session.cred_index));
+    for (size_t i = 0; i < cred_num; ++i) {
+        size_t slot;
+
+        if (cred[i].username == NULL) {
+            continue;
+        }
+
+        slot = microsh_str_hash(cred[i].username) % MICROSH_CRED_INDEX_LEN;
+        while (msh->session.cred_index[slot] != 0) {
+            slot = (slot + 1) % MICROSH_CRED_INDEX_LEN;
+        }
+        msh->session.cred_index[slot] = (uint8_t)(i + 1);
+    }
+#endif /* MICROSH_CFG_CRED_HASH_INDEX */
+
+    msh->session.credentials = cred;
+    msh->session.cred_num = cred_num;
     msh->session.logged_in_fn = logged_in_cb;
+    msh->session.status.attempt = MICROSH_CFG_MAX_AUTH_ATTEMPTS;
+    msh->session.status.flags.locked = 0;
+#if MICROSH_CFG_LOGIN_LOCKOUT
+    msh->session.status.lockouts = 0;
+#endif /* MICROSH_CFG_LOGIN_LOCKOUT */
     microsh_session_logout(msh);
 
     return microshOK;
@@ -173,6 +708,7 @@ microshr_t microsh_session_init(microsh_t* msh, const microsh_credentials_t* cre
 
 /**
  * \brief           Check session status
+ * \note            Status of terminal executing command is returned, see \ref microsh_get_mrl
  * \param[in,out]   msh: microSH instance
  * \return          '1' if logged in session, '0' otherwise
  */
@@ -181,8 +717,39 @@ uint8_t microsh_session_is_logged_in(microsh_t* msh) {
         return 0;
     }
 
-    return msh->session.status.flags.logged_in == 1 ? 1 : 0;
+    return prv_status(msh, microsh_get_mrl(msh))->flags.logged_in == 1 ? 1 : 0;
+}
+
+#if MICROSH_CFG_HISTORY
+/**
+ * \brief           Get user logged in terminal
+ * \param[in]       msh: microSH instance
+ * \param[in]       mrl: \ref microrl_t working instance of terminal
+ * \return          Index of user credentials in table given to \ref microsh_session_init,
+ *                      `-1` if terminal is not logged in
+ */
+int microsh_session_term_user(microsh_t* msh, microrl_t* mrl) {
+    microsh_session_status_t* st = prv_status(msh, mrl);
+
+    if (!st->flags.logged_in || st->cred == NULL) {
+        return -1;
+    }
+
+    return (int)(st->cred - msh->session.credentials);
+}
+#endif /* MICROSH_CFG_HISTORY */
+
+#if MICROSH_CFG_MANIFEST
+/**
+ * \brief           Get session login type of terminal
+ * \param[in]       msh: microSH instance
+ * \param[in]       mrl: \ref microrl_t working instance of terminal
+ * \return          '0' if logged out, user-defined login type index otherwise
+ */
+uint32_t microsh_session_term_login_type(microsh_t* msh, microrl_t* mrl) {
+    return prv_status(msh, mrl)->login_type;
 }
+#endif /* MICROSH_CFG_MANIFEST */
 
 /**
  * \brief           Get current console session login type
@@ -194,11 +761,12 @@ uint32_t microsh_session_get_login_type(microsh_t* msh) {
         return 0;
     }
 
-    return msh->session.status.login_type;
+    return prv_status(msh, microsh_get_mrl(msh))->login_type;
 }
 
 /**
  * \brief           This function switches shell to session authentication process
+ * \note            Terminal executing command is logged out, see \ref microsh_get_mrl
  * \param[in,out]   msh: microSH instance
  * \return          \ref microshOK on success, member of \ref microshr_t otherwise
  */
@@ -207,14 +775,36 @@ microshr_t microsh_session_logout(microsh_t* msh) {
         return microshERRPAR;
     }
 
-    msh->session.status.login_type = 0;
-    msh->session.status.attempt = MICROSH_CFG_MAX_AUTH_ATTEMPTS;
-    msh->session.status.flags.logged_in = 0;
-    msh->session.status.flags.passw_wait = 0;
-    microrl_set_execute_callback(&msh->mrl, prv_execute_login);
+    prv_session_logout(msh, microsh_get_mrl(msh));
+
+    return microshOK;
+}
+
+#if MICROSH_CFG_SESSION_IDLE_TIMEOUT
+/**
+ * \brief           Set idle timeouts of login types
+ * \note            Session is logged out by \ref microsh_tick when no line is entered
+ *                      during timeout. Registered commands are unregistered at that moment
+ *                      as well, register log in commands again like after log out command.
+ *                      With \ref MICROSH_CFG_TERMINALS commands are shared and kept registered.
+ *                      Login types absent in table are never logged out automatically
+ * \param[in,out]   msh: microSH instance
+ * \param[in]       timeouts: Pointer to array with idle timeouts. Array is
+ *                      not copied and must stay valid while shell is used
+ * \param[in]       num: Size of array with idle timeouts
+ * \return          \ref microshOK on success, member of \ref microshr_t otherwise
+ */
+microshr_t microsh_session_set_idle_timeouts(microsh_t* msh, const microsh_idle_timeout_t* timeouts, size_t num) {
+    if (msh == NULL || (timeouts == NULL && num > 0)) {
+        return microshERRPAR;
+    }
+
+    msh->session.idle_timeouts = timeouts;
+    msh->session.idle_timeouts_num = num;
 
     return microshOK;
 }
+#endif /* MICROSH_CFG_SESSION_IDLE_TIMEOUT */
 
 /**
  * \brief           Session authentication process execute callback
@@ -225,7 +815,38 @@ microshr_t microsh_session_logout(microsh_t* msh) {
  *                      \ref microsh_execr_t enumeration otherwise
  */
 static int prv_execute_login(microrl_t* mrl, int argc, const char* const *argv) {
-    microsh_t* msh = (microsh_t*)mrl;
+    microsh_t* msh = MICROSH_FROM_MRL(mrl);
+#if MICROSH_CFG_TERMINALS
+    int res;
+
+    msh->cur_mrl = mrl == &msh->mrl ? NULL : mrl;
+    res = prv_login(msh, mrl, argc, argv);
+    msh->cur_mrl = NULL;
+
+    return res;
+#else
+    return prv_login(msh, mrl, argc, argv);
+#endif /* MICROSH_CFG_TERMINALS */
+}
+
+/**
+ * \brief           Session authentication process
+ * \param[in,out]   msh: microSH instance
+ * \param[in]       mrl: \ref microrl_t working instance of terminal
+ * \param[in]       argc: argument count
+ * \param[in]       argv: pointer array to token string
+ * \return          \ref microshEXEC_OK on success, member of
+ *                      \ref microsh_execr_t enumeration otherwise
+ */
+static int prv_login(microsh_t* msh, microrl_t* mrl, int argc, const char* const *argv) {
+    microsh_session_status_t* st = prv_status(msh, mrl);
+
+#if MICROSH_CFG_LOGIN_LOCKOUT
+    /* Drop input without password check while log in is locked */
+    if (st->flags.locked) {
+        return microshEXEC_ERROR;
+    }
+#endif /* MICROSH_CFG_LOGIN_LOCKOUT */
 
     /* Check for empty command buffer */
     if (argc == 0) {
@@ -237,40 +858,61 @@ static int prv_execute_login(microrl_t* mrl, int argc, const char* const *argv)
     while (i < argc) {
         if (strcmp(argv[i], "login") == 0) {
             if (!(++i < argc)) {
-                mrl->out_fn(mrl, "Enter your username after 'login' command"MICRORL_CFG_END_LINE);
+                MICROSH_MSG(mrl, MICROSH_LOG_LEVEL_ERROR, microshMSG_LOGIN_NO_USERNAME, "Enter your username after 'login' command");
                 return microshEXEC_ERROR;
             }
 
-            for (size_t j = 0; j < MICROSH_ARRAYSIZE(msh->session.credentials); ++j) {
-                if (strcmp(argv[i], msh->session.credentials[j].username) == 0) {
-                    microrl_set_echo(&msh->mrl, MICRORL_ECHO_OFF);
-                    msh->session.status.login_type = msh->session.credentials[j].login_type;
-                    msh->session.status.flags.passw_wait = 1;
-                    prv_clean_array((void*)argv[i], strlen(argv[i]));
+            st->cred = prv_cred_find(msh, argv[i]);
+            if (st->cred != NULL) {
+                microrl_set_echo(mrl, MICRORL_ECHO_OFF);
+                st->login_type = st->cred->login_type;
+                st->flags.passw_wait = 1;
+                prv_clean_array((void*)argv[i], strlen(argv[i]));
 
-                    mrl->out_fn(mrl, "Enter the password:"MICRORL_CFG_END_LINE);
-                    return microshEXEC_OK;
-                }
+                MICROSH_MSG(mrl, MICROSH_LOG_LEVEL_INFO, microshMSG_LOGIN_ENTER_PASSW, "Enter the password:");
+                return microshEXEC_OK;
             }
 
             prv_clean_array((void*)argv[i], strlen(argv[i]));
-            mrl->out_fn(mrl, "Wrong username! Try again"MICRORL_CFG_END_LINE);
+#if MICROSH_CFG_AUDIT_LOG
+            microsh_audit_push(msh, microshAUDIT_LOGIN_ERR_USER, MICROSH_AUDIT_NO_CMD, microshEXEC_ERROR);
+#endif /* MICROSH_CFG_AUDIT_LOG */
+            MICROSH_MSG(mrl, MICROSH_LOG_LEVEL_ERROR, microshMSG_LOGIN_WRONG_USERNAME, "Wrong username! Try again");
             return microshEXEC_ERROR;
-        } else if (msh->session.status.flags.passw_wait) {
-            size_t j;
-            for (j = 0; j < MICROSH_ARRAYSIZE(msh->session.credentials); ++j) {
-               if (msh->session.status.login_type == msh->session.credentials[j].login_type) {
-                   break;
-               }
-            }
+        } else if (st->flags.passw_wait) {
+            const microsh_credentials_t* cred = st->cred;
 
-            if (strcmp(argv[i], msh->session.credentials[j].password) == 0) {
-                msh->session.status.flags.passw_wait = 0;
-                msh->session.status.flags.logged_in = 1;
+#if MICROSH_CFG_PASSW_HASH
+            if (microsh_passw_verify(argv[i], cred->salt, cred->hash)) {
+#else
+            if (cred->password != NULL && strcmp(argv[i], cred->password) == 0) {
+#endif /* MICROSH_CFG_PASSW_HASH */
+                st->flags.passw_wait = 0;
+                st->flags.logged_in = 1;
+                st->attempt = MICROSH_CFG_MAX_AUTH_ATTEMPTS;
+#if MICROSH_CFG_LOGIN_LOCKOUT
+                st->lockouts = 0;
+#endif /* MICROSH_CFG_LOGIN_LOCKOUT */
+#if MICROSH_CFG_SESSION_IDLE_TIMEOUT
+                st->idle_timeout_ms = 0;
+                st->last_activity = msh->now_ms;
+                for (size_t j = 0; j < msh->session.idle_timeouts_num; ++j) {
+                    if (msh->session.idle_timeouts[j].login_type == cred->login_type) {
+                        st->idle_timeout_ms = msh->session.idle_timeouts[j].timeout_ms;
+                        break;
+                    }
+                }
+#endif /* MICROSH_CFG_SESSION_IDLE_TIMEOUT */
                 prv_clean_array((void*)argv[i], strlen(argv[i]));
-                microrl_set_echo(&msh->mrl, MICRORL_ECHO_ON);
+                microrl_set_echo(mrl, MICRORL_ECHO_ON);
                 microrl_set_execute_callback(mrl, prv_execute);
-                mrl->out_fn(mrl, "Logged In!"MICRORL_CFG_END_LINE);
+                MICROSH_MSG(mrl, MICROSH_LOG_LEVEL_INFO, microshMSG_LOGIN_OK, "Logged In!");
+#if MICROSH_CFG_AUDIT_LOG
+                microsh_audit_push(msh, microshAUDIT_LOGIN_OK, MICROSH_AUDIT_NO_CMD, microshEXEC_OK);
+#endif /* MICROSH_CFG_AUDIT_LOG */
+#if MICROSH_CFG_EVENTS
+                microsh_event_post(msh, MICROSH_EVENT_LOGIN);
+#endif /* MICROSH_CFG_EVENTS */
 
                 /* Call post log in callback if exist */
                 if (msh->session.logged_in_fn != NULL) {
@@ -280,25 +922,39 @@ static int prv_execute_login(microrl_t* mrl, int argc, const char* const *argv)
                 return microshEXEC_OK;
             }
 
-            mrl->out_fn(mrl, "Wrong password! ");
-            if (--msh->session.status.attempt == 0) {
-                mrl->out_fn(mrl, "Try to Log in again"MICRORL_CFG_END_LINE);
-                msh->session.status.login_type = 0;
-                msh->session.status.flags.passw_wait = 0;
-                msh->session.status.attempt = MICROSH_CFG_MAX_AUTH_ATTEMPTS;
-                microrl_set_echo(&msh->mrl, MICRORL_ECHO_ON);
+#if MICROSH_CFG_AUDIT_LOG
+            microsh_audit_push(msh, microshAUDIT_LOGIN_ERR_PASSW, MICROSH_AUDIT_NO_CMD, microshEXEC_ERROR);
+#endif /* MICROSH_CFG_AUDIT_LOG */
+            if (--st->attempt == 0) {
+#if MICROSH_CFG_LOGIN_LOCKOUT
+                prv_login_lock(msh, st);
+                MICROSH_MSG(mrl, MICROSH_LOG_LEVEL_ERROR, microshMSG_LOGIN_LOCKED, "Too many wrong passwords! Log in is locked");
+#else
+                MICROSH_MSG(mrl, MICROSH_LOG_LEVEL_ERROR, microshMSG_LOGIN_ATTEMPTS_OUT, "Wrong password! Try to Log in again");
+#endif /* MICROSH_CFG_LOGIN_LOCKOUT */
+                st->cred = NULL;
+                st->login_type = 0;
+                st->flags.passw_wait = 0;
+                st->attempt = MICROSH_CFG_MAX_AUTH_ATTEMPTS;
+                microrl_set_echo(mrl, MICRORL_ECHO_ON);
             } else {
-                mrl->out_fn(mrl, "Try again"MICRORL_CFG_END_LINE);
+                MICROSH_MSG(mrl, MICROSH_LOG_LEVEL_ERROR, microshMSG_LOGIN_WRONG_PASSW, "Wrong password! Try again");
             }
             prv_clean_array((void*)argv[i], strlen(argv[i]));
             return microshEXEC_ERROR;
         } else {
+#if MICROSH_CFG_TERMINALS
+            /* Commands are shared by logged in terminals, logged out ones may log in only */
+            MICROSH_MSG(mrl, MICROSH_LOG_LEVEL_WARN, microshMSG_LOGIN_REQUIRED, "You need to Log In! Type 'login YOUR_USERNAME'");
+            return microshEXEC_ERROR;
+#else
             /* Try to execute registered logged out commands */
-            if (prv_execute(mrl, argc, argv) != microshEXEC_OK) {
+            if (prv_execute_cmd(msh, mrl, argc, argv) > microshEXEC_ERROR) {
                 /* There are no such registered logged out commands */
-                mrl->out_fn(mrl, "You need to Log In! Type 'login YOUR_USERNAME'"MICRORL_CFG_END_LINE);
+                MICROSH_MSG(mrl, MICROSH_LOG_LEVEL_WARN, microshMSG_LOGIN_REQUIRED, "You need to Log In! Type 'login YOUR_USERNAME'");
                 return microshEXEC_ERROR;
             }
+#endif /* MICROSH_CFG_TERMINALS */
         }
         ++i;
     }
@@ -307,19 +963,183 @@ static int prv_execute_login(microrl_t* mrl, int argc, const char* const *argv)
 }
 
 /**
- * \brief           Safe array cleanup. Unlike memset() this function
- *                      is not removed by compiler optimizations
- * \param[out]      arr: Array with data to clear
- * \param[in]       n: Array length
+ * \brief           Switch terminal to session authentication process
+ * \param[in,out]   msh: microSH instance
+ * \param[in]       mrl: \ref microrl_t working instance of terminal
  */
-static void prv_clean_array(void *arr, size_t n)
-{
-    uint8_t* p = (uint8_t*)arr;
-    while (n--) {
-        *p++ = 0x00;
+static void prv_session_logout(microsh_t* msh, microrl_t* mrl) {
+    microsh_session_status_t* st = prv_status(msh, mrl);
+
+#if MICROSH_CFG_AUDIT_LOG
+    if (st->flags.logged_in) {
+        microsh_audit_push(msh, microshAUDIT_LOGOUT, MICROSH_AUDIT_NO_CMD, microshEXEC_OK);
     }
+#endif /* MICROSH_CFG_AUDIT_LOG */
+#if MICROSH_CFG_EVENTS
+    if (st->flags.logged_in) {
+        microsh_event_post(msh, MICROSH_EVENT_LOGOUT);
+    }
+#endif /* MICROSH_CFG_EVENTS */
+    st->cred = NULL;
+    st->login_type = 0;
+#if !MICROSH_CFG_LOGIN_LOCKOUT
+    st->attempt = MICROSH_CFG_MAX_AUTH_ATTEMPTS;
+#endif /* !MICROSH_CFG_LOGIN_LOCKOUT */
+    st->flags.logged_in = 0;
+    st->flags.passw_wait = 0;
+#if MICROSH_CFG_WATCH
+    microsh_watch_stop(mrl);
+#endif /* MICROSH_CFG_WATCH */
+#if MICROSH_CFG_SCHED
+    microsh_sched_cancel_term(&msh->sched, mrl);
+#endif /* MICROSH_CFG_SCHED */
+#if MICROSH_CFG_EVENTS
+    microsh_event_unbind_term(&msh->events, mrl);
+#endif /* MICROSH_CFG_EVENTS */
+    microrl_set_execute_callback(mrl, prv_execute_login);
 }
-#endif /* MICROSH_CFG_CONSOLE_SESSIONS */
+
+/**
+ * \brief           Get console session status of terminal
+ * \param[in]       msh: microSH instance
+ * \param[in]       mrl: \ref microrl_t working instance of terminal
+ * \return          Pointer to session status
+ */
+static microsh_session_status_t* prv_status(microsh_t* msh, microrl_t* mrl) {
+#if MICROSH_CFG_TERMINALS
+    if (mrl != &msh->mrl) {
+        return &((microsh_term_t*)mrl)->status;
+    }
+#else
+    MICROSH_UNUSED(mrl);
+#endif /* MICROSH_CFG_TERMINALS */
+
+    return &msh->session.status;
+}
+
+#if MICROSH_CFG_LOGIN_LOCKOUT || MICROSH_CFG_SESSION_IDLE_TIMEOUT
+/**
+ * \brief           Process session timeouts of terminal
+ * \param[in,out]   msh: microSH instance
+ * \param[in]       mrl: \ref microrl_t working instance of terminal
+ * \param[in]       next: Milliseconds until the next deadline of other terminals
+ * \return          Milliseconds until the next deadline
+ */
+static uint32_t prv_session_tick(microsh_t* msh, microrl_t* mrl, uint32_t next) {
+    microsh_session_status_t* st = prv_status(msh, mrl);
+
+#if MICROSH_CFG_LOGIN_LOCKOUT
+    if (st->flags.locked) {
+        uint32_t elapsed = msh->now_ms - st->lock_start;
+
+        if (elapsed >= st->lock_ms) {
+            st->flags.locked = 0;
+        } else if (st->lock_ms - elapsed < next) {
+            next = st->lock_ms - elapsed;
+        }
+    }
+#endif /* MICROSH_CFG_LOGIN_LOCKOUT */
+
+#if MICROSH_CFG_SESSION_IDLE_TIMEOUT
+    if (st->flags.logged_in && st->idle_timeout_ms != 0) {
+        uint32_t elapsed = msh->now_ms - st->last_activity;
+
+        if (elapsed >= st->idle_timeout_ms) {
+#if MICROSH_CFG_TERMINALS
+            msh->cur_mrl = mrl == &msh->mrl ? NULL : mrl;
+            prv_session_logout(msh, mrl);
+            msh->cur_mrl = NULL;
+#else
+            /* Same as log out command, commands of logged in session are not available anymore */
+            prv_session_logout(msh, mrl);
+            microsh_cmd_unregister_all(msh);
+#endif /* MICROSH_CFG_TERMINALS */
+
+            mrl->out_fn(mrl, MICRORL_CFG_END_LINE);
+            MICROSH_MSG(mrl, MICROSH_LOG_LEVEL_INFO, microshMSG_SESSION_TIMEOUT, "Session timed out! Logged out");
+            mrl->out_fn(mrl, mrl->prompt_str);
+        } else if (st->idle_timeout_ms - elapsed < next) {
+            next = st->idle_timeout_ms - elapsed;
+        }
+    }
+#endif /* MICROSH_CFG_SESSION_IDLE_TIMEOUT */
+
+    return next;
+}
+#endif /* MICROSH_CFG_LOGIN_LOCKOUT || MICROSH_CFG_SESSION_IDLE_TIMEOUT */
+
+/**
+ * \brief           Safe array cleanup. Unlike memset() this function
+ *                      is not removed by compiler optimizations
+ * \param[out]      arr: Array with data to clear
+ * \param[in]       n: Array length
+ */
+static void prv_clean_array(void *arr, size_t n)
+{
+    uint8_t* p = (uint8_t*)arr;
+    while (n--) {
+        *p++ = 0x00;
+    }
+}
+
+/**
+ * \brief           Find credentials by username
+ * \param[in]       msh: microSH instance
+ * \param[in]       username: Entered username
+ * \return          Pointer to credentials in user table, `NULL` if not found
+ */
+static const microsh_credentials_t* prv_cred_find(microsh_t* msh, const char* username) {
+    const microsh_credentials_t* cred;
+
+#if MICROSH_CFG_CRED_HASH_INDEX
+    size_t slot = microsh_str_hash(username) % MICROSH_CRED_INDEX_LEN;
+
+    /* Probe until empty slot, only usernames with the same hash slot are compared */
+    while (msh->session.cred_index[slot] != 0) {
+        cred = &msh->session.credentials[msh->session.cred_index[slot] - 1];
+        if (strcmp(username, cred->username) == 0) {
+            return cred;
+        }
+        slot = (slot + 1) % MICROSH_CRED_INDEX_LEN;
+    }
+#else
+    for (size_t i = 0; i < msh->session.cred_num; ++i) {
+        cred = &msh->session.credentials[i];
+        if (cred->username != NULL && strcmp(username, cred->username) == 0) {
+            return cred;
+        }
+    }
+#endif /* MICROSH_CFG_CRED_HASH_INDEX */
+
+    return NULL;
+}
+
+#if MICROSH_CFG_LOGIN_LOCKOUT
+/**
+ * \brief           Lock log in for exponentially growing time
+ * \note            Lockout time is \ref MICROSH_CFG_LOGIN_LOCKOUT_BASE_MS doubled for every
+ *                      previous lockout since last successful log in, up to \ref MICROSH_CFG_LOGIN_LOCKOUT_MAX_MS
+ * \param[in]       msh: microSH instance
+ * \param[in,out]   status: Session status of terminal
+ */
+static void prv_login_lock(microsh_t* msh, microsh_session_status_t* status) {
+    uint32_t lock_ms = MICROSH_CFG_LOGIN_LOCKOUT_BASE_MS;
+
+    for (uint32_t i = 0; i < status->lockouts && lock_ms < MICROSH_CFG_LOGIN_LOCKOUT_MAX_MS; ++i) {
+        lock_ms = lock_ms > UINT32_MAX / 2 ? UINT32_MAX : lock_ms * 2;
+    }
+    if (lock_ms > MICROSH_CFG_LOGIN_LOCKOUT_MAX_MS) {
+        lock_ms = MICROSH_CFG_LOGIN_LOCKOUT_MAX_MS;
+    }
+
+    ++status->lockouts;
+    status->lock_start = msh->now_ms;
+    status->lock_ms = lock_ms;
+    status->flags.locked = 1;
+}
+#endif /* MICROSH_CFG_LOGIN_LOCKOUT */
+
+#endif /* MICROSH_CFG_CONSOLE_SESSIONS */
 
 /**
  * \brief           Command execute callback general function
@@ -330,48 +1150,783 @@ static void prv_clean_array(void *arr, size_t n)
  *                      \ref microsh_execr_t enumeration otherwise
  */
 static int prv_execute(microrl_t* mrl, int argc, const char* const *argv) {
-    microsh_cmd_t* cmd = NULL;
-    microsh_t* msh = (microsh_t*)mrl;
+    microsh_t* msh = MICROSH_FROM_MRL(mrl);
+    int res = microshEXEC_OK;
 
-    /* Check for empty command buffer */
-    if (argc == 0) {
-        return microshEXEC_NO_CMD;
+#if MICROSH_CFG_TERMINALS
+    /* Shell functions called by command work with terminal which entered it */
+    msh->cur_mrl = mrl == &msh->mrl ? NULL : mrl;
+#endif /* MICROSH_CFG_TERMINALS */
+#if MICROSH_CFG_CMD_SEQUENCE
+    msh->seq_printed = 0;
+#endif /* MICROSH_CFG_CMD_SEQUENCE */
+#if MICROSH_CFG_ALIASES
+    /* Alias bodies may hold sequences and pipes, so aliases are expanded first */
+    res = microsh_alias_expand(msh, &argc, &argv);
+#endif /* MICROSH_CFG_ALIASES */
+    if (res == microshEXEC_OK) {
+#if MICROSH_CFG_CMD_SEQUENCE
+        res = prv_execute_seq(msh, mrl, argc, argv);
+#else
+        res = prv_execute_pipe(msh, mrl, argc, argv);
+#endif /* MICROSH_CFG_CMD_SEQUENCE */
     }
+#if MICROSH_CFG_TERMINALS
+    msh->cur_mrl = NULL;
+#endif /* MICROSH_CFG_TERMINALS */
 
-    /* Check for command */
-    if (msh->cmds_index > 0) {
-        size_t arg_len = strlen(argv[0]);
+    return res;
+}
+
+#if MICROSH_CFG_CMD_SEQUENCE
+/**
+ * \brief           Run commands of line separated by `;`, `&&` and `||` tokens
+ * \note            Results of commands of sequence are printed as they are executed,
+ *                      skipped commands do not change the result. Sequence stops
+ *                      if command ends the session
+ * \param[in,out]   msh: microSH instance
+ * \param[in]       mrl: \ref microrl_t working instance of terminal
+ * \param[in]       argc: argument count
+ * \param[in]       argv: pointer array to token string
+ * \return          Result of the last executed command
+ */
+static int prv_execute_seq(microsh_t* msh, microrl_t* mrl, int argc, const char* const *argv) {
+    int res = microshEXEC_NO_CMD, start = 0;
+    uint8_t run = 1;
+
+    /* Line of single command is reported by post execution hook as usual */
+    if (!prv_seq_find(argc, argv)) {
+        return prv_execute_pipe(msh, mrl, argc, argv);
+    }
+    msh->seq_printed = 1;
+
+    for (int i = 0; i <= argc; ++i) {
+        char op = i < argc ? microsh_seq_op(argv[i]) : ';';
+
+        if (op == '\0') {
+            continue;
+        }
 
-        /* Process all commands */
-        for (size_t i = 0; i < msh->cmds_index; ++i) {
-            if (arg_len == strlen(msh->cmds[i].name) && strncmp(msh->cmds[i].name, argv[0], arg_len) == 0) {
-                cmd = &msh->cmds[i];
+        /* Empty commands are skipped */
+        if (run && i > start) {
+            res = prv_execute_pipe(msh, mrl, i - start, &argv[start]);
+            prv_exec_result_print(mrl, res, argv[start]);
+#if MICROSH_CFG_CONSOLE_SESSIONS
+            if (!prv_status(msh, mrl)->flags.logged_in) {
                 break;
             }
+#endif /* MICROSH_CFG_CONSOLE_SESSIONS */
         }
+        run = op == ';' || (op == '&' && res == microshEXEC_OK) || (op == '|' && res != microshEXEC_OK);
+        start = i + 1;
     }
 
+    return res;
+}
+
+/**
+ * \brief           Get sequence operator of token
+ * \param[in]       token: Token string
+ * \return          `;` for `;`, `&` for `&&`, `|` for `||`, `\0` for other tokens
+ */
+char microsh_seq_op(const char* token) {
+    if (token[0] == ';' && token[1] == '\0') {
+        return ';';
+    }
+    if ((token[0] == '&' || token[0] == '|') && token[1] == token[0] && token[2] == '\0') {
+        return token[0];
+    }
+
+    return '\0';
+}
+
+/**
+ * \brief           Check for sequence operators in line
+ * \param[in]       argc: argument count
+ * \param[in]       argv: pointer array to token string
+ * \return          `1` if line is a sequence of commands, `0` otherwise
+ */
+static uint8_t prv_seq_find(int argc, const char* const *argv) {
+    for (int i = 0; i < argc; ++i) {
+        if (microsh_seq_op(argv[i]) != '\0') {
+            return 1;
+        }
+    }
+
+    return 0;
+}
+#endif /* MICROSH_CFG_CMD_SEQUENCE */
+
+/**
+ * \brief           Run command of line with its output filters
+ * \note            Filters follow the first `|` token with \ref MICROSH_CFG_PIPES enabled.
+ *                      Variables are expanded with \ref MICROSH_CFG_VARS enabled
+ * \param[in,out]   msh: microSH instance
+ * \param[in]       mrl: \ref microrl_t working instance of terminal
+ * \param[in]       argc: argument count
+ * \param[in]       argv: pointer array to token string
+ * \return          Result of command function, member of
+ *                      \ref microsh_execr_t enumeration on shell error
+ */
+static int prv_execute_pipe(microsh_t* msh, microrl_t* mrl, int argc, const char* const *argv) {
+    int res = microshEXEC_OK;
+#if MICROSH_CFG_PIPES
+    int i;
+#endif /* MICROSH_CFG_PIPES */
+
+#if MICROSH_CFG_VARS
+    /* Every command of sequence sees variables set and result of previous ones */
+    res = microsh_var_expand(msh, &argc, &argv);
+#endif /* MICROSH_CFG_VARS */
+
+    if (res != microshEXEC_OK) {
+        /* Command is not executed */
+#if MICROSH_CFG_PIPES
+    } else if ((i = prv_pipe_pos(argc, argv)) < argc) {
+        /* Command prints to filters while it is running */
+        res = i == 0 ? microshEXEC_ERROR_BAD_PIPE
+                : microsh_pipe_open(&msh->pipe, mrl, prv_pipe_out, argc - i - 1, &argv[i + 1]);
+        if (res == microshEXEC_OK) {
+            res = prv_execute_cmd(msh, mrl, i, argv);
+            microsh_pipe_close(&msh->pipe);
+        }
+#endif /* MICROSH_CFG_PIPES */
+    } else {
+        res = prv_execute_cmd(msh, mrl, argc, argv);
+    }
+
+#if MICROSH_CFG_VARS
+    msh->vars.last_res = res;
+#endif /* MICROSH_CFG_VARS */
+
+    return res;
+}
+
+#if MICROSH_CFG_PIPES
+/**
+ * \brief           Find the first `|` token
+ * \param[in]       argc: argument count
+ * \param[in]       argv: pointer array to token string
+ * \return          Index of `|` token, `argc` if there is no pipe
+ */
+static int prv_pipe_pos(int argc, const char* const *argv) {
+    int i = 0;
+
+    while (i < argc && !(argv[i][0] == '|' && argv[i][1] == '\0')) {
+        ++i;
+    }
+
+    return i;
+}
+
+/**
+ * \brief           Output callback of terminal while command output is piped
+ * \param[in]       mrl: \ref microrl_t working instance of terminal
+ * \param[in]       str: Output string
+ * \return          The number of characters written
+ */
+static int prv_pipe_out(microrl_t* mrl, const char* str) {
+    return microsh_pipe_write(&MICROSH_FROM_MRL(mrl)->pipe, str);
+}
+
+/**
+ * \brief           Check if piped output of command is not needed anymore
+ * \note            Command printing long output may stop when it returns `1`,
+ *                      e.g. after `head` filter has got all lines
+ * \param[in]       msh: microSH instance
+ * \return          `1` if output is dropped, `0` otherwise
+ */
+uint8_t microsh_pipe_stopped(microsh_t* msh) {
+    return msh != NULL && msh->pipe.mrl != NULL && msh->pipe.stopped;
+}
+#endif /* MICROSH_CFG_PIPES */
+
+/**
+ * \brief           Find and run command
+ * \param[in,out]   msh: microSH instance
+ * \param[in]       mrl: \ref microrl_t working instance of terminal
+ * \param[in]       argc: argument count
+ * \param[in]       argv: pointer array to token string
+ * \return          Result of command function, member of
+ *                      \ref microsh_execr_t enumeration on shell error
+ */
+static int prv_execute_cmd(microsh_t* msh, microrl_t* mrl, int argc, const char* const *argv) {
+    microsh_cmd_t* cmd = NULL;
+    const microsh_cmd_t* run;
+    size_t matches;
+    int res = microshEXEC_OK;
+
+#if MICROSH_CFG_CONSOLE_SESSIONS && MICROSH_CFG_SESSION_IDLE_TIMEOUT
+    /* Every entered line restarts idle timeout */
+    prv_status(msh, mrl)->last_activity = msh->now_ms;
+#endif /* MICROSH_CFG_CONSOLE_SESSIONS && MICROSH_CFG_SESSION_IDLE_TIMEOUT */
+
+    /* Check for empty command buffer */
+    if (argc == 0) {
+        return microshEXEC_NO_CMD;
+    }
+
+    /* Check for command */
+    cmd = prv_cmd_match(msh, argv[0], &matches);
+
     /* Valid command ready? */
     if (cmd == NULL) {
-        return microshEXEC_ERROR_UNK_CMD;
+        res = matches > 1 ? microshEXEC_ERROR_AMBIG_CMD : microshEXEC_ERROR_UNK_CMD;
+#if MICROSH_CFG_AUDIT_LOG
+        microsh_audit_push(msh, microshAUDIT_CMD_EXEC, MICROSH_AUDIT_NO_CMD, res);
+#endif /* MICROSH_CFG_AUDIT_LOG */
+        return res;
     }
+    run = cmd;
+
+#if MICROSH_CFG_SUBCMDS
+    /* Subcommand gets arguments starting from its own name */
+    if (cmd->subcmds != NULL) {
+        int depth;
+
+        run = prv_subcmd_walk(cmd, argc, argv, &depth);
+        argc -= depth;
+        argv += depth;
+        if (run == NULL || (run->cmd_fn == NULL && !prv_is_help(argc, argv))) {
+            res = run == NULL ? microshEXEC_ERROR_AMBIG_CMD
+                    : argc > 1 ? microshEXEC_ERROR_UNK_SUBCMD : microshEXEC_ERROR_FEW_ARGS;
+#if MICROSH_CFG_AUDIT_LOG
+            microsh_audit_push(msh, microshAUDIT_CMD_EXEC, cmd - msh->cmds, res);
+#endif /* MICROSH_CFG_AUDIT_LOG */
+            return res;
+        }
+    }
+#endif /* MICROSH_CFG_SUBCMDS */
+
+    return microsh_cmd_exec(msh, mrl, (size_t)(cmd - msh->cmds), run, argc, argv);
+}
+
+/**
+ * \brief           Run found command or subcommand
+ * \param[in,out]   msh: microSH instance
+ * \param[in]       mrl: \ref microrl_t working instance of terminal
+ * \param[in]       index: Index of registered command
+ * \param[in]       run: Registered command or its subcommand to run
+ * \param[in]       argc: argument count starting from name of `run`
+ * \param[in]       argv: pointer array to token string
+ * \return          Result of command function, member of
+ *                      \ref microsh_execr_t enumeration on shell error
+ */
+int microsh_cmd_exec(microsh_t* msh, microrl_t* mrl, size_t index, const microsh_cmd_t* run,
+                        int argc, const char* const *argv) {
+    int res = microshEXEC_OK;
+
+    MICROSH_UNUSED(index);
 
     /* Check for arguments */
-    if (argc > (int)cmd->arg_num) {
+    if (argc > (int)run->arg_num) {
+#if MICROSH_CFG_AUDIT_LOG
+        microsh_audit_push(msh, microshAUDIT_CMD_EXEC, index, microshEXEC_ERROR_MAX_ARGS);
+#endif /* MICROSH_CFG_AUDIT_LOG */
         return microshEXEC_ERROR_MAX_ARGS;
     }
 
     /* Run the command */
-    if (argc == 2 && argv[1][0] == '-' && argv[1][1] == 'h' && argv[1][2] == '\0') {
-        mrl->out_fn(mrl, cmd->desc);
-        mrl->out_fn(mrl, MICRORL_CFG_END_LINE);
+    if (prv_is_help(argc, argv)) {
+        if (run->desc != NULL) {
+            mrl->out_fn(mrl, run->desc);
+            mrl->out_fn(mrl, MICRORL_CFG_END_LINE);
+        }
     } else {
-        cmd->cmd_fn(msh, argc, argv);
+#if MICROSH_CFG_ARG_SCHEMA
+        /* Validate and convert arguments once before command function */
+        if (run->schema != NULL) {
+            res = microsh_arg_parse(run->schema, argc, argv, msh->arg_vals);
+            if (res != microshEXEC_OK) {
+#if MICROSH_CFG_AUDIT_LOG
+                microsh_audit_push(msh, microshAUDIT_CMD_EXEC, index, res);
+#endif /* MICROSH_CFG_AUDIT_LOG */
+                return res;
+            }
+        }
+#endif /* MICROSH_CFG_ARG_SCHEMA */
+#if MICROSH_CFG_CMD_PROFILING
+        res = prv_prof_run(msh, index, run->cmd_fn, argc, argv);
+#else
+        res = run->cmd_fn(msh, argc, argv);
+#endif /* MICROSH_CFG_CMD_PROFILING */
     }
+#if MICROSH_CFG_AUDIT_LOG
+    microsh_audit_push(msh, microshAUDIT_CMD_EXEC, index, res);
+#endif /* MICROSH_CFG_AUDIT_LOG */
 
-    return microshEXEC_OK;
+    return res;
+}
+
+#if !_CMD_INDEX || MICROSH_CFG_SUBCMDS
+/**
+ * \brief           Find command by name in commands table
+ * \note            Unique prefix of name is accepted with \ref MICROSH_CFG_CMD_ABBREV enabled
+ * \param[in]       table: Commands table
+ * \param[in]       num: Number of commands in table
+ * \param[in]       name: Command name string
+ * \param[out]      matches: Number of matched commands, more than `1` if abbreviation
+ *                      is ambiguous. May be `NULL`
+ * \return          Pointer to command, `NULL` if not found or ambiguous
+ */
+static const microsh_cmd_t* prv_cmd_lookup(const microsh_cmd_t* table, size_t num, const char* name, size_t* matches) {
+    const microsh_cmd_t* found = NULL;
+    size_t n = 0;
+#if MICROSH_CFG_CMD_ABBREV
+    size_t len = strlen(name);
+#endif /* MICROSH_CFG_CMD_ABBREV */
+
+    for (size_t i = 0; i < num; ++i) {
+        if (strcmp(table[i].name, name) == 0) {
+            found = &table[i];
+            n = 1;
+            break;
+        }
+#if MICROSH_CFG_CMD_ABBREV
+        if (strncmp(table[i].name, name, len) == 0) {
+            found = &table[i];
+            ++n;
+        }
+#endif /* MICROSH_CFG_CMD_ABBREV */
+    }
+    if (matches != NULL) {
+        *matches = n;
+    }
+
+    return n == 1 ? found : NULL;
+}
+#endif /* !_CMD_INDEX || MICROSH_CFG_SUBCMDS */
+
+/**
+ * \brief           Find registered command by name
+ * \note            Unique prefix of name is accepted with \ref MICROSH_CFG_CMD_ABBREV enabled
+ * \param[in]       msh: microSH instance
+ * \param[in]       name: Command name string
+ * \param[out]      matches: Number of matched commands, more than `1` if abbreviation
+ *                      is ambiguous. May be `NULL`
+ * \return          Pointer to command, `NULL` if not found or ambiguous
+ */
+static microsh_cmd_t* prv_cmd_match(microsh_t* msh, const char* name, size_t* matches) {
+    microsh_cmd_t* cmd;
+    size_t n;
+
+#if MICROSH_CFG_CMD_ABBREV
+    uint16_t i;
+
+    n = microsh_trie_match(&msh->cmds_trie, name, &i);
+    cmd = n == 1 ? &msh->cmds[i] : NULL;
+#else
+    cmd = microsh_cmd_find(msh, name);
+    n = cmd != NULL;
+#endif /* MICROSH_CFG_CMD_ABBREV */
+    if (matches != NULL) {
+        *matches = n;
+    }
+
+    return cmd;
+}
+
+/**
+ * \brief           Check for command help request `CMD -h`
+ * \param[in]       argc: Number of arguments
+ * \param[in]       argv: Pointer to arguments
+ * \return          `1` if help is requested, `0` otherwise
+ */
+static uint8_t prv_is_help(int argc, const char* const *argv) {
+    return argc == 2 && argv[1][0] == '-' && argv[1][1] == 'h' && argv[1][2] == '\0';
 }
 
+#if MICROSH_CFG_SUBCMDS
+/**
+ * \brief           Walk subcommand tables while arguments match subcommands
+ * \param[in]       cmd: Top level command matched by `argv[0]`
+ * \param[in]       argc: Number of arguments
+ * \param[in]       argv: Pointer to arguments
+ * \param[out]      depth: Number of matched subcommands
+ * \return          The deepest matched command, `NULL` if subcommand abbreviation is ambiguous
+ */
+static const microsh_cmd_t* prv_subcmd_walk(const microsh_cmd_t* cmd, int argc, const char* const *argv, int* depth) {
+    const microsh_cmd_t* sub;
+    size_t matches = 0;
+    int d = 0;
+
+    while (cmd->subcmds != NULL && d + 1 < argc
+            && (sub = prv_cmd_lookup(cmd->subcmds, cmd->subcmds_num, argv[d + 1], &matches)) != NULL) {
+        cmd = sub;
+        ++d;
+    }
+    *depth = d;
+
+    return cmd->subcmds != NULL && d + 1 < argc && matches > 1 ? NULL : cmd;
+}
+#endif /* MICROSH_CFG_SUBCMDS */
+
+#if MICROSH_CFG_COMPLETION && !MICROSH_CFG_CMD_ABBREV
+/**
+ * \brief           Find the first command in name order not less than string
+ * \param[in]       msh: microSH instance
+ * \param[in]       str: String to compare command names with
+ * \param[in]       len: Number of characters to compare. Use `strlen(str) + 1`
+ *                      for full names and `strlen(str)` for prefix
+ * \return          Position in \ref microsh_t.cmds_sorted index
+ */
+static size_t prv_cmd_lower_bound(microsh_t* msh, const char* str, size_t len) {
+    size_t lo = 0, hi = msh->cmds_index;
+
+    while (lo < hi) {
+        size_t mid = lo + (hi - lo) / 2;
+
+        if (strncmp(msh->cmds[msh->cmds_sorted[mid]].name, str, len) < 0) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+
+    return lo;
+}
+
+/**
+ * \brief           Insert just registered command to name order index
+ * \param[in,out]   msh: microSH instance
+ * \param[in]       index: Index of registered command
+ */
+static void prv_cmd_sort_insert(microsh_t* msh, size_t index) {
+    const char* name = msh->cmds[index].name;
+    size_t pos = prv_cmd_lower_bound(msh, name, strlen(name) + 1);
+
+    memmove(&msh->cmds_sorted[pos + 1], &msh->cmds_sorted[pos], (index - pos) * sizeof(msh->cmds_sorted[0]));
+    msh->cmds_sorted[pos] = (uint16_t)index;
+}
+#endif /* MICROSH_CFG_COMPLETION && !MICROSH_CFG_CMD_ABBREV */
+
+#if MICROSH_CFG_COMPLETION
+
+/**
+ * \brief           Completion callback for microRL
+ * \note            The last argument is completed. The first one is completed with names of
+ *                      registered commands, the next ones with subcommands and keywords
+ *                      of arguments schema of the deepest entered subcommand
+ * \param[in]       mrl: \ref microrl_t working instance of terminal
+ * \param[in]       argc: Number of arguments, the last one may be empty string
+ * \param[in]       argv: Pointer to arguments
+ * \return          `NULL`-terminated array of completion variants
+ */
+static char** prv_complete(microrl_t* mrl, int argc, const char* const *argv) {
+    microsh_t* msh = MICROSH_FROM_MRL(mrl);
+    const char* prefix = argc > 0 ? argv[argc - 1] : "";
+    size_t len = strlen(prefix), n = 0;
+
+#if MICROSH_CFG_CONSOLE_SESSIONS
+    /* Nothing to complete in password, logged out terminal accepts `login` only */
+    if (prv_status(msh, mrl)->flags.passw_wait
+#if MICROSH_CFG_TERMINALS
+            || !prv_status(msh, mrl)->flags.logged_in
+#endif /* MICROSH_CFG_TERMINALS */
+            ) {
+        msh->compl_words[0] = NULL;
+        return msh->compl_words;
+    }
+#endif /* MICROSH_CFG_CONSOLE_SESSIONS */
+
+    if (argc <= 1) {
+#if MICROSH_CFG_CMD_ABBREV
+        uint16_t idx[MICROSH_CFG_COMPLETION_MAX_WORDS];
+
+        /* Subtree of prefix in trie, the last name is kept on overflow */
+        n = microsh_trie_collect(&msh->cmds_trie, prefix, idx, MICROSH_ARRAYSIZE(idx));
+        n = n < MICROSH_ARRAYSIZE(idx) ? n : MICROSH_ARRAYSIZE(idx);
+        for (size_t i = 0; i < n; ++i) {
+            msh->compl_words[i] = (char*)msh->cmds[idx[i]].name;
+        }
+#else
+        size_t first = prv_cmd_lower_bound(msh, prefix, len), last = first;
+
+        while (last < msh->cmds_index && strncmp(msh->cmds[msh->cmds_sorted[last]].name, prefix, len) == 0) {
+            ++last;
+        }
+        for (size_t i = first; i < last && n < MICROSH_CFG_COMPLETION_MAX_WORDS; ++i) {
+            msh->compl_words[n++] = (char*)msh->cmds[msh->cmds_sorted[i]].name;
+        }
+
+        /* Common prefix of the first and the last names is common for all variants */
+        if (last - first > MICROSH_CFG_COMPLETION_MAX_WORDS) {
+            msh->compl_words[n - 1] = (char*)msh->cmds[msh->cmds_sorted[last - 1]].name;
+        }
+#endif /* MICROSH_CFG_CMD_ABBREV */
+    } else {
+        const microsh_cmd_t* cmd;
+        int depth = 0;
+
+#if MICROSH_CFG_SUBCMDS
+        cmd = microsh_cmd_resolve(msh, argc - 1, argv, &depth);
+        if (cmd != NULL && argc - 1 == depth + 1) {
+            for (size_t i = 0; i < cmd->subcmds_num && n < MICROSH_CFG_COMPLETION_MAX_WORDS; ++i) {
+                if (strncmp(cmd->subcmds[i].name, prefix, len) == 0) {
+                    msh->compl_words[n++] = (char*)cmd->subcmds[i].name;
+                }
+            }
+        }
+#else
+        cmd = microsh_cmd_find(msh, argv[0]);
+#endif /* MICROSH_CFG_SUBCMDS */
+
+#if MICROSH_CFG_ARG_SCHEMA
+        /* Keywords of argument being entered */
+        if (cmd != NULL && cmd->schema != NULL && argc - 1 - depth <= (int)cmd->schema->num) {
+            const char* const* kw = cmd->schema->args[argc - 2 - depth].keywords;
+
+            for (; kw != NULL && *kw != NULL && n < MICROSH_CFG_COMPLETION_MAX_WORDS; ++kw) {
+                if (strncmp(*kw, prefix, len) == 0) {
+                    msh->compl_words[n++] = (char*)*kw;
+                }
+            }
+        }
+#endif /* MICROSH_CFG_ARG_SCHEMA */
+        MICROSH_UNUSED(cmd);
+        MICROSH_UNUSED(depth);
+    }
+    MICROSH_UNUSED(len);
+    msh->compl_words[n] = NULL;
+
+    return msh->compl_words;
+}
+#endif /* MICROSH_CFG_COMPLETION */
+
+#if MICROSH_CFG_CMD_SUGGEST
+/**
+ * \brief           Damerau-Levenshtein (optimal string alignment) distance with cutoff
+ * \note            Only diagonal band of `2 * max + 1` cells is computed, calculation
+ *                      stops as soon as the whole row exceeds `max`
+ * \param[in]       a: The first string
+ * \param[in]       a_len: Length of the first string, not greater than `_SUGGEST_MAX_LEN`
+ * \param[in]       b: The second string
+ * \param[in]       b_len: Length of the second string, not greater than `a_len + max`
+ * \param[in]       max: Maximum distance of interest
+ * \return          Distance, `max + 1` if distance is greater than `max`
+ */
+static size_t prv_edit_dist(const char* a, size_t a_len, const char* b, size_t b_len, size_t max) {
+    uint8_t rows[3][_SUGGEST_MAX_LEN + MICROSH_CFG_CMD_SUGGEST_MAX_DIST + 1];
+    uint8_t *pprev = rows[0], *prev = rows[1], *cur = rows[2];
+
+    for (size_t j = 0; j <= b_len; ++j) {
+        prev[j] = (uint8_t)j;
+    }
+
+    for (size_t i = 1; i <= a_len; ++i) {
+        size_t lo = i > max ? i - max : 1;
+        size_t hi = i + max < b_len ? i + max : b_len;
+        size_t row_min = lo == 1 ? i : max + 1;
+        uint8_t* tmp;
+
+        /* Cells out of band are greater than `max` */
+        cur[0] = (uint8_t)i;
+        if (lo > 1) {
+            cur[lo - 1] = (uint8_t)(max + 1);
+        }
+        for (size_t j = lo; j <= hi; ++j) {
+            size_t d = prev[j - 1] + (a[i - 1] != b[j - 1]);
+
+            if (prev[j] + 1u < d) {
+                d = prev[j] + 1u;
+            }
+            if (cur[j - 1] + 1u < d) {
+                d = cur[j - 1] + 1u;
+            }
+            if (i > 1 && j > 1 && a[i - 1] == b[j - 2] && a[i - 2] == b[j - 1] && pprev[j - 2] + 1u < d) {
+                d = pprev[j - 2] + 1u;
+            }
+            cur[j] = (uint8_t)(d < max + 1 ? d : max + 1);
+            if (d < row_min) {
+                row_min = d;
+            }
+        }
+        if (hi < b_len) {
+            cur[hi + 1] = (uint8_t)(max + 1);
+        }
+
+        /* Early cutoff, distance never decreases from row to row */
+        if (row_min > max) {
+            return max + 1;
+        }
+
+        tmp = pprev;
+        pprev = prev;
+        prev = cur;
+        cur = tmp;
+    }
+
+    return prev[b_len] < max + 1 ? prev[b_len] : max + 1;
+}
+
+/**
+ * \brief           Print registered commands nearest to unknown command name
+ * \note            Names with length differing by more than maximum distance are
+ *                      skipped without distance calculation. Maximum distance
+ *                      shrinks while the best names are found
+ * \param[in]       msh: microSH instance
+ * \param[in]       mrl: \ref microrl_t working instance of terminal
+ * \param[in]       name: Unknown command name
+ */
+static void prv_suggest(microsh_t* msh, microrl_t* mrl, const char* name) {
+    const char* best[MICROSH_CFG_CMD_SUGGEST_NUM];
+    size_t best_dist[MICROSH_CFG_CMD_SUGGEST_NUM];
+    size_t len = strlen(name), num = 0, max;
+
+    if (len > _SUGGEST_MAX_LEN) {
+        return;
+    }
+    max = (len + 1) / 2 < MICROSH_CFG_CMD_SUGGEST_MAX_DIST ? (len + 1) / 2 : MICROSH_CFG_CMD_SUGGEST_MAX_DIST;
+
+    for (size_t i = 0; i < msh->cmds_index; ++i) {
+        const char* cmd_name = msh->cmds[i].name;
+        size_t cmd_len, dist, pos;
+
+        /* Length filter, name is not scanned further than needed */
+        for (cmd_len = 0; cmd_len <= len + max && cmd_name[cmd_len] != '\0'; ++cmd_len) {}
+        if (cmd_len + max < len || cmd_len > len + max) {
+            continue;
+        }
+
+        /* The same name is not suggested, command itself may return unknown command result */
+        dist = prv_edit_dist(name, len, cmd_name, cmd_len, max);
+        if (dist == 0 || dist > max) {
+            continue;
+        }
+
+        /* Keep the best names in distance order, earlier registered one wins on equal distance */
+        for (pos = num; pos > 0 && best_dist[pos - 1] > dist; --pos) {}
+        if (num < MICROSH_ARRAYSIZE(best)) {
+            ++num;
+        }
+        for (size_t k = num - 1; k > pos; --k) {
+            best[k] = best[k - 1];
+            best_dist[k] = best_dist[k - 1];
+        }
+        best[pos] = cmd_name;
+        best_dist[pos] = dist;
+
+        /* Only better names may replace the worst one of full list, nothing is better than `1` */
+        if (num == MICROSH_ARRAYSIZE(best)) {
+            if (best_dist[num - 1] <= 1) {
+                break;
+            }
+            max = best_dist[num - 1] - 1;
+        }
+    }
+
+    if (num > 0) {
+        mrl->out_fn(mrl, "Did you mean: ");
+        for (size_t i = 0; i < num; ++i) {
+            mrl->out_fn(mrl, best[i]);
+            mrl->out_fn(mrl, i + 1 < num ? ", " : "?" MICRORL_CFG_END_LINE);
+        }
+    }
+}
+#endif /* MICROSH_CFG_CMD_SUGGEST */
+
+#if MICROSH_USE_STR_HASH
+/**
+ * \brief           Calculate FNV-1a hash of string
+ * \param[in]       str: String to hash
+ * \return          String hash
+ */
+uint32_t microsh_str_hash(const char* str) {
+    uint32_t hash = 2166136261u;
+
+    while (*str != '\0') {
+        hash = (hash ^ (uint8_t)*str++) * 16777619u;
+    }
+
+    return hash;
+}
+#endif /* MICROSH_USE_STR_HASH */
+
+#if MICROSH_USE_LINE_PACK
+/**
+ * \brief           Split command line by spaces to tokens, each one is terminated with `\0`
+ * \param[out]      buf: Buffer for tokens
+ * \param[in]       size: Size of buffer
+ * \param[in]       line: Command line
+ * \return          Number of tokens, `0` for empty line, `-1` if tokens do not fit to
+ *                      buffer or their number is more than \ref MICRORL_CFG_CMD_TOKEN_NMB
+ */
+int microsh_line_pack(char* buf, size_t size, const char* line) {
+    size_t len = 0;
+    int argc = 0;
+
+    for (const char* p = line; *p != '\0'; ++p) {
+        if (*p == ' ') {
+            continue;
+        }
+        if (len + 2 > size) {
+            return -1;
+        }
+        if (p == line || p[-1] == ' ') {
+            ++argc;
+        }
+        buf[len++] = *p;
+        if (p[1] == ' ' || p[1] == '\0') {
+            buf[len++] = '\0';
+        }
+    }
+
+    return argc > MICRORL_CFG_CMD_TOKEN_NMB ? -1 : argc;
+}
+
+/**
+ * \brief           Get pointers to tokens of \ref microsh_line_pack
+ * \param[in]       buf: Packed tokens
+ * \param[in]       argc: Number of tokens
+ * \param[out]      argv: Array of at least `argc` token pointers
+ */
+void microsh_line_unpack(const char* buf, int argc, const char** argv) {
+    for (int i = 0; i < argc; ++i) {
+        argv[i] = buf;
+        buf += strlen(buf) + 1;
+    }
+}
+#endif /* MICROSH_USE_LINE_PACK */
+
+/**
+ * \brief           Makes decimal ascii string from `unsigned 64-bit` value
+ * \param[in]       val: Value to convert
+ * \param[out]      str: Minimum `21-bytes` long array to write value to
+ * \return          Pointer to `str`
+ */
+char* microsh_u64_to_str(uint64_t val, char* str) {
+    char tmp[20];
+    size_t n = 0;
+
+    do {
+        tmp[n++] = (char)('0' + (val % 10));
+        val /= 10;
+    } while (val > 0);
+
+    for (size_t i = 0; i < n; ++i) {
+        str[i] = tmp[n - i - 1];
+    }
+    str[n] = '\0';
+
+    return str;
+}
+
+#if MICROSH_CFG_LOG_MSG_IDS
+/**
+ * \brief           Print message identifier instead of message string
+ * \param[in]       mrl: \ref microrl_t working instance
+ * \param[in]       lvl: Message log level, one of `MICROSH_LOG_LEVEL_x` values
+ * \param[in]       id: Message identifier, member of \ref microsh_msg_t
+ */
+void microsh_msg_id_print(microrl_t* mrl, int lvl, microsh_msg_t id) {
+    char str[4 + 20 + sizeof(MICRORL_CFG_END_LINE)] = {"?EWI"[lvl & 0x03], '#'};
+
+    microsh_u64_to_str((uint64_t)id, &str[2]);
+    strcat(str, MICRORL_CFG_END_LINE);
+    mrl->out_fn(mrl, str);
+}
+#endif /* MICROSH_CFG_LOG_MSG_IDS */
+
 /**
  * \brief           Hook called after command execution
  * \param[in,out]   mrl: \ref microrl_t working instance
@@ -380,27 +1935,267 @@ static int prv_execute(microrl_t* mrl, int argc, const char* const *argv) {
  * \param[in]       argv: Pointer to argument list
  */
 void post_exec_hook(microrl_t* mrl, int res, int argc, const char* const *argv) {
-    MICROSH_UNUSED(argc);
+#if MICROSH_CFG_CMD_SEQUENCE
+    microsh_t* msh = MICROSH_FROM_MRL(mrl);
+
+    /* Commands of sequence are reported by themselves */
+    if (msh->seq_printed) {
+        msh->seq_printed = 0;
+        return;
+    }
+#endif /* MICROSH_CFG_CMD_SEQUENCE */
+    prv_exec_result_print(mrl, res, argc > 0 ? argv[0] : "");
+}
+
+#if MICROSH_CFG_WATCH
+/**
+ * \brief           Run watched command if its time has come
+ * \param[in,out]   msh: microSH instance
+ * \param[in]       next: Time to the nearest deadline of other timeouts
+ * \return          Time to the nearest deadline including the next run
+ */
+static uint32_t prv_watch_tick(microsh_t* msh, uint32_t next) {
+    microsh_watch_t* w = &msh->watch;
+    microrl_t* mrl = w->mrl;
+
+    if (mrl == NULL) {
+        return next;
+    }
+
+    if ((int32_t)(msh->now_ms - w->next_ms) >= 0) {
+#if MICROSH_CFG_CONSOLE_SESSIONS && MICROSH_CFG_SESSION_IDLE_TIMEOUT
+        /* Watched command does not keep session alive */
+        uint32_t last_activity = prv_status(msh, mrl)->last_activity;
+#endif /* MICROSH_CFG_CONSOLE_SESSIONS && MICROSH_CFG_SESSION_IDLE_TIMEOUT */
+        int res;
+
+        /* Missed runs are skipped if shell was not ticked for a long time */
+        w->next_ms += w->period_ms;
+        if ((int32_t)(msh->now_ms - w->next_ms) >= 0) {
+            w->next_ms = msh->now_ms + w->period_ms;
+        }
+
+        microsh_watch_frame_begin(w);
+        res = prv_execute(mrl, w->argc, w->argv);
+        post_exec_hook(mrl, res, w->argc, w->argv);
+        microsh_watch_frame_end(w);
+#if MICROSH_CFG_CONSOLE_SESSIONS && MICROSH_CFG_SESSION_IDLE_TIMEOUT
+        prv_status(msh, mrl)->last_activity = last_activity;
+#endif /* MICROSH_CFG_CONSOLE_SESSIONS && MICROSH_CFG_SESSION_IDLE_TIMEOUT */
+        if (w->mrl == NULL) {
+            return next;
+        }
+    }
+
+    return w->next_ms - msh->now_ms < next ? w->next_ms - msh->now_ms : next;
+}
+#endif /* MICROSH_CFG_WATCH */
+
+#if MICROSH_CFG_SCHED
+/**
+ * \brief           Run scheduled jobs which time has come
+ * \param[in,out]   msh: microSH instance
+ * \param[in]       next: Time to the nearest deadline of other timeouts
+ * \return          Time to the nearest deadline including scheduled jobs
+ */
+static uint32_t prv_sched_tick(microsh_t* msh, uint32_t next) {
+    microsh_sched_t* sched = &msh->sched;
+    microsh_sched_job_t* job;
+    uint32_t deadline;
+
+    microsh_sched_advance(sched, msh->now_ms);
+    while ((job = microsh_sched_pop(sched)) != NULL) {
+        microrl_t* mrl = job->mrl != NULL ? job->mrl : &msh->mrl;
+        uint32_t last_activity = prv_bg_begin(msh, mrl);
+
+#if MICROSH_CFG_SCRIPT
+        if (job->script != NULL) {
+            const char* failed_cmd = "";
+            int res;
+
+#if MICROSH_CFG_TERMINALS
+            msh->cur_mrl = mrl == &msh->mrl ? NULL : mrl;
+#endif /* MICROSH_CFG_TERMINALS */
+            res = microsh_script_run(msh, job->script, &failed_cmd);
+#if MICROSH_CFG_TERMINALS
+            msh->cur_mrl = NULL;
+#endif /* MICROSH_CFG_TERMINALS */
+            prv_exec_result_print(mrl, res, failed_cmd);
+        } else
+#endif /* MICROSH_CFG_SCRIPT */
+        {
+            int argc = (int)job->argc;
+
+            microsh_line_unpack(job->line, argc, sched->argv);
+            post_exec_hook(mrl, prv_execute(mrl, argc, sched->argv), argc, sched->argv);
+        }
+        prv_bg_end(msh, mrl, last_activity);
+        microsh_sched_done(sched, job);
+    }
+
+    deadline = microsh_sched_deadline(sched, msh->now_ms);
+
+    return deadline < next ? deadline : next;
+}
+#endif /* MICROSH_CFG_SCHED */
 
-#if MICROSH_CFG_LOGGING_CMD_EXEC_RESULT
+#if MICROSH_CFG_EVENTS
+/**
+ * \brief           Run commands bound to posted events
+ * \note            Number of events dispatched at once is limited by queue length,
+ *                      so events posted by bound commands do not hold shell
+ * \param[in,out]   msh: microSH instance
+ * \param[in]       next: Time to the nearest deadline of other timeouts
+ * \return          `0` if more events are waiting, `next` otherwise
+ */
+static uint32_t prv_event_tick(microsh_t* msh, uint32_t next) {
+    microsh_events_t* ev = &msh->events;
+    uint16_t id;
+
+    for (size_t n = 0; n < MICROSH_CFG_EVENT_QUEUE_LEN && microsh_event_pop(ev, &id); ++n) {
+        for (size_t i = 0; i < MICROSH_ARRAYSIZE(ev->binds); ++i) {
+            microsh_event_bind_t* b = &ev->binds[i];
+            microrl_t* mrl;
+            uint32_t last_activity;
+            int argc = (int)b->argc;
+
+            if (argc == 0 || b->id != id) {
+                continue;
+            }
+
+            /* Bound command may change bindings while it runs */
+            mrl = b->mrl != NULL ? b->mrl : &msh->mrl;
+            memcpy(ev->run_line, b->line, sizeof(ev->run_line));
+            microsh_line_unpack(ev->run_line, argc, ev->argv);
+
+            last_activity = prv_bg_begin(msh, mrl);
+            post_exec_hook(mrl, prv_execute(mrl, argc, ev->argv), argc, ev->argv);
+            prv_bg_end(msh, mrl, last_activity);
+        }
+    }
+
+    return microsh_event_pending(ev) ? 0 : next;
+}
+#endif /* MICROSH_CFG_EVENTS */
+
+#if MICROSH_CFG_SCHED || MICROSH_CFG_EVENTS
+/**
+ * \brief           Prepare terminal to run command not entered by user
+ * \note            Output is printed above the line being edited, the line is cleared
+ * \param[in,out]   msh: microSH instance
+ * \param[in]       mrl: \ref microrl_t working instance of terminal
+ * \return          Last activity time of terminal session to restore it
+ */
+static uint32_t prv_bg_begin(microsh_t* msh, microrl_t* mrl) {
+    mrl->out_fn(mrl, "\r\033[K");
+
+#if MICROSH_CFG_CONSOLE_SESSIONS && MICROSH_CFG_SESSION_IDLE_TIMEOUT
+    return prv_status(msh, mrl)->last_activity;
+#else
+    MICROSH_UNUSED(msh);
+
+    return 0;
+#endif /* MICROSH_CFG_CONSOLE_SESSIONS && MICROSH_CFG_SESSION_IDLE_TIMEOUT */
+}
+
+/**
+ * \brief           Print prompt and the line being edited again after command run
+ * \note            Command not entered by user does not keep session alive
+ * \param[in,out]   msh: microSH instance
+ * \param[in]       mrl: \ref microrl_t working instance of terminal
+ * \param[in]       last_activity: Value returned by \ref prv_bg_begin
+ */
+static void prv_bg_end(microsh_t* msh, microrl_t* mrl, uint32_t last_activity) {
+    char line[MICRORL_CFG_CMDLINE_LEN + 1];
+    size_t cmdlen = (size_t)mrl->cmdlen;
+#if MICROSH_CFG_CONSOLE_SESSIONS
+    uint8_t echo_off = prv_status(msh, mrl)->flags.passw_wait;
+#else
+    uint8_t echo_off = 0;
+
+    MICROSH_UNUSED(msh);
+#endif /* MICROSH_CFG_CONSOLE_SESSIONS */
+
+#if MICROSH_CFG_CONSOLE_SESSIONS && MICROSH_CFG_SESSION_IDLE_TIMEOUT
+    prv_status(msh, mrl)->last_activity = last_activity;
+#else
+    MICROSH_UNUSED(last_activity);
+#endif /* MICROSH_CFG_CONSOLE_SESSIONS && MICROSH_CFG_SESSION_IDLE_TIMEOUT */
+
+    for (size_t i = 0; i < cmdlen; ++i) {
+        line[i] = echo_off ? _ECHO_OFF_MASK : mrl->cmdline[i];
+    }
+    line[cmdlen] = '\0';
+
+    mrl->out_fn(mrl, mrl->prompt_str);
+    mrl->out_fn(mrl, line);
+    if ((size_t)mrl->cursor < cmdlen) {
+        char str[4 + 20] = "\033[";
+
+        microsh_u64_to_str(cmdlen - (size_t)mrl->cursor, &str[2]);
+        strcat(str, "D");
+        mrl->out_fn(mrl, str);
+    }
+}
+#endif /* MICROSH_CFG_SCHED || MICROSH_CFG_EVENTS */
+
+/**
+ * \brief           Print error result of command execution
+ * \param[in]       mrl: \ref microrl_t working instance
+ * \param[in]       res: Execution result
+ * \param[in]       name: Command name as entered
+ */
+static void prv_exec_result_print(microrl_t* mrl, int res, const char* name) {
+    MICROSH_UNUSED(mrl);
+    MICROSH_UNUSED(res);
+    MICROSH_UNUSED(name);
+
+#if MICROSH_CFG_LOGGING_CMD_EXEC_RESULT && MICROSH_CFG_LOG_LEVEL >= MICROSH_LOG_LEVEL_ERROR
     microsh_execr_t exec_res = (microsh_execr_t)res;
 
     if (exec_res > microshEXEC_ERROR) {
-        mrl->out_fn(mrl, argv[0]);
+        mrl->out_fn(mrl, name);
         mrl->out_fn(mrl, ": ");
 
         switch (exec_res) {
             case microshEXEC_ERROR_UNK_CMD: {
-                mrl->out_fn(mrl, "Unknown command"MICRORL_CFG_END_LINE);
+                MICROSH_MSG(mrl, MICROSH_LOG_LEVEL_ERROR, microshMSG_UNK_CMD, "Unknown command");
+#if MICROSH_CFG_CMD_SUGGEST
+                prv_suggest(MICROSH_FROM_MRL(mrl), mrl, name);
+#endif /* MICROSH_CFG_CMD_SUGGEST */
                 break;
             }
             case microshEXEC_ERROR_MAX_ARGS: {
-                mrl->out_fn(mrl, "Too many arguments"MICRORL_CFG_END_LINE);
+                MICROSH_MSG(mrl, MICROSH_LOG_LEVEL_ERROR, microshMSG_MAX_ARGS, "Too many arguments");
+                break;
+            }
+            case microshEXEC_ERROR_FEW_ARGS: {
+                MICROSH_MSG(mrl, MICROSH_LOG_LEVEL_ERROR, microshMSG_FEW_ARGS, "Too few arguments");
+                break;
+            }
+            case microshEXEC_ERROR_BAD_ARG: {
+                MICROSH_MSG(mrl, MICROSH_LOG_LEVEL_ERROR, microshMSG_BAD_ARG, "Invalid argument");
+                break;
+            }
+            case microshEXEC_ERROR_UNK_SUBCMD: {
+                MICROSH_MSG(mrl, MICROSH_LOG_LEVEL_ERROR, microshMSG_UNK_SUBCMD, "Unknown subcommand");
+                break;
+            }
+            case microshEXEC_ERROR_AMBIG_CMD: {
+                MICROSH_MSG(mrl, MICROSH_LOG_LEVEL_ERROR, microshMSG_AMBIG_CMD, "Ambiguous command");
+                break;
+            }
+            case microshEXEC_ERROR_BAD_PIPE: {
+                MICROSH_MSG(mrl, MICROSH_LOG_LEVEL_ERROR, microshMSG_BAD_PIPE, "Invalid pipe filter");
+                break;
+            }
+            case microshEXEC_ERROR_EXPAND: {
+                MICROSH_MSG(mrl, MICROSH_LOG_LEVEL_ERROR, microshMSG_EXPAND, "Too long line after expansion");
                 break;
             }
             default:
                 break;
         }
     }
-#endif /* MICROSH_CFG_LOGGING_CMD_EXEC_RESULT */
+#endif /* MICROSH_CFG_LOGGING_CMD_EXEC_RESULT && MICROSH_CFG_LOG_LEVEL >= MICROSH_LOG_LEVEL_ERROR */
 }
@@ -0,0 +1,544 @@
+/**
+ * \file            microsh_alias.c
+ * \brief           microSH command aliases
+ */
+
+/*
+ * Copyright (c) 2022 Dmitry KARASEV
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * This file is part of microSH - Shell for Embedded Systems library.
+ *
+ * Author:          Dmitry KARASEV <karasevsdmitry@yandex.ru>
+ * Version:         2.0.0-dev
+ */
+
+#include <stdint.h>
+#include <string.h>
+#include "microsh.h"
+#include "microsh_priv.h"
+
+#if MICROSH_CFG_ALIASES
+
+#if MICROSH_CFG_CMD_SEQUENCE
+#define _IS_SEQ_OP(token)           (microsh_seq_op(token) != '\0')
+#else
+#define _IS_SEQ_OP(token)           0
+#endif /* MICROSH_CFG_CMD_SEQUENCE */
+
+static uint8_t prv_name_valid(const char* name);
+static size_t  prv_slot_find(microsh_aliases_t* al, const char* name);
+static void    prv_index_insert(microsh_aliases_t* al, uint16_t offset);
+static void    prv_remove(microsh_aliases_t* al, size_t slot);
+static microshr_t prv_save(microsh_aliases_t* al);
+static int     prv_push(microsh_aliases_t* al, int* n, const char* token);
+static int     prv_subst(microsh_aliases_t* al, const char* body, int argc, const char* const *argv, int* n, size_t* len);
+
+/**
+ * \brief           Set aliases persistent storage and load saved aliases
+ * \note            Current aliases are replaced with loaded ones. They are cleared
+ *                      if stored image is damaged
+ * \param[in,out]   msh: microSH instance
+ * \param[in]       storage: Persistent storage, `NULL` to stop saving aliases
+ * \return          \ref microshOK on success, \ref microshERR if image cannot be loaded,
+ *                      member of \ref microshr_t otherwise
+ */
+microshr_t microsh_alias_set_storage(microsh_t* msh, const microsh_alias_storage_t* storage) {
+    microsh_aliases_t* al;
+    size_t len = 0;
+
+    if (msh == NULL || (storage != NULL && (storage->load_fn == NULL || storage->save_fn == NULL))) {
+        return microshERRPAR;
+    }
+
+    al = &msh->aliases;
+    al->storage = storage;
+    if (storage == NULL) {
+        return microshOK;
+    }
+
+    memset(al->slots, 0x00, sizeof(al->slots));
+    al->num = 0;
+    al->arena_len = 0;
+    if (storage->load_fn(storage->ctx, al->arena, sizeof(al->arena), &len) != microshOK
+            || len > sizeof(al->arena)) {
+        return microshERR;
+    }
+
+    /* Image is checked entry by entry, index is built again */
+    while (al->arena_len < len) {
+        const char* name = &al->arena[al->arena_len];
+        const char* body = memchr(name, '\0', len - al->arena_len);
+        const char* end = NULL;
+
+        if (body != NULL && ++body < &al->arena[len] && *body != '\0') {
+            end = memchr(body, '\0', (size_t)(&al->arena[len] - body));
+        }
+        if (end == NULL || !prv_name_valid(name) || al->slots[prv_slot_find(al, name)] != 0
+                || al->num >= MICROSH_ARRAYSIZE(al->slots) - 1) {
+            memset(al->slots, 0x00, sizeof(al->slots));
+            al->num = 0;
+            al->arena_len = 0;
+            return microshERR;
+        }
+        prv_index_insert(al, al->arena_len);
+        al->arena_len = (uint16_t)(end + 1 - al->arena);
+    }
+
+    return microshOK;
+}
+
+/**
+ * \brief           Define alias or replace its body
+ * \param[in,out]   msh: microSH instance
+ * \param[in]       name: Alias name of letters, digits, `_`, `-` and `.`
+ * \param[in]       body: Command line alias is replaced with. It may hold several commands
+ *                      and `$1`..`$9`, `$*` positional parameters
+ * \return          \ref microshOK on success, \ref microshERRMEM if there is no free space,
+ *                      \ref microshERRPAR on wrong name or empty body, result of storage
+ *                      save function otherwise
+ */
+microshr_t microsh_alias_set(microsh_t* msh, const char* name, const char* body) {
+    microsh_aliases_t* al;
+    size_t slot, name_len, body_len, old_len = 0;
+
+    if (msh == NULL || body == NULL || *body == '\0' || !prv_name_valid(name)) {
+        return microshERRPAR;
+    }
+
+    al = &msh->aliases;
+    name_len = strlen(name) + 1;
+    body_len = strlen(body) + 1;
+    slot = prv_slot_find(al, name);
+    if (al->slots[slot] != 0) {
+        const char* old = &al->arena[al->slots[slot] - 1];
+
+        old_len = name_len + strlen(old + name_len) + 1;
+    } else if (al->num >= MICROSH_ARRAYSIZE(al->slots) - 1) {
+        /* Keep one slot free to stop probing */
+        return microshERRMEM;
+    }
+    if (al->arena_len - old_len + name_len + body_len > sizeof(al->arena)) {
+        return microshERRMEM;
+    }
+
+    /* Replaced alias is moved to the end of arena */
+    if (old_len > 0) {
+        prv_remove(al, slot);
+    }
+    memcpy(&al->arena[al->arena_len], name, name_len);
+    memcpy(&al->arena[al->arena_len + name_len], body, body_len);
+    prv_index_insert(al, al->arena_len);
+    al->arena_len = (uint16_t)(al->arena_len + name_len + body_len);
+
+    return prv_save(al);
+}
+
+/**
+ * \brief           Get alias body
+ * \param[in]       msh: microSH instance
+ * \param[in]       name: Alias name
+ * \return          Alias body, `NULL` if alias is not defined
+ */
+const char* microsh_alias_get(microsh_t* msh, const char* name) {
+    size_t slot;
+    const char* entry;
+
+    if (msh == NULL || !prv_name_valid(name)) {
+        return NULL;
+    }
+
+    slot = prv_slot_find(&msh->aliases, name);
+    if (msh->aliases.slots[slot] == 0) {
+        return NULL;
+    }
+    entry = &msh->aliases.arena[msh->aliases.slots[slot] - 1];
+
+    return entry + strlen(entry) + 1;
+}
+
+/**
+ * \brief           Delete alias
+ * \param[in,out]   msh: microSH instance
+ * \param[in]       name: Alias name
+ * \return          \ref microshOK on success, \ref microshERR if alias is not defined,
+ *                      \ref microshERRPAR on wrong name, result of storage save function otherwise
+ */
+microshr_t microsh_alias_unset(microsh_t* msh, const char* name) {
+    size_t slot;
+
+    if (msh == NULL || !prv_name_valid(name)) {
+        return microshERRPAR;
+    }
+
+    slot = prv_slot_find(&msh->aliases, name);
+    if (msh->aliases.slots[slot] == 0) {
+        return microshERR;
+    }
+    prv_remove(&msh->aliases, slot);
+
+    return prv_save(&msh->aliases);
+}
+
+/**
+ * \brief           Replace aliases at the beginning of commands with their bodies
+ * \note            Alias is looked up once per command of line, so aliases in
+ *                      bodies are not expanded and alias may call command of the same name.
+ *                      Arguments of command up to the first `|` token are positional
+ *                      parameters. They are appended to body without `$1`..`$9` and `$*`
+ * \param[in,out]   msh: microSH instance
+ * \param[in,out]   argc: Number of arguments
+ * \param[in,out]   argv: Pointer to arguments, it is replaced with pointer to expanded
+ *                      arguments valid until the next call if line has alias
+ * \return          \ref microshEXEC_OK on success, \ref microshEXEC_ERROR_EXPAND if
+ *                      expanded line does not fit buffers
+ */
+int microsh_alias_expand(microsh_t* msh, int* argc, const char* const **argv) {
+    microsh_aliases_t* al = &msh->aliases;
+    const char* const *in = *argv;
+    size_t len = 0;
+    int n = 0, start = 0, res = microshEXEC_OK;
+    uint8_t found = 0;
+
+    if (al->num == 0) {
+        return microshEXEC_OK;
+    }
+
+    for (int i = 0; i <= *argc && res == microshEXEC_OK; ++i) {
+        const char* body = NULL;
+
+        if (i < *argc && !_IS_SEQ_OP(in[i])) {
+            continue;
+        }
+
+        if (i > start) {
+            size_t slot = prv_slot_find(al, in[start]);
+
+            if (al->slots[slot] != 0) {
+                body = &al->arena[al->slots[slot] - 1];
+                body += strlen(body) + 1;
+            }
+        }
+        if (body != NULL) {
+            int pipe = start + 1;
+
+            while (pipe < i && !(in[pipe][0] == '|' && in[pipe][1] == '\0')) {
+                ++pipe;
+            }
+            res = prv_subst(al, body, pipe - start - 1, &in[start + 1], &n, &len);
+            for (int j = pipe; j < i && res == microshEXEC_OK; ++j) {
+                res = prv_push(al, &n, in[j]);
+            }
+            found = 1;
+        } else {
+            for (int j = start; j < i && res == microshEXEC_OK; ++j) {
+                res = prv_push(al, &n, in[j]);
+            }
+        }
+        if (i < *argc && res == microshEXEC_OK) {
+            res = prv_push(al, &n, in[i]);
+        }
+        start = i + 1;
+    }
+
+    if (res == microshEXEC_OK && found) {
+        *argc = n;
+        *argv = al->argv;
+    }
+
+    return res;
+}
+
+/**
+ * \brief           Built-in command to define and print aliases
+ *
+ * `alias` prints all aliases, `alias NAME` prints one alias and
+ * `alias NAME BODY...` defines alias. Quote body holding `;`, `&&`, `||` or `|`
+ * \note            Register it with \ref microsh_cmd_register using
+ *                      \ref MICRORL_CFG_CMD_TOKEN_NMB as maximum number of arguments
+ * \param[in]       msh: microSH instance
+ * \param[in]       argc: argument count
+ * \param[in]       argv: pointer array to token string
+ * \return          \ref microshEXEC_OK on success, member of
+ *                      \ref microsh_execr_t enumeration otherwise
+ */
+int microsh_alias_cmd(microsh_t* msh, int argc, const char* const *argv) {
+    microsh_aliases_t* al = &msh->aliases;
+    microrl_t* mrl = microsh_get_mrl(msh);
+
+    if (argc < 3) {
+        const char* name = argc == 2 ? argv[1] : NULL;
+        uint8_t printed = 0;
+
+        for (size_t off = 0; off < al->arena_len;) {
+            const char* entry = &al->arena[off];
+            const char* body = entry + strlen(entry) + 1;
+
+            if (name == NULL || strcmp(name, entry) == 0) {
+                mrl->out_fn(mrl, "alias ");
+                mrl->out_fn(mrl, entry);
+                mrl->out_fn(mrl, " \"");
+                mrl->out_fn(mrl, body);
+                mrl->out_fn(mrl, "\""MICRORL_CFG_END_LINE);
+                printed = 1;
+            }
+            off = (size_t)(body - al->arena) + strlen(body) + 1;
+        }
+
+        return name == NULL || printed ? microshEXEC_OK : microshEXEC_ERROR;
+    } else {
+        char body[MICROSH_CFG_ALIAS_ARENA_LEN];
+        size_t len = 0;
+
+        /* Body tokens are joined with single spaces */
+        for (int i = 2; i < argc; ++i) {
+            size_t tok_len = strlen(argv[i]);
+
+            if (len + tok_len + 1 > sizeof(body)) {
+                return microshEXEC_ERROR;
+            }
+            memcpy(&body[len], argv[i], tok_len);
+            len += tok_len;
+            body[len++] = i + 1 < argc ? ' ' : '\0';
+        }
+
+        switch (microsh_alias_set(msh, argv[1], body)) {
+            case microshOK:
+                return microshEXEC_OK;
+            case microshERRPAR:
+                return microshEXEC_ERROR_BAD_ARG;
+            default:
+                return microshEXEC_ERROR;
+        }
+    }
+}
+
+/**
+ * \brief           Built-in command to delete alias: `unalias NAME`
+ * \note            Register it with \ref microsh_cmd_register using `2` as maximum
+ *                      number of arguments
+ * \param[in]       msh: microSH instance
+ * \param[in]       argc: argument count
+ * \param[in]       argv: pointer array to token string
+ * \return          \ref microshEXEC_OK on success, member of
+ *                      \ref microsh_execr_t enumeration otherwise
+ */
+int microsh_alias_unset_cmd(microsh_t* msh, int argc, const char* const *argv) {
+    if (argc < 2) {
+        return microshEXEC_ERROR_FEW_ARGS;
+    }
+
+    switch (microsh_alias_unset(msh, argv[1])) {
+        case microshOK:
+            return microshEXEC_OK;
+        case microshERRPAR:
+            return microshEXEC_ERROR_BAD_ARG;
+        default:
+            return microshEXEC_ERROR;
+    }
+}
+
+/**
+ * \brief           Check alias name
+ * \param[in]       name: Alias name
+ * \return          `1` if name is not empty, fits arena entry and has letters,
+ *                      digits, `_`, `-` and `.` only, `0` otherwise
+ */
+static uint8_t prv_name_valid(const char* name) {
+    size_t len = 0;
+
+    if (name == NULL) {
+        return 0;
+    }
+    for (; name[len] != '\0'; ++len) {
+        char c = name[len];
+
+        if (len >= MICROSH_CFG_ALIAS_NAME_LEN - 1
+                || !((c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9')
+                    || c == '_' || c == '-' || c == '.')) {
+            return 0;
+        }
+    }
+
+    return len > 0;
+}
+
+/**
+ * \brief           Find slot of alias
+ * \param[in]       al: Aliases context
+ * \param[in]       name: Alias name
+ * \return          Slot of alias, free slot to insert alias to if it is not defined
+ */
+static size_t prv_slot_find(microsh_aliases_t* al, const char* name) {
+    size_t slot = microsh_str_hash(name) % MICROSH_ARRAYSIZE(al->slots);
+
+    /* Table always has free slot, so probing stops */
+    while (al->slots[slot] != 0 && strcmp(&al->arena[al->slots[slot] - 1], name) != 0) {
+        slot = (slot + 1) % MICROSH_ARRAYSIZE(al->slots);
+    }
+
+    return slot;
+}
+
+/**
+ * \brief           Add arena entry to hash table
+ * \param[in,out]   al: Aliases context
+ * \param[in]       offset: Arena offset of entry which name is not in table
+ */
+static void prv_index_insert(microsh_aliases_t* al, uint16_t offset) {
+    al->slots[prv_slot_find(al, &al->arena[offset])] = (uint16_t)(offset + 1);
+    ++al->num;
+}
+
+/**
+ * \brief           Remove alias from arena and hash table
+ * \param[in,out]   al: Aliases context
+ * \param[in]       slot: Used slot of alias
+ */
+static void prv_remove(microsh_aliases_t* al, size_t slot) {
+    size_t off = al->slots[slot] - 1, next, len;
+
+    len = strlen(&al->arena[off]) + 1;
+    len += strlen(&al->arena[off + len]) + 1;
+
+    /* Arena is kept compact, entries after removed one move back */
+    memmove(&al->arena[off], &al->arena[off + len], al->arena_len - off - len);
+    al->arena_len = (uint16_t)(al->arena_len - len);
+    for (size_t i = 0; i < MICROSH_ARRAYSIZE(al->slots); ++i) {
+        if (al->slots[i] > off + 1) {
+            al->slots[i] = (uint16_t)(al->slots[i] - len);
+        }
+    }
+
+    /* Shift the next entries of probe sequence back instead of using deleted marks */
+    next = slot;
+    while (1) {
+        size_t home;
+
+        next = (next + 1) % MICROSH_ARRAYSIZE(al->slots);
+        if (al->slots[next] == 0) {
+            break;
+        }
+
+        /* Entry may move back only if its home slot is not between freed slot and it */
+        home = microsh_str_hash(&al->arena[al->slots[next] - 1]) % MICROSH_ARRAYSIZE(al->slots);
+        if (slot <= next ? (home <= slot || home > next) : (home <= slot && home > next)) {
+            al->slots[slot] = al->slots[next];
+            slot = next;
+        }
+    }
+    al->slots[slot] = 0;
+    --al->num;
+}
+
+/**
+ * \brief           Save arena to persistent storage
+ * \param[in]       al: Aliases context
+ * \return          \ref microshOK on success or without storage, member of \ref microshr_t otherwise
+ */
+static microshr_t prv_save(microsh_aliases_t* al) {
+    if (al->storage == NULL) {
+        return microshOK;
+    }
+
+    return al->storage->save_fn(al->storage->ctx, al->arena, al->arena_len);
+}
+
+/**
+ * \brief           Append token to expanded line
+ * \param[in,out]   al: Aliases context
+ * \param[in,out]   n: Number of expanded tokens
+ * \param[in]       token: Token string
+ * \return          \ref microshEXEC_OK on success, \ref microshEXEC_ERROR_EXPAND if
+ *                      there are too many tokens
+ */
+static int prv_push(microsh_aliases_t* al, int* n, const char* token) {
+    if (*n >= (int)MICROSH_ARRAYSIZE(al->argv)) {
+        return microshEXEC_ERROR_EXPAND;
+    }
+    al->argv[(*n)++] = token;
+
+    return microshEXEC_OK;
+}
+
+/**
+ * \brief           Split alias body to tokens and substitute positional parameters
+ * \param[in,out]   al: Aliases context
+ * \param[in]       body: Alias body
+ * \param[in]       argc: Number of positional parameters
+ * \param[in]       argv: Positional parameters
+ * \param[in,out]   n: Number of expanded tokens
+ * \param[in,out]   len: Used length of expanded tokens buffer
+ * \return          \ref microshEXEC_OK on success, \ref microshEXEC_ERROR_EXPAND if
+ *                      expanded line does not fit buffers
+ */
+static int prv_subst(microsh_aliases_t* al, const char* body, int argc, const char* const *argv, int* n, size_t* len) {
+    int res = microshEXEC_OK;
+    uint8_t used = 0;
+
+    while (*body != '\0' && res == microshEXEC_OK) {
+        size_t start = *len;
+
+        if (*body == ' ') {
+            ++body;
+            continue;
+        }
+
+        /* All parameters keep their own tokens */
+        if (body[0] == '$' && body[1] == '*' && (body[2] == ' ' || body[2] == '\0')) {
+            for (int i = 0; i < argc && res == microshEXEC_OK; ++i) {
+                res = prv_push(al, n, argv[i]);
+            }
+            body += 2;
+            used = 1;
+            continue;
+        }
+
+        while (*body != '\0' && *body != ' ') {
+            const char* s = body;
+            size_t s_len = 1;
+
+            if (body[0] == '$' && body[1] >= '1' && body[1] <= '9') {
+                int i = body[1] - '1';
+
+                s = i < argc ? argv[i] : "";
+                s_len = strlen(s);
+                body += 2;
+                used = 1;
+            } else {
+                ++body;
+            }
+            if (*len + s_len >= sizeof(al->line)) {
+                return microshEXEC_ERROR_EXPAND;
+            }
+            memcpy(&al->line[*len], s, s_len);
+            *len += s_len;
+        }
+        al->line[(*len)++] = '\0';
+
+        /* Token of missing parameters only is removed */
+        if (al->line[start] != '\0') {
+            res = prv_push(al, n, &al->line[start]);
+        }
+    }
+
+    /* Body without parameters works as command prefix */
+    for (int i = 0; i < argc && !used && res == microshEXEC_OK; ++i) {
+        res = prv_push(al, n, argv[i]);
+    }
+
+    return res;
+}
+
+#endif /* MICROSH_CFG_ALIASES */
@@ -0,0 +1,171 @@
+/**
+ * \file            microsh_args.c
+ * \brief           microSH typed arguments schema
+ */
+
+/*
+ * Copyright (c) 2022 Dmitry KARASEV
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * This file is part of microSH - Shell for Embedded Systems library.
+ *
+ * Author:          Dmitry KARASEV <karasevsdmitry@yandex.ru>
+ * Version:         2.0.0-dev
+ */
+
+#include <stdint.h>
+#include <string.h>
+#include "microsh.h"
+
+#if MICROSH_CFG_ARG_SCHEMA
+
+static uint8_t prv_parse_u32(const char* str, uint32_t base, uint32_t* val);
+static uint8_t prv_parse_arg(const microsh_arg_t* arg, const char* str, microsh_arg_val_t* val);
+
+/**
+ * \brief           Validate and convert command arguments
+ * \param[in]       schema: Command arguments schema
+ * \param[in]       argc: Number of arguments including command name
+ * \param[in]       argv: Pointer to arguments
+ * \param[out]      vals: Array of at least `argc` converted arguments with
+ *                      the same indexes as in `argv`. Command name is not converted
+ * \return          \ref microshEXEC_OK on success, member of
+ *                      \ref microsh_execr_t enumeration otherwise
+ */
+int microsh_arg_parse(const microsh_arg_schema_t* schema, int argc, const char* const *argv,
+                        microsh_arg_val_t* vals) {
+    if (argc - 1 < (int)schema->min_num) {
+        return microshEXEC_ERROR_FEW_ARGS;
+    }
+    if (argc - 1 > (int)schema->num) {
+        return microshEXEC_ERROR_MAX_ARGS;
+    }
+
+    memset(vals, 0x00, (size_t)argc * sizeof(microsh_arg_val_t));
+    vals[0].str = argv[0];
+    for (int i = 1; i < argc; ++i) {
+        if (!prv_parse_arg(&schema->args[i - 1], argv[i], &vals[i])) {
+            return microshEXEC_ERROR_BAD_ARG;
+        }
+    }
+
+    return microshEXEC_OK;
+}
+
+/**
+ * \brief           Convert string to unsigned 32-bit value
+ * \param[in]       str: String of digits only
+ * \param[in]       base: Numeric base, `10` or `16`
+ * \param[out]      val: Converted value
+ * \return          `1` on success, `0` on wrong digit or overflow
+ */
+static uint8_t prv_parse_u32(const char* str, uint32_t base, uint32_t* val) {
+    uint32_t v = 0;
+
+    if (*str == '\0') {
+        return 0;
+    }
+
+    for (; *str != '\0'; ++str) {
+        uint32_t d;
+
+        if (*str >= '0' && *str <= '9') {
+            d = (uint32_t)(*str - '0');
+        } else if (base == 16 && (*str | 0x20) >= 'a' && (*str | 0x20) <= 'f') {
+            d = (uint32_t)((*str | 0x20) - 'a' + 10);
+        } else {
+            return 0;
+        }
+
+        if (v > (UINT32_MAX - d) / base) {
+            return 0;
+        }
+        v = v * base + d;
+    }
+    *val = v;
+
+    return 1;
+}
+
+/**
+ * \brief           Validate and convert single argument
+ * \param[in]       arg: Argument descriptor
+ * \param[in]       str: Argument string
+ * \param[out]      val: Converted argument
+ * \return          `1` if argument is valid, `0` otherwise
+ */
+static uint8_t prv_parse_arg(const microsh_arg_t* arg, const char* str, microsh_arg_val_t* val) {
+    int64_t v;
+
+    val->str = str;
+
+    /* Keywords are allowed for all types */
+    if (arg->keywords != NULL) {
+        for (uint32_t i = 0; arg->keywords[i] != NULL; ++i) {
+            if (strcmp(arg->keywords[i], str) == 0) {
+                val->kw = i + 1;
+                return 1;
+            }
+        }
+    }
+
+    switch (arg->type) {
+        case microshARG_STR: {
+            v = (int64_t)strlen(str);
+            break;
+        }
+        case microshARG_U32: {
+            if (!prv_parse_u32(str, 10, &val->u32)) {
+                return 0;
+            }
+            v = val->u32;
+            break;
+        }
+        case microshARG_HEX: {
+            if (str[0] == '0' && (str[1] | 0x20) == 'x') {
+                str += 2;
+            }
+            if (!prv_parse_u32(str, 16, &val->u32)) {
+                return 0;
+            }
+            v = val->u32;
+            break;
+        }
+        case microshARG_I32: {
+            uint32_t u;
+            uint8_t neg = str[0] == '-';
+
+            if (str[0] == '-' || str[0] == '+') {
+                ++str;
+            }
+            if (!prv_parse_u32(str, 10, &u) || u > (neg ? (uint32_t)INT32_MAX + 1 : (uint32_t)INT32_MAX)) {
+                return 0;
+            }
+            v = neg ? -(int64_t)u : (int64_t)u;
+            val->i32 = (int32_t)v;
+            break;
+        }
+        default:
+            /* Enumeration value is not a keyword */
+            return 0;
+    }
+
+    if ((arg->min != 0 || arg->max != 0) && (v < arg->min || v > arg->max)) {
+        return 0;
+    }
+
+    return 1;
+}
+
+#endif /* MICROSH_CFG_ARG_SCHEMA */
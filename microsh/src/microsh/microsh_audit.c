@@ -0,0 +1,318 @@
+/**
+ * \file            microsh_audit.c
+ * \brief           microSH audit log
+ */
+
+/*
+ * Copyright (c) 2022 Dmitry KARASEV
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * This file is part of microSH - Shell for Embedded Systems library.
+ *
+ * Author:          Dmitry KARASEV <karasevsdmitry@yandex.ru>
+ * Version:         2.0.0-dev
+ */
+
+#include <stdint.h>
+#include <string.h>
+#include "microsh.h"
+#include "microsh_priv.h"
+
+#if MICROSH_CFG_AUDIT_LOG
+
+/* Number of record slots in storage sector */
+#define _AUDIT_RECS_PER_SECTOR(st)  ((st)->sector_size / sizeof(microsh_audit_rec_t))
+
+/* Number of record slots in whole storage ring */
+#define _AUDIT_SLOTS(st)            (_AUDIT_RECS_PER_SECTOR(st) * (st)->sector_num)
+
+static uint16_t prv_rec_chk(const microsh_audit_rec_t* rec);
+static uint32_t prv_slot_addr(const microsh_audit_storage_t* st, uint32_t slot);
+static uint8_t  prv_rec_read(const microsh_audit_storage_t* st, uint32_t slot, microsh_audit_rec_t* rec);
+
+/**
+ * \brief           Init audit log and find last written record in persistent storage
+ * \note            Call this function right after microsh_init(). Function scans
+ *                      first record of every sector and records of the newest sector only
+ * \param[in,out]   msh: microSH instance
+ * \param[in]       storage: Persistent storage interface. Must stay valid while shell is used
+ * \return          \ref microshOK on success, member of \ref microshr_t otherwise
+ */
+microshr_t microsh_audit_init(microsh_t* msh, const microsh_audit_storage_t* storage) {
+    microsh_audit_t* audit;
+    microsh_audit_rec_t rec;
+    uint32_t rps, newest_sector = 0, newest_seq = 0;
+    uint8_t found = 0;
+
+    if (msh == NULL || storage == NULL || storage->read_fn == NULL || storage->write_fn == NULL ||
+            storage->erase_fn == NULL || storage->sector_num < 2 ||
+            storage->sector_size < sizeof(microsh_audit_rec_t)) {
+        return microshERRPAR;
+    }
+
+    audit = &msh->audit;
+    memset(audit, 0x00, sizeof(microsh_audit_t));
+    rps = _AUDIT_RECS_PER_SECTOR(storage);
+
+    /* Find sector started with the newest record */
+    for (uint32_t i = 0; i < storage->sector_num; ++i) {
+        if (prv_rec_read(storage, i * rps, &rec)
+                && (!found || (int32_t)(rec.seq - newest_seq) > 0)) {
+            newest_sector = i;
+            newest_seq = rec.seq;
+            found = 1;
+        }
+    }
+
+    if (found) {
+        uint32_t i;
+
+        /* Find the end of continuous records sequence in the newest sector */
+        for (i = 1; i < rps; ++i) {
+            if (!prv_rec_read(storage, newest_sector * rps + i, &rec) || rec.seq != newest_seq + i) {
+                break;
+            }
+        }
+        audit->slot = (newest_sector * rps + i) % _AUDIT_SLOTS(storage);
+        audit->seq = newest_seq + i;
+    }
+    audit->storage = storage;
+
+    return microshOK;
+}
+
+/**
+ * \brief           Write all queued audit records to persistent storage
+ * \note            Call this function from idle loop or low priority task. It is the only
+ *                      audit function accessing storage, shell itself only queues records
+ * \param[in,out]   msh: microSH instance
+ * \return          \ref microshOK on success, member of \ref microshr_t otherwise
+ */
+microshr_t microsh_audit_flush(microsh_t* msh) {
+    microsh_audit_t* audit;
+    const microsh_audit_storage_t* st;
+    microsh_audit_rec_t rec;
+
+    if (msh == NULL || msh->audit.storage == NULL) {
+        return microshERRPAR;
+    }
+
+    audit = &msh->audit;
+    st = audit->storage;
+
+    while (audit->queue_r != audit->queue_w) {
+        rec = audit->queue[audit->queue_r % MICROSH_CFG_AUDIT_QUEUE_LEN];
+        rec.seq = audit->seq;
+        rec.reserved = 0xFFFF;
+        rec.chk = prv_rec_chk(&rec);
+
+        /* Erase sector only when write position enters it */
+        if (audit->slot % _AUDIT_RECS_PER_SECTOR(st) == 0
+                && st->erase_fn(st->ctx, prv_slot_addr(st, audit->slot)) != microshOK) {
+            return microshERR;
+        }
+        if (st->write_fn(st->ctx, prv_slot_addr(st, audit->slot), &rec, sizeof(rec)) != microshOK) {
+            return microshERR;
+        }
+
+        audit->slot = (audit->slot + 1) % _AUDIT_SLOTS(st);
+        ++audit->seq;
+        ++audit->queue_r;
+    }
+
+    return microshOK;
+}
+
+/**
+ * \brief           Read audit record from persistent storage
+ * \param[in]       msh: microSH instance
+ * \param[in]       n: Record number, `0` is the newest flushed record
+ * \param[out]      rec: Record to read to
+ * \return          \ref microshOK on success, \ref microshERR if record
+ *                      does not exist, member of \ref microshr_t otherwise
+ */
+microshr_t microsh_audit_read(microsh_t* msh, size_t n, microsh_audit_rec_t* rec) {
+    const microsh_audit_storage_t* st;
+    uint32_t slots;
+
+    if (msh == NULL || rec == NULL || msh->audit.storage == NULL) {
+        return microshERRPAR;
+    }
+
+    st = msh->audit.storage;
+    slots = _AUDIT_SLOTS(st);
+    if (n >= slots) {
+        return microshERR;
+    }
+
+    if (!prv_rec_read(st, (msh->audit.slot + slots - 1 - (uint32_t)n) % slots, rec)
+            || rec->seq != msh->audit.seq - 1 - (uint32_t)n) {
+        return microshERR;
+    }
+
+    return microshOK;
+}
+
+/**
+ * \brief           Get number of audit records dropped on queue overflow
+ * \param[in]       msh: microSH instance
+ * \return          Number of dropped records since audit log init
+ */
+size_t microsh_audit_get_dropped(microsh_t* msh) {
+    return msh != NULL ? msh->audit.dropped : 0;
+}
+
+/**
+ * \brief           Built-in command to print the newest audit records
+ * \note            Register it with \ref microsh_cmd_register using `2` as maximum
+ *                      number of arguments. Optional argument is number of records, default is `10`.
+ *                      Number of dropped records is printed first, if any
+ * \param[in]       msh: microSH instance
+ * \param[in]       argc: argument count
+ * \param[in]       argv: pointer array to token string
+ * \return          \ref microshEXEC_OK on success, member of
+ *                      \ref microsh_execr_t enumeration otherwise
+ */
+int microsh_audit_cmd(microsh_t* msh, int argc, const char* const *argv) {
+    static const char* const event_names[] = {
+        "?", "LOGIN_OK", "LOGIN_ERR_USER", "LOGIN_ERR_PASSW", "LOGOUT", "CMD_EXEC"
+    };
+    microrl_t* mrl = microsh_get_mrl(msh);
+    microsh_audit_rec_t rec;
+    char num_str[21];
+    size_t num = 0;
+
+    if (argc > 1) {
+        for (const char* p = argv[1]; *p != '\0'; ++p) {
+            if (*p < '0' || *p > '9') {
+                return microshEXEC_ERROR;
+            }
+            num = num * 10 + (size_t)(*p - '0');
+        }
+    } else {
+        num = 10;
+    }
+
+    /* Write pending records first to print actual log */
+    microsh_audit_flush(msh);
+
+    if (msh->audit.dropped > 0) {
+        mrl->out_fn(mrl, "dropped ");
+        mrl->out_fn(mrl, microsh_u64_to_str(msh->audit.dropped, num_str));
+        mrl->out_fn(mrl, MICRORL_CFG_END_LINE);
+    }
+
+    for (size_t i = 0; i < num && microsh_audit_read(msh, i, &rec) == microshOK; ++i) {
+        mrl->out_fn(mrl, "#");
+        mrl->out_fn(mrl, microsh_u64_to_str(rec.seq, num_str));
+        mrl->out_fn(mrl, " ");
+        mrl->out_fn(mrl, event_names[rec.event < MICROSH_ARRAYSIZE(event_names) ? rec.event : 0]);
+        mrl->out_fn(mrl, " type ");
+        mrl->out_fn(mrl, microsh_u64_to_str(rec.login_type, num_str));
+        if (rec.cmd_index != MICROSH_AUDIT_NO_CMD) {
+            mrl->out_fn(mrl, " cmd ");
+            mrl->out_fn(mrl, microsh_u64_to_str(rec.cmd_index, num_str));
+        }
+        mrl->out_fn(mrl, " res ");
+        mrl->out_fn(mrl, microsh_u64_to_str(rec.result, num_str));
+        mrl->out_fn(mrl, MICRORL_CFG_END_LINE);
+#if MICROSH_CFG_PIPES
+        /* Do not read storage for records dropped by pipe filters */
+        if (microsh_pipe_stopped(msh)) {
+            break;
+        }
+#endif /* MICROSH_CFG_PIPES */
+    }
+
+    return microshEXEC_OK;
+}
+
+/**
+ * \brief           Queue audit record for writing to persistent storage
+ * \note            Function never accesses storage. If queue is full, record is dropped
+ * \param[in,out]   msh: microSH instance
+ * \param[in]       event: Audit event type
+ * \param[in]       cmd_index: Registered command index or \ref MICROSH_AUDIT_NO_CMD
+ * \param[in]       result: Command execution result
+ */
+void microsh_audit_push(microsh_t* msh, microsh_audit_event_t event, size_t cmd_index, int result) {
+    microsh_audit_t* audit = &msh->audit;
+    microsh_audit_rec_t* rec;
+
+    if (audit->storage == NULL) {
+        return;
+    }
+
+    if (audit->queue_w - audit->queue_r >= MICROSH_CFG_AUDIT_QUEUE_LEN) {
+        ++audit->dropped;
+        return;
+    }
+
+    rec = &audit->queue[audit->queue_w % MICROSH_CFG_AUDIT_QUEUE_LEN];
+    rec->event = (uint8_t)event;
+    rec->cmd_index = (uint16_t)cmd_index;
+    rec->result = (uint8_t)result;
+#if MICROSH_CFG_CONSOLE_SESSIONS
+    rec->login_type = microsh_session_get_login_type(msh);
+#else
+    rec->login_type = 0;
+#endif /* MICROSH_CFG_CONSOLE_SESSIONS */
+    ++audit->queue_w;
+}
+
+/**
+ * \brief           Calculate Fletcher-16 check value of record
+ * \param[in]       rec: Audit record
+ * \return          Check value
+ */
+static uint16_t prv_rec_chk(const microsh_audit_rec_t* rec) {
+    const uint8_t* p = (const uint8_t*)rec;
+    uint16_t s1 = 0, s2 = 0;
+
+    for (size_t i = 0; i < offsetof(microsh_audit_rec_t, chk); ++i) {
+        s1 = (uint16_t)((s1 + p[i]) % 255);
+        s2 = (uint16_t)((s2 + s1) % 255);
+    }
+
+    return (uint16_t)((s2 << 8) | s1);
+}
+
+/**
+ * \brief           Get storage address of record slot
+ * \param[in]       st: Audit storage
+ * \param[in]       slot: Record slot in storage ring
+ * \return          Storage address
+ */
+static uint32_t prv_slot_addr(const microsh_audit_storage_t* st, uint32_t slot) {
+    uint32_t rps = _AUDIT_RECS_PER_SECTOR(st);
+
+    return (slot / rps) * st->sector_size + (slot % rps) * (uint32_t)sizeof(microsh_audit_rec_t);
+}
+
+/**
+ * \brief           Read record slot and check it
+ * \param[in]       st: Audit storage
+ * \param[in]       slot: Record slot in storage ring
+ * \param[out]      rec: Record to read to
+ * \return          `1` if slot contains valid record, `0` otherwise
+ */
+static uint8_t prv_rec_read(const microsh_audit_storage_t* st, uint32_t slot, microsh_audit_rec_t* rec) {
+    if (st->read_fn(st->ctx, prv_slot_addr(st, slot), rec, sizeof(*rec)) != microshOK) {
+        return 0;
+    }
+
+    return rec->seq != 0xFFFFFFFF && rec->chk == prv_rec_chk(rec) ? 1 : 0;
+}
+
+#endif /* MICROSH_CFG_AUDIT_LOG */
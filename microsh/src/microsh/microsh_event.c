@@ -0,0 +1,411 @@
+/**
+ * \file            microsh_event.c
+ * \brief           microSH commands bound to application events
+ */
+
+/*
+ * Copyright (c) 2022 Dmitry KARASEV
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * This file is part of microSH - Shell for Embedded Systems library.
+ *
+ * Author:          Dmitry KARASEV <karasevsdmitry@yandex.ru>
+ * Version:         2.0.0-dev
+ */
+
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#include "microsh.h"
+#include "microsh_priv.h"
+
+#if MICROSH_CFG_EVENTS
+
+#define _EVENT_QUEUE_MASK           (MICROSH_CFG_EVENT_QUEUE_LEN - 1)
+
+static const microsh_event_name_t shell_event_names[] = {
+    { MICROSH_EVENT_LOGIN,  "login" },
+    { MICROSH_EVENT_LOGOUT, "logout" },
+};
+
+static microshr_t prv_bind(microsh_t* msh, microrl_t* mrl, uint16_t id, const char* line, uint8_t* num);
+static uint8_t prv_id_parse(microsh_events_t* ev, const char* str, uint16_t* id);
+static const char* prv_id_name(microsh_events_t* ev, uint16_t id);
+
+/**
+ * \brief           Prepare events queue
+ * \param[in,out]   msh: microSH instance
+ */
+void microsh_event_init(microsh_t* msh) {
+    for (size_t i = 0; i < MICROSH_CFG_EVENT_QUEUE_LEN; ++i) {
+        msh->events.cells[i].seq = i;
+    }
+    msh->events.enq_pos = 0;
+    msh->events.deq_pos = 0;
+}
+
+/**
+ * \brief           Post event to run commands bound to it
+ * \note            Function is lock-free and may be called from interrupts and
+ *                      other tasks. It only reserves queue cell and writes identifier,
+ *                      bound commands are run by \ref microsh_tick
+ * \param[in,out]   msh: microSH instance
+ * \param[in]       id: Event identifier
+ * \return          \ref microshOK on success, \ref microshERRMEM if queue is full,
+ *                      member of \ref microshr_t otherwise
+ */
+microshr_t microsh_event_post(microsh_t* msh, uint16_t id) {
+    microsh_events_t* ev;
+    microsh_event_cell_t* cell;
+    size_t pos, seq;
+
+    if (msh == NULL) {
+        return microshERRPAR;
+    }
+
+    ev = &msh->events;
+    pos = MICROSH_CFG_ATOMIC_LOAD(&ev->enq_pos);
+
+    /* Reserve cell, competing with other producers */
+    while (1) {
+        cell = &ev->cells[pos & _EVENT_QUEUE_MASK];
+        seq = MICROSH_CFG_ATOMIC_LOAD(&cell->seq);
+
+        if (seq == pos) {
+            if (MICROSH_CFG_ATOMIC_CAS(&ev->enq_pos, &pos, pos + 1)) {
+                break;
+            }
+        } else if ((ptrdiff_t)(seq - pos) < 0) {
+            (void)MICROSH_CFG_ATOMIC_FETCH_ADD(&ev->dropped, 1);
+            return microshERRMEM;
+        } else {
+            pos = MICROSH_CFG_ATOMIC_LOAD(&ev->enq_pos);
+        }
+    }
+
+    cell->id = id;
+
+    /* Publish cell to consumer */
+    MICROSH_CFG_ATOMIC_STORE(&cell->seq, pos + 1);
+
+    return microshOK;
+}
+
+/**
+ * \brief           Set names of application events for `on` command
+ * \param[in,out]   msh: microSH instance
+ * \param[in]       names: Event names table. Must stay valid while shell is used.
+ *                      May be `NULL`
+ * \param[in]       num: Number of table entries
+ * \return          \ref microshOK on success, member of \ref microshr_t otherwise
+ */
+microshr_t microsh_event_set_names(microsh_t* msh, const microsh_event_name_t* names, size_t num) {
+    if (msh == NULL || (names == NULL && num > 0)) {
+        return microshERRPAR;
+    }
+
+    msh->events.names = names;
+    msh->events.names_num = num;
+
+    return microshOK;
+}
+
+/**
+ * \brief           Bind command line to event
+ * \note            Binding of application runs on own terminal of shell and is
+ *                      kept across log outs. Bindings of `on` command belong to
+ *                      their terminal and are removed at its log out
+ * \param[in,out]   msh: microSH instance
+ * \param[in]       id: Event identifier
+ * \param[in]       line: Command line with tokens separated by spaces
+ * \param[out]      num: Number of binding for \ref microsh_event_unbind. May be `NULL`
+ * \return          \ref microshOK on success, \ref microshERRMEM if no free binding or
+ *                      line does not fit to binding, member of \ref microshr_t otherwise
+ */
+microshr_t microsh_event_bind(microsh_t* msh, uint16_t id, const char* line, uint8_t* num) {
+    if (msh == NULL || line == NULL) {
+        return microshERRPAR;
+    }
+
+    return prv_bind(msh, NULL, id, line, num);
+}
+
+/**
+ * \brief           Remove event binding
+ * \param[in,out]   msh: microSH instance
+ * \param[in]       num: Number of binding
+ * \return          \ref microshOK on success, \ref microshERR if there is no such binding,
+ *                      member of \ref microshr_t otherwise
+ */
+microshr_t microsh_event_unbind(microsh_t* msh, uint8_t num) {
+    if (msh == NULL) {
+        return microshERRPAR;
+    }
+    if (num == 0 || num > MICROSH_CFG_EVENT_BINDINGS || msh->events.binds[num - 1].argc == 0) {
+        return microshERR;
+    }
+
+    msh->events.binds[num - 1].argc = 0;
+
+    return microshOK;
+}
+
+/**
+ * \brief           Built-in command to bind command to event: `on EVENT COMMAND...`
+ *
+ * `EVENT` is event name or decimal identifier. Quote command line holding
+ * `;`, `&&`, `||` or `|`. Without arguments bindings of terminal are printed.
+ * Command runs on terminal which bound it and is removed at its log out
+ * \note            Register it with \ref microsh_cmd_register using
+ *                      \ref MICRORL_CFG_CMD_TOKEN_NMB as maximum number of arguments
+ * \param[in]       msh: microSH instance
+ * \param[in]       argc: argument count
+ * \param[in]       argv: pointer array to token string
+ * \return          \ref microshEXEC_OK on success, member of
+ *                      \ref microsh_execr_t enumeration otherwise
+ */
+int microsh_event_on_cmd(microsh_t* msh, int argc, const char* const *argv) {
+    microsh_events_t* ev = &msh->events;
+    microrl_t* mrl = microsh_get_mrl(msh);
+    char num_str[21];
+
+    if (argc == 1) {
+        for (size_t i = 0; i < MICROSH_ARRAYSIZE(ev->binds); ++i) {
+            const microsh_event_bind_t* b = &ev->binds[i];
+            const char* name;
+            const char* token = b->line;
+
+            /* Bindings of application and other terminals are not shown */
+            if (b->argc == 0 || b->mrl != mrl) {
+                continue;
+            }
+
+            name = prv_id_name(ev, b->id);
+            mrl->out_fn(mrl, microsh_u64_to_str(i + 1, num_str));
+            mrl->out_fn(mrl, "\ton ");
+            mrl->out_fn(mrl, name != NULL ? name : microsh_u64_to_str(b->id, num_str));
+            mrl->out_fn(mrl, "\t");
+            for (uint8_t t = 0; t < b->argc; ++t) {
+                mrl->out_fn(mrl, t > 0 ? " " : "");
+                mrl->out_fn(mrl, token);
+                token += strlen(token) + 1;
+            }
+            mrl->out_fn(mrl, MICRORL_CFG_END_LINE);
+        }
+
+        return microshEXEC_OK;
+    } else if (argc == 2) {
+        return microshEXEC_ERROR_FEW_ARGS;
+    } else {
+        char line[MICROSH_CFG_EVENT_LINE_LEN];
+        size_t len = 0;
+        uint16_t id;
+        uint8_t num;
+
+        if (!prv_id_parse(ev, argv[1], &id)) {
+            return microshEXEC_ERROR_BAD_ARG;
+        }
+
+        /* Joined line is split again, so quoted sequence becomes several tokens */
+        for (int i = 2; i < argc; ++i) {
+            size_t tok_len = strlen(argv[i]);
+
+            if (len + tok_len + 1 > sizeof(line)) {
+                return microshEXEC_ERROR;
+            }
+            memcpy(&line[len], argv[i], tok_len);
+            len += tok_len;
+            line[len++] = i + 1 < argc ? ' ' : '\0';
+        }
+
+        if (prv_bind(msh, mrl, id, line, &num) != microshOK) {
+            return microshEXEC_ERROR;
+        }
+
+        mrl->out_fn(mrl, "binding ");
+        mrl->out_fn(mrl, microsh_u64_to_str(num, num_str));
+        mrl->out_fn(mrl, MICRORL_CFG_END_LINE);
+
+        return microshEXEC_OK;
+    }
+}
+
+/**
+ * \brief           Built-in command to remove event binding: `onrm NUM`
+ * \note            Register it with \ref microsh_cmd_register using `2` as maximum
+ *                      number of arguments. Only bindings of the same terminal
+ *                      are removed, other bindings are reported as unknown
+ * \param[in]       msh: microSH instance
+ * \param[in]       argc: argument count
+ * \param[in]       argv: pointer array to token string
+ * \return          \ref microshEXEC_OK on success, member of
+ *                      \ref microsh_execr_t enumeration otherwise
+ */
+int microsh_event_onrm_cmd(microsh_t* msh, int argc, const char* const *argv) {
+    uint32_t num = 0;
+    const char* s;
+
+    if (argc < 2) {
+        return microshEXEC_ERROR_FEW_ARGS;
+    }
+    for (s = argv[1]; *s >= '0' && *s <= '9' && num <= MICROSH_CFG_EVENT_BINDINGS; ++s) {
+        num = num * 10 + (uint32_t)(*s - '0');
+    }
+    if (*s != '\0' || s == argv[1]) {
+        return microshEXEC_ERROR_BAD_ARG;
+    }
+
+    return num > 0 && num <= MICROSH_CFG_EVENT_BINDINGS && msh->events.binds[num - 1].mrl == microsh_get_mrl(msh)
+            && microsh_event_unbind(msh, (uint8_t)num) == microshOK ? microshEXEC_OK : microshEXEC_ERROR;
+}
+
+/**
+ * \brief           Take the next posted event
+ * \param[in,out]   ev: Events context
+ * \param[out]      id: Event identifier
+ * \return          `1` if event is taken, `0` if queue is empty
+ */
+uint8_t microsh_event_pop(microsh_events_t* ev, uint16_t* id) {
+    microsh_event_cell_t* cell = &ev->cells[ev->deq_pos & _EVENT_QUEUE_MASK];
+
+    if (MICROSH_CFG_ATOMIC_LOAD(&cell->seq) != ev->deq_pos + 1) {
+        return 0;
+    }
+
+    *id = cell->id;
+
+    /* Release cell to producers */
+    MICROSH_CFG_ATOMIC_STORE(&cell->seq, ev->deq_pos + MICROSH_CFG_EVENT_QUEUE_LEN);
+    ++ev->deq_pos;
+
+    return 1;
+}
+
+/**
+ * \brief           Check if posted event is waiting
+ * \param[in]       ev: Events context
+ * \return          `1` if queue is not empty, `0` otherwise
+ */
+uint8_t microsh_event_pending(microsh_events_t* ev) {
+    return MICROSH_CFG_ATOMIC_LOAD(&ev->cells[ev->deq_pos & _EVENT_QUEUE_MASK].seq) == ev->deq_pos + 1;
+}
+
+/**
+ * \brief           Remove all bindings of terminal
+ * \param[in,out]   ev: Events context
+ * \param[in]       mrl: \ref microrl_t working instance of terminal
+ */
+void microsh_event_unbind_term(microsh_events_t* ev, const microrl_t* mrl) {
+    for (size_t i = 0; i < MICROSH_ARRAYSIZE(ev->binds); ++i) {
+        if (ev->binds[i].mrl == mrl) {
+            ev->binds[i].argc = 0;
+        }
+    }
+}
+
+/**
+ * \brief           Bind command line to event in free binding
+ * \param[in,out]   msh: microSH instance
+ * \param[in]       mrl: Terminal which binds command, `NULL` for application
+ * \param[in]       id: Event identifier
+ * \param[in]       line: Command line with tokens separated by spaces
+ * \param[out]      num: Number of binding. May be `NULL`
+ * \return          \ref microshOK on success, member of \ref microshr_t otherwise
+ */
+static microshr_t prv_bind(microsh_t* msh, microrl_t* mrl, uint16_t id, const char* line, uint8_t* num) {
+    microsh_events_t* ev = &msh->events;
+    char tokens[MICROSH_CFG_EVENT_LINE_LEN];
+    int argc;
+
+    argc = microsh_line_pack(tokens, sizeof(tokens), line);
+    if (argc <= 0) {
+        return argc == 0 ? microshERRPAR : microshERRMEM;
+    }
+
+    for (size_t i = 0; i < MICROSH_ARRAYSIZE(ev->binds); ++i) {
+        microsh_event_bind_t* b = &ev->binds[i];
+
+        if (b->argc == 0) {
+            memcpy(b->line, tokens, sizeof(b->line));
+            b->mrl = mrl;
+            b->id = id;
+            b->argc = (uint8_t)argc;
+            if (num != NULL) {
+                *num = (uint8_t)(i + 1);
+            }
+            return microshOK;
+        }
+    }
+
+    return microshERRMEM;
+}
+
+/**
+ * \brief           Convert event name or decimal identifier to identifier
+ * \param[in]       ev: Events context
+ * \param[in]       str: Event name or identifier
+ * \param[out]      id: Event identifier
+ * \return          `1` on success, `0` on unknown name or wrong identifier
+ */
+static uint8_t prv_id_parse(microsh_events_t* ev, const char* str, uint16_t* id) {
+    uint32_t val = 0;
+    const char* s;
+
+    for (size_t i = 0; i < ev->names_num; ++i) {
+        if (strcmp(ev->names[i].name, str) == 0) {
+            *id = ev->names[i].id;
+            return 1;
+        }
+    }
+    for (size_t i = 0; i < MICROSH_ARRAYSIZE(shell_event_names); ++i) {
+        if (strcmp(shell_event_names[i].name, str) == 0) {
+            *id = shell_event_names[i].id;
+            return 1;
+        }
+    }
+
+    for (s = str; *s >= '0' && *s <= '9' && val <= UINT16_MAX; ++s) {
+        val = val * 10 + (uint32_t)(*s - '0');
+    }
+    if (*s != '\0' || s == str || val > UINT16_MAX) {
+        return 0;
+    }
+    *id = (uint16_t)val;
+
+    return 1;
+}
+
+/**
+ * \brief           Get name of event
+ * \param[in]       ev: Events context
+ * \param[in]       id: Event identifier
+ * \return          Event name, `NULL` if event has no name
+ */
+static const char* prv_id_name(microsh_events_t* ev, uint16_t id) {
+    for (size_t i = 0; i < ev->names_num; ++i) {
+        if (ev->names[i].id == id) {
+            return ev->names[i].name;
+        }
+    }
+    for (size_t i = 0; i < MICROSH_ARRAYSIZE(shell_event_names); ++i) {
+        if (shell_event_names[i].id == id) {
+            return shell_event_names[i].name;
+        }
+    }
+
+    return NULL;
+}
+
+#endif /* MICROSH_CFG_EVENTS */
@@ -0,0 +1,278 @@
+/**
+ * \file            microsh_hash.c
+ * \brief           microSH password hashing
+ */
+
+/*
+ * Copyright (c) 2022 Dmitry KARASEV
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * This file is part of microSH - Shell for Embedded Systems library.
+ *
+ * Author:          Dmitry KARASEV <karasevsdmitry@yandex.ru>
+ * Version:         2.0.0-dev
+ */
+
+#include <stdint.h>
+#include <string.h>
+#include "microsh.h"
+#include "microsh_hash.h"
+
+#if MICROSH_CFG_PASSW_HASH
+
+#define _ROTR(x, n)                 (((x) >> (n)) | ((x) << (32 - (n))))
+
+/* SHA-256 round constants */
+static const uint32_t sha256_k[64] = {
+    0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+    0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+    0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+    0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+    0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+    0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+    0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+    0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2,
+};
+
+static void    prv_sha256_block(microsh_sha256_t* ctx, const uint8_t* block);
+static void    prv_hmac_init(microsh_sha256_t* inner, microsh_sha256_t* outer, const char* key);
+static void    prv_hmac_final(const microsh_sha256_t* outer, uint8_t* mac);
+static void    prv_wipe(void* buf, size_t len);
+
+/**
+ * \brief           Init SHA-256 context
+ * \param[out]      ctx: SHA-256 context
+ */
+void microsh_sha256_init(microsh_sha256_t* ctx) {
+    static const uint32_t init_state[8] = {
+        0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a, 0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19,
+    };
+
+    memcpy(ctx->state, init_state, sizeof(ctx->state));
+    ctx->len = 0;
+}
+
+/**
+ * \brief           Add data to SHA-256 computation
+ * \param[in,out]   ctx: SHA-256 context
+ * \param[in]       data: Data to hash
+ * \param[in]       len: Data length
+ */
+void microsh_sha256_update(microsh_sha256_t* ctx, const void* data, size_t len) {
+    const uint8_t* d = data;
+
+    while (len > 0) {
+        size_t pos = (size_t)(ctx->len % 64);
+        size_t n = 64 - pos < len ? 64 - pos : len;
+
+        memcpy(&ctx->block[pos], d, n);
+        ctx->len += n;
+        d += n;
+        len -= n;
+
+        if (pos + n == 64) {
+            prv_sha256_block(ctx, ctx->block);
+        }
+    }
+}
+
+/**
+ * \brief           Finish SHA-256 computation
+ * \param[in,out]   ctx: SHA-256 context
+ * \param[out]      digest: `32-bytes` long array to write digest to
+ */
+void microsh_sha256_final(microsh_sha256_t* ctx, uint8_t* digest) {
+    uint64_t bits = ctx->len * 8;
+    size_t pos = (size_t)(ctx->len % 64);
+
+    ctx->block[pos++] = 0x80;
+    if (pos > 56) {
+        memset(&ctx->block[pos], 0x00, 64 - pos);
+        prv_sha256_block(ctx, ctx->block);
+        pos = 0;
+    }
+    memset(&ctx->block[pos], 0x00, 56 - pos);
+    for (size_t i = 0; i < 8; ++i) {
+        ctx->block[63 - i] = (uint8_t)(bits >> (8 * i));
+    }
+    prv_sha256_block(ctx, ctx->block);
+
+    for (size_t i = 0; i < 8; ++i) {
+        digest[4 * i + 0] = (uint8_t)(ctx->state[i] >> 24);
+        digest[4 * i + 1] = (uint8_t)(ctx->state[i] >> 16);
+        digest[4 * i + 2] = (uint8_t)(ctx->state[i] >> 8);
+        digest[4 * i + 3] = (uint8_t)(ctx->state[i]);
+    }
+}
+
+/**
+ * \brief           Compute PBKDF2-HMAC-SHA256 password hash with `32-bytes` output
+ * \note            Computation takes `2 * iterations + 2` SHA-256 block computations for
+ *                      passwords up to `64` characters and salts up to `51` bytes
+ * \param[in]       passw: Password string
+ * \param[in]       salt: Salt
+ * \param[in]       salt_len: Salt length
+ * \param[in]       iterations: Number of iterations
+ * \param[out]      hash: `32-bytes` long array to write hash to
+ */
+void microsh_passw_hash(const char* passw, const uint8_t* salt, size_t salt_len,
+                            uint32_t iterations, uint8_t* hash) {
+    static const uint8_t block_index[4] = {0x00, 0x00, 0x00, 0x01};
+    microsh_sha256_t inner, outer, ctx;
+    uint8_t u[MICROSH_PASSW_HASH_LEN];
+
+    prv_hmac_init(&inner, &outer, passw);
+
+    /* U1 = HMAC(password, salt || INT(1)) */
+    ctx = inner;
+    microsh_sha256_update(&ctx, salt, salt_len);
+    microsh_sha256_update(&ctx, block_index, sizeof(block_index));
+    microsh_sha256_final(&ctx, u);
+    prv_hmac_final(&outer, u);
+    memcpy(hash, u, sizeof(u));
+
+    /* Ui = HMAC(password, Ui-1), hash = U1 ^ U2 ^ ... */
+    for (uint32_t i = 1; i < iterations; ++i) {
+        ctx = inner;
+        microsh_sha256_update(&ctx, u, sizeof(u));
+        microsh_sha256_final(&ctx, u);
+        prv_hmac_final(&outer, u);
+        for (size_t j = 0; j < sizeof(u); ++j) {
+            hash[j] ^= u[j];
+        }
+    }
+
+    prv_wipe(&inner, sizeof(inner));
+    prv_wipe(&outer, sizeof(outer));
+    prv_wipe(&ctx, sizeof(ctx));
+    prv_wipe(u, sizeof(u));
+}
+
+/**
+ * \brief           Check password against stored hash in constant time
+ * \param[in]       passw: Entered password string
+ * \param[in]       salt: Salt of \ref MICROSH_CFG_PASSW_SALT_LEN length
+ * \param[in]       hash: Stored password hash
+ * \return          `1` if password matches, `0` otherwise
+ */
+uint8_t microsh_passw_verify(const char* passw, const uint8_t* salt, const uint8_t* hash) {
+    uint8_t computed[MICROSH_PASSW_HASH_LEN];
+    uint8_t diff = 0;
+
+    microsh_passw_hash(passw, salt, MICROSH_CFG_PASSW_SALT_LEN, MICROSH_CFG_PASSW_HASH_ITERATIONS, computed);
+
+    /* Compare all bytes without early exit */
+    for (size_t i = 0; i < sizeof(computed); ++i) {
+        diff |= (uint8_t)(computed[i] ^ hash[i]);
+    }
+    prv_wipe(computed, sizeof(computed));
+
+    return diff == 0 ? 1 : 0;
+}
+
+/**
+ * \brief           Process one 64-bytes block
+ * \param[in,out]   ctx: SHA-256 context
+ * \param[in]       block: Data block
+ */
+static void prv_sha256_block(microsh_sha256_t* ctx, const uint8_t* block) {
+    uint32_t w[64], s[8];
+
+    for (size_t i = 0; i < 16; ++i) {
+        w[i] = (uint32_t)block[4 * i] << 24 | (uint32_t)block[4 * i + 1] << 16
+                | (uint32_t)block[4 * i + 2] << 8 | (uint32_t)block[4 * i + 3];
+    }
+    for (size_t i = 16; i < 64; ++i) {
+        uint32_t s0 = _ROTR(w[i - 15], 7) ^ _ROTR(w[i - 15], 18) ^ (w[i - 15] >> 3);
+        uint32_t s1 = _ROTR(w[i - 2], 17) ^ _ROTR(w[i - 2], 19) ^ (w[i - 2] >> 10);
+        w[i] = w[i - 16] + s0 + w[i - 7] + s1;
+    }
+
+    memcpy(s, ctx->state, sizeof(s));
+    for (size_t i = 0; i < 64; ++i) {
+        uint32_t t1 = s[7] + (_ROTR(s[4], 6) ^ _ROTR(s[4], 11) ^ _ROTR(s[4], 25))
+                        + ((s[4] & s[5]) ^ (~s[4] & s[6])) + sha256_k[i] + w[i];
+        uint32_t t2 = (_ROTR(s[0], 2) ^ _ROTR(s[0], 13) ^ _ROTR(s[0], 22))
+                        + ((s[0] & s[1]) ^ (s[0] & s[2]) ^ (s[1] & s[2]));
+
+        memmove(&s[1], &s[0], 7 * sizeof(s[0]));
+        s[4] += t1;
+        s[0] = t1 + t2;
+    }
+    for (size_t i = 0; i < 8; ++i) {
+        ctx->state[i] += s[i];
+    }
+}
+
+/**
+ * \brief           Prepare HMAC-SHA256 inner and outer contexts with key blocks processed
+ * \param[out]      inner: Inner context after `key ^ ipad` block
+ * \param[out]      outer: Outer context after `key ^ opad` block
+ * \param[in]       key: Key string
+ */
+static void prv_hmac_init(microsh_sha256_t* inner, microsh_sha256_t* outer, const char* key) {
+    uint8_t k[64] = {0};
+    size_t key_len = strlen(key);
+
+    if (key_len > sizeof(k)) {
+        microsh_sha256_init(inner);
+        microsh_sha256_update(inner, key, key_len);
+        microsh_sha256_final(inner, k);
+    } else {
+        memcpy(k, key, key_len);
+    }
+
+    for (size_t i = 0; i < sizeof(k); ++i) {
+        k[i] ^= 0x36;
+    }
+    microsh_sha256_init(inner);
+    microsh_sha256_update(inner, k, sizeof(k));
+
+    for (size_t i = 0; i < sizeof(k); ++i) {
+        k[i] ^= 0x36 ^ 0x5c;
+    }
+    microsh_sha256_init(outer);
+    microsh_sha256_update(outer, k, sizeof(k));
+
+    prv_wipe(k, sizeof(k));
+}
+
+/**
+ * \brief           Finish HMAC-SHA256 with outer hash of inner digest
+ * \param[in]       outer: Prepared outer context
+ * \param[in,out]   mac: Inner digest on input, MAC on output
+ */
+static void prv_hmac_final(const microsh_sha256_t* outer, uint8_t* mac) {
+    microsh_sha256_t ctx = *outer;
+
+    microsh_sha256_update(&ctx, mac, MICROSH_PASSW_HASH_LEN);
+    microsh_sha256_final(&ctx, mac);
+    prv_wipe(&ctx, sizeof(ctx));
+}
+
+/**
+ * \brief           Clear sensitive data. Unlike memset() this function
+ *                      is not removed by compiler optimizations
+ * \param[out]      buf: Buffer to clear
+ * \param[in]       len: Buffer length
+ */
+static void prv_wipe(void* buf, size_t len) {
+    volatile uint8_t* p = buf;
+
+    while (len--) {
+        *p++ = 0x00;
+    }
+}
+
+#endif /* MICROSH_CFG_PASSW_HASH */
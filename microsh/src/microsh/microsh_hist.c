@@ -0,0 +1,645 @@
+/**
+ * \file            microsh_hist.c
+ * \brief           microSH persistent command history
+ */
+
+/*
+ * Copyright (c) 2022 Dmitry KARASEV
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * This file is part of microSH - Shell for Embedded Systems library.
+ *
+ * Author:          Dmitry KARASEV <karasevsdmitry@yandex.ru>
+ * Version:         2.0.0-dev
+ */
+
+
+#include <stdint.h>
+#include <string.h>
+#include "microsh.h"
+#include "microsh_priv.h"
+
+#if MICROSH_CFG_HISTORY
+
+/* Number of record slots in storage sector */
+#define _HIST_RECS_PER_SECTOR(st)   ((st)->sector_size / sizeof(microsh_hist_rec_t))
+
+/* Keys of reverse search mode */
+#define _HIST_KEY_SEARCH            0x12        /* Ctrl+R */
+#define _HIST_KEY_CANCEL            0x07        /* Ctrl+G */
+#define _HIST_KEY_INTR              0x03        /* Ctrl+C */
+#define _HIST_KEY_BS                0x08
+#define _HIST_KEY_DEL               0x7F
+
+#define _HIST_CLEAR_LINE_SEQ        "\r\033[K"
+
+static uint8_t  prv_owner(microsh_t* msh, microrl_t* mrl, uint8_t* owner);
+static uint8_t  prv_visible(const microsh_hist_t* hist, uint32_t slot, uint8_t owner);
+static void     prv_add(microsh_t* msh, uint8_t owner, const char* line, size_t len);
+static uint8_t  prv_search(microsh_hist_t* hist, uint8_t owner, uint32_t from);
+static void     prv_search_key(microsh_t* msh, microrl_t* mrl, char ch, uint8_t* consumed);
+static void     prv_search_print(microsh_hist_t* hist, microrl_t* mrl);
+static void     prv_search_end(microsh_hist_t* hist, microrl_t* mrl, uint8_t accept);
+static uint64_t prv_sig(const char* str, size_t len);
+static uint16_t prv_rec_chk(const microsh_hist_rec_t* rec);
+static uint32_t prv_slot_addr(const microsh_hist_storage_t* st, uint32_t slot);
+static uint8_t  prv_rec_read(const microsh_hist_storage_t* st, uint32_t slot, microsh_hist_rec_t* rec);
+
+/**
+ * \brief           Init history, find the last stored line and index stored lines
+ * \note            Call this function right after microsh_init(). Every stored line
+ *                      is read once to build signatures index
+ * \param[in,out]   msh: microSH instance
+ * \param[in]       storage: Persistent storage interface. Must stay valid while shell is used
+ * \return          \ref microshOK on success, member of \ref microshr_t otherwise
+ */
+microshr_t microsh_hist_init(microsh_t* msh, const microsh_hist_storage_t* storage) {
+    microsh_hist_t* hist;
+    microsh_hist_rec_t rec;
+    uint32_t rps, sectors, newest_sector = 0, newest_seq = 0;
+    uint8_t found = 0;
+
+    if (msh == NULL || storage == NULL || storage->read_fn == NULL || storage->write_fn == NULL
+            || storage->erase_fn == NULL || storage->sector_size < sizeof(microsh_hist_rec_t)) {
+        return microshERRPAR;
+    }
+
+    /* Signatures index limits number of used sectors */
+    rps = _HIST_RECS_PER_SECTOR(storage);
+    sectors = MICROSH_CFG_HISTORY_ENTRIES / rps;
+    if (sectors > storage->sector_num) {
+        sectors = storage->sector_num;
+    }
+    if (sectors < 2) {
+        return microshERRPAR;
+    }
+
+    hist = &msh->hist;
+    memset(hist, 0x00, sizeof(microsh_hist_t));
+    hist->slots = sectors * rps;
+
+    /* Find sector started with the newest line */
+    for (uint32_t i = 0; i < sectors; ++i) {
+        if (prv_rec_read(storage, i * rps, &rec)
+                && (!found || (int32_t)(rec.seq - newest_seq) > 0)) {
+            newest_sector = i;
+            newest_seq = rec.seq;
+            found = 1;
+        }
+    }
+
+    if (found) {
+        uint32_t i;
+
+        /* Find the end of continuous lines sequence in the newest sector */
+        for (i = 1; i < rps; ++i) {
+            if (!prv_rec_read(storage, newest_sector * rps + i, &rec) || rec.seq != newest_seq + i) {
+                break;
+            }
+        }
+        hist->slot = (newest_sector * rps + i) % hist->slots;
+        hist->seq = newest_seq + i;
+
+        /* Index continuous sequence of lines back from the newest one */
+        for (; hist->num < hist->slots; ++hist->num) {
+            uint32_t slot = (hist->slot + hist->slots - 1 - hist->num) % hist->slots;
+
+            if (!prv_rec_read(storage, slot, &rec) || rec.seq != hist->seq - 1 - hist->num) {
+                break;
+            }
+            hist->sigs[slot] = prv_sig(rec.line, rec.len);
+#if MICROSH_CFG_CONSOLE_SESSIONS
+            hist->owners[slot] = rec.owner;
+#endif /* MICROSH_CFG_CONSOLE_SESSIONS */
+        }
+    }
+    hist->storage = storage;
+
+    return microshOK;
+}
+
+/**
+ * \brief           Process terminal input with history keys
+ * \note            Call this function instead of microrl_processing_input(). Entered
+ *                      lines are stored before they are executed, Ctrl+R starts reverse search.
+ *                      Nothing is stored or searched while user is not logged in, user
+ *                      searches only own lines
+ * \param[in,out]   msh: microSH instance
+ * \param[in,out]   mrl: \ref microrl_t working instance of terminal
+ * \param[in]       data: Input data
+ * \param[in]       len: Input data length
+ * \return          \ref microshOK on success, member of \ref microshr_t otherwise
+ */
+microshr_t microsh_hist_input(microsh_t* msh, microrl_t* mrl, const void* data, size_t len) {
+    microsh_hist_t* hist;
+    const char* in = data;
+    size_t start = 0;
+
+    if (msh == NULL || mrl == NULL || (data == NULL && len > 0)) {
+        return microshERRPAR;
+    }
+
+    hist = &msh->hist;
+    for (size_t i = 0; hist->storage != NULL && i < len; ++i) {
+        char ch = in[i];
+        uint8_t consumed = 0, owner;
+
+        /* Ordinary keys are passed to line editor at once */
+        if (hist->search_mrl != mrl && ch != _HIST_KEY_SEARCH && ch != '\r' && ch != '\n') {
+            continue;
+        }
+        if (!prv_owner(msh, mrl, &owner)) {
+            /* Session may time out while searching */
+            if (hist->search_mrl == mrl) {
+                hist->search_mrl = NULL;
+            }
+            continue;
+        }
+
+        /* Line editor gets input up to the key to see actual line */
+        if (i > start) {
+            microrl_processing_input(mrl, &in[start], i - start);
+            start = i;
+        }
+
+        if (hist->search_mrl == mrl) {
+            prv_search_key(msh, mrl, ch, &consumed);
+        } else if (ch == _HIST_KEY_SEARCH && hist->search_mrl == NULL) {
+            hist->search_mrl = mrl;
+            hist->query_len = 0;
+            hist->query[0] = '\0';
+            hist->found = 0;
+            hist->failed = 0;
+            prv_search_print(hist, mrl);
+            consumed = 1;
+        }
+
+        if ((ch == '\r' || ch == '\n') && hist->search_mrl != mrl) {
+            prv_add(msh, owner, mrl->cmdline, (size_t)mrl->cmdlen);
+        }
+        if (consumed) {
+            start = i + 1;
+        }
+    }
+
+    if (len > start) {
+        microrl_processing_input(mrl, &in[start], len - start);
+    }
+
+    return microshOK;
+}
+
+/**
+ * \brief           Read stored line
+ * \note            Lines of all users are read, see \ref microsh_hist_rec_t::owner
+ * \param[in]       msh: microSH instance
+ * \param[in]       n: Line number, `0` is the newest line
+ * \param[out]      rec: Record to read to
+ * \return          \ref microshOK on success, \ref microshERR if line
+ *                      does not exist, member of \ref microshr_t otherwise
+ */
+microshr_t microsh_hist_read(microsh_t* msh, size_t n, microsh_hist_rec_t* rec) {
+    microsh_hist_t* hist;
+
+    if (msh == NULL || rec == NULL || msh->hist.storage == NULL) {
+        return microshERRPAR;
+    }
+
+    hist = &msh->hist;
+    if (n >= hist->num) {
+        return microshERR;
+    }
+
+    if (!prv_rec_read(hist->storage, (hist->slot + hist->slots - 1 - (uint32_t)n) % hist->slots, rec)
+            || rec->seq != hist->seq - 1 - (uint32_t)n) {
+        return microshERR;
+    }
+
+    return microshOK;
+}
+
+/**
+ * \brief           Erase stored lines of all users
+ * \note            Lines are kept over log outs and restarts, call it when users
+ *                      are changed or device is handed over
+ * \param[in,out]   msh: microSH instance
+ * \return          \ref microshOK on success, member of \ref microshr_t otherwise
+ */
+microshr_t microsh_hist_clear(microsh_t* msh) {
+    const microsh_hist_storage_t* st;
+    microsh_hist_t* hist;
+    uint32_t rps;
+
+    if (msh == NULL || msh->hist.storage == NULL) {
+        return microshERRPAR;
+    }
+
+    hist = &msh->hist;
+    st = hist->storage;
+    rps = _HIST_RECS_PER_SECTOR(st);
+    hist->num = 0;
+    hist->slot = 0;
+    hist->found = 0;
+    hist->failed = 0;
+    for (uint32_t i = 0; i < hist->slots / rps; ++i) {
+        microshr_t res = st->erase_fn(st->ctx, prv_slot_addr(st, i * rps));
+
+        if (res != microshOK) {
+            return res;
+        }
+    }
+
+    return microshOK;
+}
+
+/**
+ * \brief           Built-in command to print the newest stored lines of user
+ * \note            Register it with \ref microsh_cmd_register using `2` as maximum
+ *                      number of arguments. Optional argument is number of lines, default is `10`
+ * \param[in]       msh: microSH instance
+ * \param[in]       argc: argument count
+ * \param[in]       argv: pointer array to token string
+ * \return          \ref microshEXEC_OK on success, member of
+ *                      \ref microsh_execr_t enumeration otherwise
+ */
+int microsh_hist_cmd(microsh_t* msh, int argc, const char* const *argv) {
+    microsh_hist_t* hist = &msh->hist;
+    microrl_t* mrl = microsh_get_mrl(msh);
+    microsh_hist_rec_t rec;
+    char num_str[21];
+    size_t num = 10, first = 0, found = 0;
+    uint8_t owner;
+
+    if (argc > 1) {
+        const char* s;
+
+        /* Number is limited to avoid overflow, more lines than stored are never printed */
+        num = 0;
+        for (s = argv[1]; *s >= '0' && *s <= '9' && num < UINT32_MAX / 10; ++s) {
+            num = num * 10 + (size_t)(*s - '0');
+        }
+        if (*s != '\0' || s == argv[1]) {
+            return microshEXEC_ERROR_BAD_ARG;
+        }
+    }
+    if (hist->storage == NULL || !prv_owner(msh, mrl, &owner)) {
+        return microshEXEC_ERROR;
+    }
+
+    /* Find the oldest of lines to print, the newest line is printed last, right above the prompt */
+    for (size_t i = 0; i < hist->num && found < num; ++i) {
+        if (prv_visible(hist, (hist->slot + hist->slots - 1 - (uint32_t)i) % hist->slots, owner)) {
+            first = i;
+            ++found;
+        }
+    }
+    for (size_t i = found > 0 ? first + 1 : 0; i-- > 0;) {
+        if (!prv_visible(hist, (hist->slot + hist->slots - 1 - (uint32_t)i) % hist->slots, owner)
+                || microsh_hist_read(msh, i, &rec) != microshOK) {
+            continue;
+        }
+        mrl->out_fn(mrl, microsh_u64_to_str(rec.seq, num_str));
+        mrl->out_fn(mrl, "\t");
+        mrl->out_fn(mrl, rec.line);
+        mrl->out_fn(mrl, MICRORL_CFG_END_LINE);
+#if MICROSH_CFG_PIPES
+        /* Do not read storage for lines dropped by pipe filters */
+        if (microsh_pipe_stopped(msh)) {
+            break;
+        }
+#endif /* MICROSH_CFG_PIPES */
+    }
+
+    return microshEXEC_OK;
+}
+
+/**
+ * \brief           Check if history may be used by terminal and get owner of its lines
+ * \param[in]       msh: microSH instance
+ * \param[in]       mrl: \ref microrl_t working instance of terminal
+ * \param[out]      owner: Owner of lines entered in terminal
+ * \return          `1` if user is logged in or sessions are disabled, `0` otherwise
+ */
+static uint8_t prv_owner(microsh_t* msh, microrl_t* mrl, uint8_t* owner) {
+#if MICROSH_CFG_CONSOLE_SESSIONS
+    int user = microsh_session_term_user(msh, mrl);
+
+    if (user < 0 || user >= MICROSH_HIST_OWNER_NONE) {
+        return 0;
+    }
+    *owner = (uint8_t)user;
+#else
+    MICROSH_UNUSED(msh);
+    MICROSH_UNUSED(mrl);
+
+    *owner = MICROSH_HIST_OWNER_NONE;
+#endif /* MICROSH_CFG_CONSOLE_SESSIONS */
+
+    return 1;
+}
+
+/**
+ * \brief           Check if line may be shown to user
+ * \param[in]       hist: History context
+ * \param[in]       slot: Record slot of line in storage ring
+ * \param[in]       owner: Owner of lines of user
+ * \return          `1` if line belongs to user or sessions are disabled, `0` otherwise
+ */
+static uint8_t prv_visible(const microsh_hist_t* hist, uint32_t slot, uint8_t owner) {
+#if MICROSH_CFG_CONSOLE_SESSIONS
+    return hist->owners[slot] == owner ? 1 : 0;
+#else
+    MICROSH_UNUSED(hist);
+    MICROSH_UNUSED(slot);
+    MICROSH_UNUSED(owner);
+
+    return 1;
+#endif /* MICROSH_CFG_CONSOLE_SESSIONS */
+}
+
+/**
+ * \brief           Append entered line to storage ring and index it
+ * \note            Empty and too long lines and repeat of the newest line are not stored
+ * \param[in,out]   msh: microSH instance
+ * \param[in]       owner: Owner of line
+ * \param[in]       line: Entered line, not terminated
+ * \param[in]       len: Line length
+ */
+static void prv_add(microsh_t* msh, uint8_t owner, const char* line, size_t len) {
+    microsh_hist_t* hist = &msh->hist;
+    const microsh_hist_storage_t* st = hist->storage;
+    microsh_hist_rec_t rec;
+    uint32_t rps = _HIST_RECS_PER_SECTOR(st);
+
+    if (len == 0 || len >= sizeof(rec.line)) {
+        return;
+    }
+    if (microsh_hist_read(msh, 0, &rec) == microshOK && rec.owner == owner
+            && rec.len == len && memcmp(rec.line, line, len) == 0) {
+        return;
+    }
+
+    memset(&rec, 0x00, sizeof(rec));
+    memcpy(rec.line, line, len);
+    rec.seq = hist->seq;
+    rec.len = (uint8_t)len;
+    rec.owner = owner;
+    rec.chk = prv_rec_chk(&rec);
+
+    /* Erase sector only when write position enters it, its lines are lost */
+    if (hist->slot % rps == 0) {
+        if (hist->num > hist->slots - rps) {
+            hist->num = hist->slots - rps;
+        }
+        if (st->erase_fn(st->ctx, prv_slot_addr(st, hist->slot)) != microshOK) {
+            return;
+        }
+    }
+    if (st->write_fn(st->ctx, prv_slot_addr(st, hist->slot), &rec, sizeof(rec)) != microshOK) {
+        return;
+    }
+
+    hist->sigs[hist->slot] = prv_sig(rec.line, len);
+#if MICROSH_CFG_CONSOLE_SESSIONS
+    hist->owners[hist->slot] = owner;
+#endif /* MICROSH_CFG_CONSOLE_SESSIONS */
+    hist->slot = (hist->slot + 1) % hist->slots;
+    ++hist->seq;
+    ++hist->num;
+}
+
+/**
+ * \brief           Find line of user containing search query
+ * \note            Only lines with all query trigrams in signature are read from storage,
+ *                      query shorter than `3` characters reads every line of user
+ * \param[in,out]   hist: History context
+ * \param[in]       owner: Owner of lines of user
+ * \param[in]       from: Line number to start from, `0` is the newest line
+ * \return          `1` if line is found and read to current match record, `0` otherwise
+ */
+static uint8_t prv_search(microsh_hist_t* hist, uint8_t owner, uint32_t from) {
+    uint64_t sig = prv_sig(hist->query, hist->query_len);
+    microsh_hist_rec_t* rec = &hist->rec;
+
+    for (uint32_t n = from; n < hist->num; ++n) {
+        uint32_t slot = (hist->slot + hist->slots - 1 - n) % hist->slots;
+
+        if ((hist->sigs[slot] & sig) != sig || !prv_visible(hist, slot, owner)) {
+            continue;
+        }
+        if (prv_rec_read(hist->storage, slot, rec) && rec->seq == hist->seq - 1 - n
+                && strstr(rec->line, hist->query) != NULL) {
+            hist->match = n;
+            hist->found = 1;
+            return 1;
+        }
+    }
+
+    /* Record may be overwritten by lines being checked */
+    if (hist->found) {
+        uint32_t slot = (hist->slot + hist->slots - 1 - hist->match) % hist->slots;
+
+        hist->found = prv_rec_read(hist->storage, slot, rec);
+    }
+
+    return 0;
+}
+
+/**
+ * \brief           Process key of reverse search mode
+ * \param[in,out]   msh: microSH instance
+ * \param[in,out]   mrl: \ref microrl_t working instance of searching terminal
+ * \param[in]       ch: Input character
+ * \param[out]      consumed: Set to `1` if key must not be passed to line editor
+ */
+static void prv_search_key(microsh_t* msh, microrl_t* mrl, char ch, uint8_t* consumed) {
+    microsh_hist_t* hist = &msh->hist;
+    uint8_t owner = MICROSH_HIST_OWNER_NONE;
+
+    /* Terminal is checked to be allowed before key */
+    prv_owner(msh, mrl, &owner);
+    *consumed = 1;
+    switch (ch) {
+        case _HIST_KEY_SEARCH: {
+            /* The next older match */
+            if (hist->query_len > 0) {
+                hist->failed = !prv_search(hist, owner, hist->found ? hist->match + 1 : 0);
+            }
+            break;
+        }
+        case _HIST_KEY_BS:
+        case _HIST_KEY_DEL: {
+            if (hist->query_len > 0) {
+                hist->query[--hist->query_len] = '\0';
+                hist->found = 0;
+                hist->failed = hist->query_len > 0 && !prv_search(hist, owner, 0);
+            }
+            break;
+        }
+        case _HIST_KEY_CANCEL: {
+            prv_search_end(hist, mrl, 0);
+            return;
+        }
+        case _HIST_KEY_INTR: {
+            /* Line editor calls Ctrl+C callback for line being edited */
+            prv_search_end(hist, mrl, 0);
+            *consumed = 0;
+            return;
+        }
+        default: {
+            if (ch >= 0x20 && ch < 0x7F) {
+                if (hist->query_len + 1 < sizeof(hist->query)) {
+                    hist->query[hist->query_len++] = ch;
+                    hist->query[hist->query_len] = '\0';
+
+                    /* Current match may contain longer query too */
+                    hist->failed = !prv_search(hist, owner, hist->found ? hist->match : 0);
+                }
+                break;
+            }
+
+            /* Other keys put match to line editor and are processed by it */
+            prv_search_end(hist, mrl, 1);
+            *consumed = 0;
+            return;
+        }
+    }
+
+    prv_search_print(hist, mrl);
+}
+
+/**
+ * \brief           Print search prompt, query and current match
+ * \param[in]       hist: History context
+ * \param[in]       mrl: \ref microrl_t working instance of searching terminal
+ */
+static void prv_search_print(microsh_hist_t* hist, microrl_t* mrl) {
+    mrl->out_fn(mrl, _HIST_CLEAR_LINE_SEQ);
+    mrl->out_fn(mrl, hist->failed ? "(failed reverse-i-search)`" : "(reverse-i-search)`");
+    mrl->out_fn(mrl, hist->query);
+    mrl->out_fn(mrl, "': ");
+    if (hist->found) {
+        mrl->out_fn(mrl, hist->rec.line);
+    }
+}
+
+/**
+ * \brief           Leave reverse search mode and redraw line editor
+ * \param[in,out]   hist: History context
+ * \param[in,out]   mrl: \ref microrl_t working instance of searching terminal
+ * \param[in]       accept: `1` to replace line being edited with current match,
+ *                      `0` to keep line being edited
+ */
+static void prv_search_end(microsh_hist_t* hist, microrl_t* mrl, uint8_t accept) {
+    char line[MICRORL_CFG_CMDLINE_LEN + 1];
+    size_t cmdlen;
+
+    hist->search_mrl = NULL;
+    if (accept && hist->found && hist->rec.len < sizeof(mrl->cmdline)) {
+        memset(mrl->cmdline, 0x00, sizeof(mrl->cmdline));
+        memcpy(mrl->cmdline, hist->rec.line, hist->rec.len);
+        mrl->cmdlen = hist->rec.len;
+        mrl->cursor = hist->rec.len;
+    }
+
+    cmdlen = (size_t)mrl->cmdlen;
+    memcpy(line, mrl->cmdline, cmdlen);
+    line[cmdlen] = '\0';
+
+    mrl->out_fn(mrl, _HIST_CLEAR_LINE_SEQ);
+    mrl->out_fn(mrl, mrl->prompt_str);
+    mrl->out_fn(mrl, line);
+    if ((size_t)mrl->cursor < cmdlen) {
+        char str[4 + 20] = "\033[";
+
+        microsh_u64_to_str(cmdlen - (size_t)mrl->cursor, &str[2]);
+        strcat(str, "D");
+        mrl->out_fn(mrl, str);
+    }
+}
+
+/**
+ * \brief           Calculate signature of string trigrams
+ * \note            Every trigram sets one of `64` bits, so about half of bits are
+ *                      set for the longest lines. String shorter than `3` characters
+ *                      has empty signature and matches any line
+ * \param[in]       str: String
+ * \param[in]       len: String length
+ * \return          Signature
+ */
+static uint64_t prv_sig(const char* str, size_t len) {
+    uint64_t sig = 0;
+
+    for (size_t i = 0; i + 3 <= len; ++i) {
+        uint32_t h = ((uint32_t)(uint8_t)str[i] << 16) | ((uint32_t)(uint8_t)str[i + 1] << 8)
+                        | (uint32_t)(uint8_t)str[i + 2];
+
+        /* Fibonacci hashing, upper bits are the best mixed */
+        sig |= (uint64_t)1 << ((h * 2654435761U) >> 26);
+    }
+
+    return sig;
+}
+
+/**
+ * \brief           Calculate Fletcher-16 check value of record
+ * \param[in]       rec: History record
+ * \return          Check value
+ */
+static uint16_t prv_rec_chk(const microsh_hist_rec_t* rec) {
+    const uint8_t* p = (const uint8_t*)rec;
+    size_t end = offsetof(microsh_hist_rec_t, line) + rec->len;
+    uint16_t s1 = 0, s2 = 0;
+
+    for (size_t i = 0; i < end; ++i) {
+        if (i == offsetof(microsh_hist_rec_t, chk)) {
+            i += sizeof(rec->chk) - 1;
+            continue;
+        }
+        s1 = (uint16_t)((s1 + p[i]) % 255);
+        s2 = (uint16_t)((s2 + s1) % 255);
+    }
+
+    return (uint16_t)((s2 << 8) | s1);
+}
+
+/**
+ * \brief           Get storage address of record slot
+ * \param[in]       st: History storage
+ * \param[in]       slot: Record slot in storage ring
+ * \return          Storage address
+ */
+static uint32_t prv_slot_addr(const microsh_hist_storage_t* st, uint32_t slot) {
+    uint32_t rps = _HIST_RECS_PER_SECTOR(st);
+
+    return (slot / rps) * st->sector_size + (slot % rps) * (uint32_t)sizeof(microsh_hist_rec_t);
+}
+
+/**
+ * \brief           Read record slot and check it
+ * \param[in]       st: History storage
+ * \param[in]       slot: Record slot in storage ring
+ * \param[out]      rec: Record to read to
+ * \return          `1` if slot contains valid record, `0` otherwise
+ */
+static uint8_t prv_rec_read(const microsh_hist_storage_t* st, uint32_t slot, microsh_hist_rec_t* rec) {
+    if (st->read_fn(st->ctx, prv_slot_addr(st, slot), rec, sizeof(*rec)) != microshOK) {
+        return 0;
+    }
+
+    return rec->seq != 0xFFFFFFFF && rec->len < sizeof(rec->line) && rec->line[rec->len] == '\0'
+            && rec->chk == prv_rec_chk(rec) ? 1 : 0;
+}
+
+#endif /* MICROSH_CFG_HISTORY */
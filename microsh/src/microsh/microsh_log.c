@@ -0,0 +1,198 @@
+/**
+ * \file            microsh_log.c
+ * \brief           microSH asynchronous log
+ */
+
+/*
+ * Copyright (c) 2022 Dmitry KARASEV
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * This file is part of microSH - Shell for Embedded Systems library.
+ *
+ * Author:          Dmitry KARASEV <karasevsdmitry@yandex.ru>
+ * Version:         2.0.0-dev
+ */
+
+#include <stdint.h>
+#include <string.h>
+#include "microsh.h"
+#include "microsh_priv.h"
+
+#if MICROSH_CFG_ASYNC_LOG
+
+#define _LOG_QUEUE_MASK             (MICROSH_CFG_ASYNC_LOG_QUEUE_LEN - 1)
+
+/* Output buffer size for all queued messages and redrawn command line */
+#define _LOG_OUT_BUF_LEN            (MICROSH_CFG_ASYNC_LOG_QUEUE_LEN * (MICROSH_CFG_ASYNC_LOG_MSG_LEN + sizeof(MICRORL_CFG_END_LINE)) \
+                                        + MICRORL_CFG_CMDLINE_LEN + 64)
+
+/* Clear current terminal line and move cursor to its start */
+#define _LOG_CLEAR_LINE_SEQ         "\r\033[K"
+
+#ifdef MICRORL_CFG_ECHO_OFF_MASK
+#define _LOG_ECHO_OFF_MASK          MICRORL_CFG_ECHO_OFF_MASK
+#else
+#define _LOG_ECHO_OFF_MASK          '*'
+#endif /* MICRORL_CFG_ECHO_OFF_MASK */
+
+static size_t  prv_str_append(char* buf, size_t pos, size_t end, const char* str);
+
+/**
+ * \brief           Prepare asynchronous log queue
+ * \param[in,out]   msh: microSH instance
+ */
+void microsh_log_init(microsh_t* msh) {
+    for (size_t i = 0; i < MICROSH_CFG_ASYNC_LOG_QUEUE_LEN; ++i) {
+        msh->log.cells[i].seq = i;
+    }
+    msh->log.enq_pos = 0;
+    msh->log.deq_pos = 0;
+}
+
+/**
+ * \brief           Queue log message to print it above the line being edited
+ * \note            Function is lock-free and may be called from interrupts and
+ *                      other tasks. Message is printed by \ref microsh_log_process
+ * \param[in,out]   msh: microSH instance
+ * \param[in]       str: Message without line ending. Longer messages are truncated
+ *                      to \ref MICROSH_CFG_ASYNC_LOG_MSG_LEN
+ * \return          \ref microshOK on success, \ref microshERRMEM if queue is full,
+ *                      member of \ref microshr_t otherwise
+ */
+microshr_t microsh_log_async(microsh_t* msh, const char* str) {
+    microsh_log_t* log;
+    microsh_log_cell_t* cell;
+    size_t pos, seq, i;
+
+    if (msh == NULL || str == NULL) {
+        return microshERRPAR;
+    }
+
+    log = &msh->log;
+    pos = MICROSH_CFG_ATOMIC_LOAD(&log->enq_pos);
+
+    /* Reserve cell, competing with other producers */
+    while (1) {
+        cell = &log->cells[pos & _LOG_QUEUE_MASK];
+        seq = MICROSH_CFG_ATOMIC_LOAD(&cell->seq);
+
+        if (seq == pos) {
+            if (MICROSH_CFG_ATOMIC_CAS(&log->enq_pos, &pos, pos + 1)) {
+                break;
+            }
+        } else if ((ptrdiff_t)(seq - pos) < 0) {
+            (void)MICROSH_CFG_ATOMIC_FETCH_ADD(&log->dropped, 1);
+            return microshERRMEM;
+        } else {
+            pos = MICROSH_CFG_ATOMIC_LOAD(&log->enq_pos);
+        }
+    }
+
+    for (i = 0; i < MICROSH_CFG_ASYNC_LOG_MSG_LEN - 1 && str[i] != '\0'; ++i) {
+        cell->msg[i] = str[i];
+    }
+    cell->msg[i] = '\0';
+
+    /* Publish cell to consumer */
+    MICROSH_CFG_ATOMIC_STORE(&cell->seq, pos + 1);
+
+    return microshOK;
+}
+
+/**
+ * \brief           Print all queued log messages
+ * \note            Call this function from the same context as input processing,
+ *                      between keystrokes. Current line is cleared, messages are printed
+ *                      and prompt with line being edited is redrawn in one output call
+ * \param[in,out]   msh: microSH instance
+ * \return          \ref microshOK on success, member of \ref microshr_t otherwise
+ */
+microshr_t microsh_log_process(microsh_t* msh) {
+    microsh_log_t* log;
+    microrl_t* mrl;
+    microsh_log_cell_t* cell;
+    char out[_LOG_OUT_BUF_LEN];
+    size_t len, start, tail_len, msgs_end, cmdlen, cursor;
+
+    if (msh == NULL) {
+        return microshERRPAR;
+    }
+
+    log = &msh->log;
+    mrl = &msh->mrl;
+    cmdlen = (size_t)mrl->cmdlen;
+    cursor = (size_t)mrl->cursor;
+
+    /* Space for prompt, command line and cursor move sequence, long prompt takes at most half of buffer */
+    tail_len = strlen(mrl->prompt_str) + cmdlen + 16;
+    msgs_end = tail_len < sizeof(out) / 2 ? sizeof(out) - 1 - tail_len : sizeof(out) / 2;
+
+    cell = &log->cells[log->deq_pos & _LOG_QUEUE_MASK];
+    while (MICROSH_CFG_ATOMIC_LOAD(&cell->seq) == log->deq_pos + 1) {
+        len = prv_str_append(out, 0, msgs_end, _LOG_CLEAR_LINE_SEQ);
+        start = len;
+
+        /* Collect messages while they fit to output buffer, the first one is truncated if it does not */
+        while (MICROSH_CFG_ATOMIC_LOAD(&cell->seq) == log->deq_pos + 1
+                && (len == start || len + strlen(cell->msg) + sizeof(MICRORL_CFG_END_LINE) <= msgs_end)) {
+            len = prv_str_append(out, len, msgs_end - (sizeof(MICRORL_CFG_END_LINE) - 1), cell->msg);
+            len = prv_str_append(out, len, msgs_end, MICRORL_CFG_END_LINE);
+
+            /* Release cell to producers */
+            MICROSH_CFG_ATOMIC_STORE(&cell->seq, log->deq_pos + MICROSH_CFG_ASYNC_LOG_QUEUE_LEN);
+            ++log->deq_pos;
+            cell = &log->cells[log->deq_pos & _LOG_QUEUE_MASK];
+        }
+
+        /* Redraw prompt and line being edited */
+        len = prv_str_append(out, len, sizeof(out) - 1, mrl->prompt_str);
+        for (size_t i = 0; i < cmdlen && len < sizeof(out) - 1; ++i) {
+#if MICROSH_CFG_CONSOLE_SESSIONS
+            out[len++] = msh->session.status.flags.passw_wait ? _LOG_ECHO_OFF_MASK : mrl->cmdline[i];
+#else
+            out[len++] = mrl->cmdline[i];
+#endif /* MICROSH_CFG_CONSOLE_SESSIONS */
+        }
+        if (cursor < cmdlen) {
+            char num_str[21];
+
+            len = prv_str_append(out, len, sizeof(out) - 1, "\033[");
+            len = prv_str_append(out, len, sizeof(out) - 1, microsh_u64_to_str(cmdlen - cursor, num_str));
+            len = prv_str_append(out, len, sizeof(out) - 1, "D");
+        }
+        out[len] = '\0';
+
+        mrl->out_fn(mrl, out);
+    }
+
+    return microshOK;
+}
+
+/**
+ * \brief           Append string to buffer, string is truncated at the end position
+ * \param[out]      buf: Buffer to append to
+ * \param[in]       pos: Current length of buffer content
+ * \param[in]       end: Maximum length of buffer content
+ * \param[in]       str: String to append
+ * \return          New length of buffer content
+ */
+static size_t prv_str_append(char* buf, size_t pos, size_t end, const char* str) {
+    while (*str != '\0' && pos < end) {
+        buf[pos++] = *str++;
+    }
+
+    return pos;
+}
+
+#endif /* MICROSH_CFG_ASYNC_LOG */
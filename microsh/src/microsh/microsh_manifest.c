@@ -0,0 +1,291 @@
+/**
+ * \file            microsh_manifest.c
+ * \brief           microSH command manifest export
+ */
+
+/*
+ * Copyright (c) 2022 Dmitry KARASEV
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * This file is part of microSH - Shell for Embedded Systems library.
+ *
+ * Author:          Dmitry KARASEV <karasevsdmitry@yandex.ru>
+ * Version:         2.0.0-dev
+ */
+
+
+#include <stdint.h>
+#include <string.h>
+#include "microsh.h"
+#include "microsh_priv.h"
+
+#if MICROSH_CFG_MANIFEST
+
+#define _STR(x)                     #x
+#define _XSTR(x)                    _STR(x)
+#define _MANIFEST_VERSION           _XSTR(MICROSH_VERSION_MAJOR) "." _XSTR(MICROSH_VERSION_MINOR) "." \
+                                        _XSTR(MICROSH_VERSION_PATCH)
+
+/**
+ * \brief           Manifest output chunk
+ */
+typedef struct {
+    microrl_t* mrl;                             /*!< Terminal to print to */
+    size_t len;                                 /*!< Used length of chunk */
+    char buf[MICROSH_CFG_MANIFEST_CHUNK_LEN + 1]; /*!< Chunk being filled */
+} prv_chunk_t;
+
+static void prv_cmd_put(prv_chunk_t* ch, const microsh_cmd_t* cmd);
+#if MICROSH_CFG_ARG_SCHEMA
+static void prv_schema_put(prv_chunk_t* ch, const microsh_arg_schema_t* schema);
+static void prv_i64_put(prv_chunk_t* ch, int64_t val);
+#endif /* MICROSH_CFG_ARG_SCHEMA */
+static void prv_str_put(prv_chunk_t* ch, const char* str);
+static void prv_put(prv_chunk_t* ch, const char* str);
+static void prv_put_char(prv_chunk_t* ch, char c);
+static void prv_flush(prv_chunk_t* ch);
+
+/**
+ * \brief           Print manifest of registered commands as JSON document
+ *
+ * Document is `{"version":"X.Y.Z","cmds":[CMD,...]}`, every registered command
+ * starts new line. `CMD` is `{"name":NAME,"args":N}` with optional members:
+ *  - `"desc"`: description, omitted if command has no description
+ *  - `"exec":false`: subcommand table entry without function
+ *  - `"schema":{"min":N,"args":[ARG,...]}`: arguments schema, `ARG` is
+ *      `{"type":T}` with optional `"min"`, `"max"` and `"kw":[KEYWORD,...]`.
+ *      `T` is one of `"str"`, `"u32"`, `"i32"`, `"hex"` and `"enum"`
+ *  - `"sub":[CMD,...]`: subcommands table
+ *
+ * With console sessions document has `"login_type"` member of session of `mrl` terminal,
+ * commands are registered per login type by application
+ * \note            Output is passed to terminal print function in chunks of
+ *                      \ref MICROSH_CFG_MANIFEST_CHUNK_LEN characters
+ * \param[in]       msh: microSH instance
+ * \param[in]       mrl: \ref microrl_t working instance of terminal to print to
+ * \return          \ref microshOK on success, member of \ref microshr_t otherwise
+ */
+microshr_t microsh_manifest_print(microsh_t* msh, microrl_t* mrl) {
+    prv_chunk_t ch;
+
+    if (msh == NULL || mrl == NULL) {
+        return microshERRPAR;
+    }
+
+    ch.mrl = mrl;
+    ch.len = 0;
+
+    prv_put(&ch, "{\"version\":\"" _MANIFEST_VERSION "\",");
+#if MICROSH_CFG_CONSOLE_SESSIONS
+    {
+        char num_str[21];
+
+        prv_put(&ch, "\"login_type\":");
+        prv_put(&ch, microsh_u64_to_str(microsh_session_term_login_type(msh, mrl), num_str));
+        prv_put(&ch, ",");
+    }
+#endif /* MICROSH_CFG_CONSOLE_SESSIONS */
+    prv_put(&ch, "\"cmds\":[");
+    for (size_t i = 0; i < msh->cmds_index; ++i) {
+        prv_put(&ch, i > 0 ? "," MICRORL_CFG_END_LINE : MICRORL_CFG_END_LINE);
+        prv_cmd_put(&ch, &msh->cmds[i]);
+#if MICROSH_CFG_PIPES
+        /* Do not build manifest dropped by pipe filters */
+        if (microsh_pipe_stopped(msh)) {
+            prv_flush(&ch);
+            return microshOK;
+        }
+#endif /* MICROSH_CFG_PIPES */
+    }
+    prv_put(&ch, "]}" MICRORL_CFG_END_LINE);
+    prv_flush(&ch);
+
+    return microshOK;
+}
+
+/**
+ * \brief           Built-in command to print manifest of registered commands
+ * \note            Register it with \ref microsh_cmd_register using `1` as maximum
+ *                      number of arguments. See \ref microsh_manifest_print for format
+ * \param[in]       msh: microSH instance
+ * \param[in]       argc: argument count
+ * \param[in]       argv: pointer array to token string
+ * \return          \ref microshEXEC_OK on success, member of
+ *                      \ref microsh_execr_t enumeration otherwise
+ */
+int microsh_manifest_cmd(microsh_t* msh, int argc, const char* const *argv) {
+    MICROSH_UNUSED(argc);
+    MICROSH_UNUSED(argv);
+
+    return microsh_manifest_print(msh, microsh_get_mrl(msh)) == microshOK ? microshEXEC_OK : microshEXEC_ERROR;
+}
+
+/**
+ * \brief           Put command object with its subcommands
+ * \param[in,out]   ch: Output chunk
+ * \param[in]       cmd: Command or subcommand
+ */
+static void prv_cmd_put(prv_chunk_t* ch, const microsh_cmd_t* cmd) {
+    char num_str[21];
+
+    prv_put(ch, "{\"name\":");
+    prv_str_put(ch, cmd->name);
+    prv_put(ch, ",\"args\":");
+    prv_put(ch, microsh_u64_to_str(cmd->arg_num, num_str));
+    if (cmd->desc != NULL) {
+        prv_put(ch, ",\"desc\":");
+        prv_str_put(ch, cmd->desc);
+    }
+    if (cmd->cmd_fn == NULL) {
+        prv_put(ch, ",\"exec\":false");
+    }
+#if MICROSH_CFG_ARG_SCHEMA
+    if (cmd->schema != NULL) {
+        prv_put(ch, ",\"schema\":");
+        prv_schema_put(ch, cmd->schema);
+    }
+#endif /* MICROSH_CFG_ARG_SCHEMA */
+#if MICROSH_CFG_SUBCMDS
+    if (cmd->subcmds != NULL) {
+        prv_put(ch, ",\"sub\":[");
+        for (size_t i = 0; i < cmd->subcmds_num; ++i) {
+            if (i > 0) {
+                prv_put_char(ch, ',');
+            }
+            /* Nesting depth is limited by application tables */
+            prv_cmd_put(ch, &cmd->subcmds[i]);
+        }
+        prv_put_char(ch, ']');
+    }
+#endif /* MICROSH_CFG_SUBCMDS */
+    prv_put_char(ch, '}');
+}
+
+#if MICROSH_CFG_ARG_SCHEMA
+/**
+ * \brief           Put arguments schema object
+ * \param[in,out]   ch: Output chunk
+ * \param[in]       schema: Command arguments schema
+ */
+static void prv_schema_put(prv_chunk_t* ch, const microsh_arg_schema_t* schema) {
+    static const char* const type_names[] = { "str", "u32", "i32", "hex", "enum" };
+    char num_str[21];
+
+    prv_put(ch, "{\"min\":");
+    prv_put(ch, microsh_u64_to_str(schema->min_num, num_str));
+    prv_put(ch, ",\"args\":[");
+    for (size_t i = 0; i < schema->num; ++i) {
+        const microsh_arg_t* arg = &schema->args[i];
+
+        prv_put(ch, i > 0 ? ",{\"type\":\"" : "{\"type\":\"");
+        prv_put(ch, (size_t)arg->type < MICROSH_ARRAYSIZE(type_names) ? type_names[arg->type] : "?");
+        prv_put_char(ch, '"');
+        if (arg->min != 0 || arg->max != 0) {
+            prv_put(ch, ",\"min\":");
+            prv_i64_put(ch, arg->min);
+            prv_put(ch, ",\"max\":");
+            prv_i64_put(ch, arg->max);
+        }
+        if (arg->keywords != NULL) {
+            prv_put(ch, ",\"kw\":[");
+            for (size_t k = 0; arg->keywords[k] != NULL; ++k) {
+                if (k > 0) {
+                    prv_put_char(ch, ',');
+                }
+                prv_str_put(ch, arg->keywords[k]);
+            }
+            prv_put_char(ch, ']');
+        }
+        prv_put_char(ch, '}');
+    }
+    prv_put(ch, "]}");
+}
+
+/**
+ * \brief           Put signed decimal value
+ * \param[in,out]   ch: Output chunk
+ * \param[in]       val: Value
+ */
+static void prv_i64_put(prv_chunk_t* ch, int64_t val) {
+    char num_str[21];
+
+    if (val < 0) {
+        prv_put_char(ch, '-');
+    }
+    prv_put(ch, microsh_u64_to_str(val < 0 ? (uint64_t)0 - (uint64_t)val : (uint64_t)val, num_str));
+}
+#endif /* MICROSH_CFG_ARG_SCHEMA */
+
+/**
+ * \brief           Put JSON string with quotes and escaped characters
+ * \param[in,out]   ch: Output chunk
+ * \param[in]       str: String
+ */
+static void prv_str_put(prv_chunk_t* ch, const char* str) {
+    static const char hex[] = "0123456789abcdef";
+
+    prv_put_char(ch, '"');
+    for (; *str != '\0'; ++str) {
+        uint8_t c = (uint8_t)*str;
+
+        if (c == '"' || c == '\\') {
+            prv_put_char(ch, '\\');
+            prv_put_char(ch, (char)c);
+        } else if (c < 0x20) {
+            prv_put(ch, "\\u00");
+            prv_put_char(ch, hex[c >> 4]);
+            prv_put_char(ch, hex[c & 0x0F]);
+        } else {
+            prv_put_char(ch, (char)c);
+        }
+    }
+    prv_put_char(ch, '"');
+}
+
+/**
+ * \brief           Put string as is
+ * \param[in,out]   ch: Output chunk
+ * \param[in]       str: String
+ */
+static void prv_put(prv_chunk_t* ch, const char* str) {
+    for (; *str != '\0'; ++str) {
+        prv_put_char(ch, *str);
+    }
+}
+
+/**
+ * \brief           Put character, full chunk is printed
+ * \param[in,out]   ch: Output chunk
+ * \param[in]       c: Character
+ */
+static void prv_put_char(prv_chunk_t* ch, char c) {
+    ch->buf[ch->len++] = c;
+    if (ch->len == MICROSH_CFG_MANIFEST_CHUNK_LEN) {
+        prv_flush(ch);
+    }
+}
+
+/**
+ * \brief           Print filled part of chunk
+ * \param[in,out]   ch: Output chunk
+ */
+static void prv_flush(prv_chunk_t* ch) {
+    if (ch->len > 0) {
+        ch->buf[ch->len] = '\0';
+        ch->mrl->out_fn(ch->mrl, ch->buf);
+        ch->len = 0;
+    }
+}
+
+#endif /* MICROSH_CFG_MANIFEST */
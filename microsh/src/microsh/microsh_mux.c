@@ -0,0 +1,273 @@
+/**
+ * \file            microsh_mux.c
+ * \brief           microSH virtual channels multiplexer
+ */
+
+/*
+ * Copyright (c) 2022 Dmitry KARASEV
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * This file is part of microSH - Shell for Embedded Systems library.
+ *
+ * Author:          Dmitry KARASEV <karasevsdmitry@yandex.ru>
+ * Version:         2.0.0-dev
+ */
+
+#include <stdint.h>
+#include <string.h>
+#include "microsh.h"
+#include "microsh_mux.h"
+
+#if MICROSH_CFG_MUX
+
+/* Encoded frame buffer length: every byte may be escaped, plus two delimiters */
+#define _MUX_TX_FRAME_LEN           ((MICROSH_CFG_MUX_MAX_PAYLOAD + 2) * 2 + 2)
+
+/* Received frame is being dropped until next delimiter */
+#define _MUX_RX_DROP                SIZE_MAX
+
+static uint8_t prv_crc8(uint8_t crc, uint8_t byte);
+static size_t  prv_put_escaped(uint8_t* frame, size_t pos, uint8_t byte);
+
+/**
+ * \brief           Init multiplexer instance
+ * \param[in,out]   mux: Multiplexer instance
+ * \param[in]       tx_fn: Transport write function
+ * \param[in]       arg: User argument for transport
+ * \return          \ref microshOK on success, member of \ref microshr_t otherwise
+ */
+microshr_t microsh_mux_init(microsh_mux_t* mux, microsh_mux_tx_fn tx_fn, void* arg) {
+    if (mux == NULL || tx_fn == NULL) {
+        return microshERRPAR;
+    }
+
+    memset(mux, 0x00, sizeof(microsh_mux_t));
+    mux->tx_fn = tx_fn;
+    mux->arg = arg;
+
+    return microshOK;
+}
+
+/**
+ * \brief           Configure virtual channel
+ * \param[in,out]   mux: Multiplexer instance
+ * \param[in]       ch: Channel index
+ * \param[in]       prio: Channel transmit priority, `0` is the highest.
+ *                      Channels with equal priority are served in index order
+ * \param[in]       rx_fn: Received data callback. Set to `NULL` to drop received data
+ * \param[in]       arg: User argument for received data callback
+ * \return          \ref microshOK on success, member of \ref microshr_t otherwise
+ */
+microshr_t microsh_mux_channel_set(microsh_mux_t* mux, uint8_t ch, uint8_t prio,
+                                       microsh_mux_rx_fn rx_fn, void* arg) {
+    if (mux == NULL || ch >= MICROSH_CFG_MUX_CHANNELS) {
+        return microshERRPAR;
+    }
+
+    mux->ch[ch].prio = prio;
+    mux->ch[ch].rx_fn = rx_fn;
+    mux->ch[ch].arg = arg;
+
+    return microshOK;
+}
+
+/**
+ * \brief           Queue data to channel transmit queue
+ * \note            Function never blocks. Data is sent by \ref microsh_mux_process
+ * \param[in,out]   mux: Multiplexer instance
+ * \param[in]       ch: Channel index
+ * \param[in]       data: Data to send
+ * \param[in]       len: Data length
+ * \return          Number of queued bytes, less than `len` if queue is full
+ */
+size_t microsh_mux_write(microsh_mux_t* mux, uint8_t ch, const void* data, size_t len) {
+    microsh_mux_ch_t* c;
+    const uint8_t* d = data;
+    size_t i;
+
+    if (mux == NULL || data == NULL || ch >= MICROSH_CFG_MUX_CHANNELS) {
+        return 0;
+    }
+
+    c = &mux->ch[ch];
+    for (i = 0; i < len && c->tx_w - c->tx_r < MICROSH_CFG_MUX_TX_BUF_LEN; ++i) {
+        c->tx_buf[c->tx_w++ % MICROSH_CFG_MUX_TX_BUF_LEN] = d[i];
+    }
+
+    return i;
+}
+
+/**
+ * \brief           Process data received from transport
+ * \note            Payload of every valid frame is passed to its channel callback,
+ *                      e.g. \ref microsh_mux_shell_rx for shell channel
+ * \param[in,out]   mux: Multiplexer instance
+ * \param[in]       data: Received data
+ * \param[in]       len: Data length
+ * \return          \ref microshOK on success, member of \ref microshr_t otherwise
+ */
+microshr_t microsh_mux_input(microsh_mux_t* mux, const void* data, size_t len) {
+    const uint8_t* d = data;
+
+    if (mux == NULL || data == NULL) {
+        return microshERRPAR;
+    }
+
+    for (size_t i = 0; i < len; ++i) {
+        uint8_t byte = d[i];
+
+        if (byte == MICROSH_MUX_FLAG) {
+            /* Frame end: channel, payload and CRC */
+            if (mux->rx_len != _MUX_RX_DROP && mux->rx_len >= 2) {
+                uint8_t crc = 0;
+
+                for (size_t j = 0; j < mux->rx_len - 1; ++j) {
+                    crc = prv_crc8(crc, mux->rx_frame[j]);
+                }
+
+                if (crc == mux->rx_frame[mux->rx_len - 1] && mux->rx_frame[0] < MICROSH_CFG_MUX_CHANNELS) {
+                    microsh_mux_ch_t* c = &mux->ch[mux->rx_frame[0]];
+
+                    if (c->rx_fn != NULL) {
+                        c->rx_fn(c->arg, &mux->rx_frame[1], mux->rx_len - 2);
+                    }
+                } else {
+                    ++mux->rx_errors;
+                }
+            } else if (mux->rx_len == _MUX_RX_DROP) {
+                ++mux->rx_errors;
+            }
+            mux->rx_len = 0;
+            mux->rx_esc = 0;
+            continue;
+        }
+
+        if (mux->rx_len == _MUX_RX_DROP) {
+            continue;
+        }
+
+        if (byte == MICROSH_MUX_ESC) {
+            mux->rx_esc = 1;
+            continue;
+        }
+        if (mux->rx_esc) {
+            byte ^= 0x20;
+            mux->rx_esc = 0;
+        }
+
+        if (mux->rx_len < sizeof(mux->rx_frame)) {
+            mux->rx_frame[mux->rx_len++] = byte;
+        } else {
+            mux->rx_len = _MUX_RX_DROP;
+        }
+    }
+
+    return microshOK;
+}
+
+/**
+ * \brief           Send one frame of the highest priority channel with queued data
+ * \note            Call this function while transport is able to accept data.
+ *                      Lower priority channels use bandwidth left by higher priority ones
+ * \param[in,out]   mux: Multiplexer instance
+ * \return          \ref microshOK if frame was sent, \ref microshERR if no data
+ *                      is queued, member of \ref microshr_t otherwise
+ */
+microshr_t microsh_mux_process(microsh_mux_t* mux) {
+    uint8_t frame[_MUX_TX_FRAME_LEN];
+    microsh_mux_ch_t* c = NULL;
+    size_t len = 0, n;
+    uint8_t ch = 0, crc;
+
+    if (mux == NULL) {
+        return microshERRPAR;
+    }
+
+    for (uint8_t i = 0; i < MICROSH_CFG_MUX_CHANNELS; ++i) {
+        if (mux->ch[i].tx_w != mux->ch[i].tx_r && (c == NULL || mux->ch[i].prio < c->prio)) {
+            c = &mux->ch[i];
+            ch = i;
+        }
+    }
+    if (c == NULL) {
+        return microshERR;
+    }
+
+    frame[len++] = MICROSH_MUX_FLAG;
+    crc = prv_crc8(0, ch);
+    len = prv_put_escaped(frame, len, ch);
+    for (n = 0; n < MICROSH_CFG_MUX_MAX_PAYLOAD && c->tx_r != c->tx_w; ++n) {
+        uint8_t byte = c->tx_buf[c->tx_r++ % MICROSH_CFG_MUX_TX_BUF_LEN];
+
+        crc = prv_crc8(crc, byte);
+        len = prv_put_escaped(frame, len, byte);
+    }
+    len = prv_put_escaped(frame, len, crc);
+    frame[len++] = MICROSH_MUX_FLAG;
+
+    mux->tx_fn(mux, frame, len);
+
+    return microshOK;
+}
+
+/**
+ * \brief           Received data callback for shell channel
+ * \note            Use it in \ref microsh_mux_channel_set with \ref microsh_t instance as argument
+ * \param[in]       arg: microSH instance
+ * \param[in]       data: Received payload
+ * \param[in]       len: Payload length
+ */
+void microsh_mux_shell_rx(void* arg, const uint8_t* data, size_t len) {
+    microsh_t* msh = arg;
+
+#if MICROSH_CFG_HISTORY
+    microsh_hist_input(msh, &msh->mrl, data, len);
+#else
+    microrl_processing_input(&msh->mrl, data, len);
+#endif /* MICROSH_CFG_HISTORY */
+}
+
+/**
+ * \brief           Update CRC-8 (polynomial `0x07`) with one byte
+ * \param[in]       crc: Current CRC value
+ * \param[in]       byte: Data byte
+ * \return          Updated CRC value
+ */
+static uint8_t prv_crc8(uint8_t crc, uint8_t byte) {
+    crc ^= byte;
+    for (uint8_t i = 0; i < 8; ++i) {
+        crc = (uint8_t)((crc & 0x80) ? (crc << 1) ^ 0x07 : crc << 1);
+    }
+
+    return crc;
+}
+
+/**
+ * \brief           Put byte to frame with escaping of delimiter and escape bytes
+ * \param[out]      frame: Frame buffer
+ * \param[in]       pos: Current frame length
+ * \param[in]       byte: Byte to put
+ * \return          New frame length
+ */
+static size_t prv_put_escaped(uint8_t* frame, size_t pos, uint8_t byte) {
+    if (byte == MICROSH_MUX_FLAG || byte == MICROSH_MUX_ESC) {
+        frame[pos++] = MICROSH_MUX_ESC;
+        byte ^= 0x20;
+    }
+    frame[pos++] = byte;
+
+    return pos;
+}
+
+#endif /* MICROSH_CFG_MUX */
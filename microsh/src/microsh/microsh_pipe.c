@@ -0,0 +1,214 @@
+/**
+ * \file            microsh_pipe.c
+ * \brief           microSH command output pipes
+ */
+
+/*
+ * Copyright (c) 2022 Dmitry KARASEV
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * This file is part of microSH - Shell for Embedded Systems library.
+ *
+ * Author:          Dmitry KARASEV <karasevsdmitry@yandex.ru>
+ * Version:         2.0.0-dev
+ */
+
+#include <stdint.h>
+#include <string.h>
+#include "microsh.h"
+#include "microsh_priv.h"
+
+#if MICROSH_CFG_PIPES
+
+/* Number of lines passed by `head` filter without argument */
+#define _HEAD_DEFAULT_LINES         10
+
+static uint8_t prv_stage_parse(microsh_pipe_stage_t* stage, int argc, const char* const *argv);
+static void    prv_line_pass(microsh_pipe_t* pipe, size_t first, const char* line);
+
+/**
+ * \brief           Parse filters and redirect terminal output to them
+ * \param[out]      pipe: Pipe instance
+ * \param[in,out]   mrl: \ref microrl_t working instance of terminal
+ * \param[in]       pipe_fn: Output callback to set to terminal, it must pass
+ *                      output to \ref microsh_pipe_write
+ * \param[in]       argc: Number of filters tokens
+ * \param[in]       argv: Filters tokens following the first `|` token
+ * \return          \ref microshEXEC_OK on success, \ref microshEXEC_ERROR_BAD_PIPE otherwise
+ */
+int microsh_pipe_open(microsh_pipe_t* pipe, microrl_t* mrl, microrl_output_fn pipe_fn,
+                        int argc, const char* const *argv) {
+    int start = 0;
+
+    memset(pipe, 0x00, sizeof(*pipe));
+    for (int i = 0; i <= argc; ++i) {
+        if (i < argc && !(argv[i][0] == '|' && argv[i][1] == '\0')) {
+            continue;
+        }
+        if (pipe->stages_num >= MICROSH_ARRAYSIZE(pipe->stages)
+                || !prv_stage_parse(&pipe->stages[pipe->stages_num], i - start, &argv[start])) {
+            return microshEXEC_ERROR_BAD_PIPE;
+        }
+        ++pipe->stages_num;
+        start = i + 1;
+    }
+
+    /* `head 0` passes no command output, unless `count` before it has own output */
+    for (size_t i = 0; i < pipe->stages_num && pipe->stages[i].type != microshPIPE_COUNT; ++i) {
+        if (pipe->stages[i].type == microshPIPE_HEAD && pipe->stages[i].limit == 0) {
+            pipe->stopped = 1;
+        }
+    }
+
+    pipe->mrl = mrl;
+    pipe->out_fn = mrl->out_fn;
+    mrl->out_fn = pipe_fn;
+
+    return microshEXEC_OK;
+}
+
+/**
+ * \brief           Pass command output to filters
+ * \note            Complete lines are filtered as soon as they are written,
+ *                      output is dropped after pipe has been stopped
+ * \param[in,out]   pipe: Pipe instance
+ * \param[in]       str: Output string
+ * \return          The number of characters written
+ */
+int microsh_pipe_write(microsh_pipe_t* pipe, const char* str) {
+    const char* s = str;
+
+    for (; *s != '\0' && !pipe->stopped; ++s) {
+        pipe->line[pipe->len++] = *s;
+        if (*s == '\n' || pipe->len == MICROSH_ARRAYSIZE(pipe->line) - 1) {
+            pipe->line[pipe->len] = '\0';
+            pipe->len = 0;
+            prv_line_pass(pipe, 0, pipe->line);
+        }
+    }
+
+    return (int)strlen(str);
+}
+
+/**
+ * \brief           Flush the last line, print counters and restore terminal output
+ * \param[in,out]   pipe: Pipe instance
+ */
+void microsh_pipe_close(microsh_pipe_t* pipe) {
+    if (pipe->len > 0 && !pipe->stopped) {
+        pipe->line[pipe->len] = '\0';
+        prv_line_pass(pipe, 0, pipe->line);
+    }
+
+    /* Number of lines is output of `count` filter for the next filters */
+    for (size_t i = 0; i < pipe->stages_num; ++i) {
+        if (pipe->stages[i].type == microshPIPE_COUNT) {
+            microsh_u64_to_str(pipe->stages[i].lines, pipe->line);
+            strcat(pipe->line, MICRORL_CFG_END_LINE);
+            prv_line_pass(pipe, i + 1, pipe->line);
+        }
+    }
+
+    pipe->mrl->out_fn = pipe->out_fn;
+    pipe->mrl = NULL;
+    pipe->stopped = 0;
+}
+
+/**
+ * \brief           Parse filter tokens
+ * \param[out]      stage: Filter stage
+ * \param[in]       argc: Number of filter tokens
+ * \param[in]       argv: Filter tokens
+ * \return          `1` on success, `0` on unknown filter or wrong arguments
+ */
+static uint8_t prv_stage_parse(microsh_pipe_stage_t* stage, int argc, const char* const *argv) {
+    if (argc == 0) {
+        return 0;
+    }
+
+    if (strcmp(argv[0], "grep") == 0) {
+        uint8_t inv = argc == 3 && strcmp(argv[1], "-v") == 0;
+
+        if (argc != 2 + inv) {
+            return 0;
+        }
+        stage->type = inv ? microshPIPE_GREP_V : microshPIPE_GREP;
+        stage->text = argv[1 + inv];
+    } else if (strcmp(argv[0], "head") == 0) {
+        if (argc > 2) {
+            return 0;
+        }
+        stage->type = microshPIPE_HEAD;
+        stage->limit = _HEAD_DEFAULT_LINES;
+        if (argc == 2) {
+            const char* s = argv[1];
+
+            stage->limit = 0;
+            for (; *s >= '0' && *s <= '9' && stage->limit < UINT32_MAX / 10; ++s) {
+                stage->limit = stage->limit * 10 + (uint32_t)(*s - '0');
+            }
+            if (*s != '\0' || s == argv[1]) {
+                return 0;
+            }
+        }
+    } else if (strcmp(argv[0], "count") == 0 && argc == 1) {
+        stage->type = microshPIPE_COUNT;
+    } else {
+        return 0;
+    }
+
+    return 1;
+}
+
+/**
+ * \brief           Pass line through filters and print it if it passes all of them
+ * \param[in,out]   pipe: Pipe instance
+ * \param[in]       first: Index of the first filter to pass line through
+ * \param[in]       line: Line string with line ending
+ */
+static void prv_line_pass(microsh_pipe_t* pipe, size_t first, const char* line) {
+    for (size_t i = first; i < pipe->stages_num; ++i) {
+        microsh_pipe_stage_t* stage = &pipe->stages[i];
+
+        switch (stage->type) {
+            case microshPIPE_GREP:
+            case microshPIPE_GREP_V: {
+                if ((strstr(line, stage->text) != NULL) != (stage->type == microshPIPE_GREP)) {
+                    return;
+                }
+                break;
+            }
+            case microshPIPE_HEAD: {
+                if (stage->lines >= stage->limit) {
+                    return;
+                }
+                /* Command output after the last line is not needed, `count` before stops lines earlier */
+                if (++stage->lines == stage->limit && first == 0) {
+                    pipe->stopped = 1;
+                }
+                break;
+            }
+            case microshPIPE_COUNT: {
+                ++stage->lines;
+                return;
+            }
+            default:
+                break;
+        }
+    }
+
+    pipe->out_fn(pipe->mrl, line);
+}
+
+#endif /* MICROSH_CFG_PIPES */
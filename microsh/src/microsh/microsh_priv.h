@@ -0,0 +1,149 @@
+/**
+ * \file            microsh_priv.h
+ * \brief           microSH library internal functions shared between modules
+ */
+
+/*
+ * Copyright (c) 2022 Dmitry KARASEV
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * This file is part of microSH - Shell for Embedded Systems library.
+ *
+ * Author:          Dmitry KARASEV <karasevsdmitry@yandex.ru>
+ * Version:         2.0.0-dev
+ */
+
+#ifndef MICROSH_HDR_PRIV_H
+#define MICROSH_HDR_PRIV_H
+
+#include "microsh.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+/* Argument of message of level is kept only if level is not filtered out */
+#if MICROSH_CFG_LOG_LEVEL >= MICROSH_LOG_LEVEL_ERROR
+#define MICROSH_MSG_LVL_MICROSH_LOG_LEVEL_ERROR(x)  x
+#else
+#define MICROSH_MSG_LVL_MICROSH_LOG_LEVEL_ERROR(x)
+#endif /* MICROSH_CFG_LOG_LEVEL >= MICROSH_LOG_LEVEL_ERROR */
+#if MICROSH_CFG_LOG_LEVEL >= MICROSH_LOG_LEVEL_WARN
+#define MICROSH_MSG_LVL_MICROSH_LOG_LEVEL_WARN(x)   x
+#else
+#define MICROSH_MSG_LVL_MICROSH_LOG_LEVEL_WARN(x)
+#endif /* MICROSH_CFG_LOG_LEVEL >= MICROSH_LOG_LEVEL_WARN */
+#if MICROSH_CFG_LOG_LEVEL >= MICROSH_LOG_LEVEL_INFO
+#define MICROSH_MSG_LVL_MICROSH_LOG_LEVEL_INFO(x)   x
+#else
+#define MICROSH_MSG_LVL_MICROSH_LOG_LEVEL_INFO(x)
+#endif /* MICROSH_CFG_LOG_LEVEL >= MICROSH_LOG_LEVEL_INFO */
+
+/**
+ * \brief           Print message of shell itself with compile-time log level filtering
+ * \note            Message string is not placed to firmware image if message is filtered
+ *                      out or \ref MICROSH_CFG_LOG_MSG_IDS is enabled. Filtered message
+ *                      is removed by preprocessor, so its string is never compiled
+ * \param[in]       mrl: \ref microrl_t working instance
+ * \param[in]       lvl: Message log level, one of `MICROSH_LOG_LEVEL_x` names, not an expression
+ * \param[in]       id: Message identifier, member of \ref microsh_msg_t
+ * \param[in]       str: Message string literal without line ending
+ */
+#if MICROSH_CFG_LOG_MSG_IDS
+#define MICROSH_MSG(mrl, lvl, id, str)      do {                                            \
+                                                (void)(mrl);                                \
+                                                MICROSH_MSG_LVL_##lvl(microsh_msg_id_print((mrl), (lvl), (id))); \
+                                            } while (0)
+#else
+#define MICROSH_MSG(mrl, lvl, id, str)      do {                                            \
+                                                (void)(mrl);                                \
+                                                MICROSH_MSG_LVL_##lvl((mrl)->out_fn((mrl), str MICRORL_CFG_END_LINE)); \
+                                            } while (0)
+#endif /* MICROSH_CFG_LOG_MSG_IDS */
+
+/**
+ * \brief           Get shell instance of terminal
+ * \param[in]       mrl: \ref microrl_t working instance of own or additional terminal
+ */
+#if MICROSH_CFG_TERMINALS
+/* Both have the same layout of first members */
+#define MICROSH_FROM_MRL(mrl)               (((microsh_term_t*)(mrl))->msh)
+#else
+#define MICROSH_FROM_MRL(mrl)               ((microsh_t*)(mrl))
+#endif /* MICROSH_CFG_TERMINALS */
+
+/* String hash is used by hash tables of enabled modules */
+#define MICROSH_USE_STR_HASH                ((MICROSH_CFG_CONSOLE_SESSIONS && MICROSH_CFG_CRED_HASH_INDEX) || MICROSH_CFG_VARS || MICROSH_CFG_ALIASES)
+
+/* Stored command lines are packed to tokens by enabled modules */
+#define MICROSH_USE_LINE_PACK               (MICROSH_CFG_SCHED || MICROSH_CFG_EVENTS)
+
+char*          microsh_u64_to_str(uint64_t val, char* str);
+int            microsh_cmd_exec(microsh_t* msh, microrl_t* mrl, size_t index, const microsh_cmd_t* run,
+                                    int argc, const char* const *argv);
+#if MICROSH_USE_STR_HASH
+uint32_t       microsh_str_hash(const char* str);
+#endif /* MICROSH_USE_STR_HASH */
+#if MICROSH_USE_LINE_PACK
+int            microsh_line_pack(char* buf, size_t size, const char* line);
+void           microsh_line_unpack(const char* buf, int argc, const char** argv);
+#endif /* MICROSH_USE_LINE_PACK */
+#if MICROSH_CFG_CMD_SEQUENCE
+char           microsh_seq_op(const char* token);
+#endif /* MICROSH_CFG_CMD_SEQUENCE */
+#if MICROSH_CFG_LOG_MSG_IDS
+void           microsh_msg_id_print(microrl_t* mrl, int lvl, microsh_msg_t id);
+#endif /* MICROSH_CFG_LOG_MSG_IDS */
+
+#if MICROSH_CFG_AUDIT_LOG
+void           microsh_audit_push(microsh_t* msh, microsh_audit_event_t event, size_t cmd_index, int result);
+#endif /* MICROSH_CFG_AUDIT_LOG */
+
+#if MICROSH_CFG_ASYNC_LOG
+void           microsh_log_init(microsh_t* msh);
+#endif /* MICROSH_CFG_ASYNC_LOG */
+
+#if MICROSH_CFG_WATCH
+void           microsh_watch_frame_begin(microsh_watch_t* watch);
+void           microsh_watch_frame_end(microsh_watch_t* watch);
+#endif /* MICROSH_CFG_WATCH */
+
+#if MICROSH_CFG_SCHED
+void           microsh_sched_advance(microsh_sched_t* sched, uint32_t now_ms);
+microsh_sched_job_t* microsh_sched_pop(microsh_sched_t* sched);
+void           microsh_sched_done(microsh_sched_t* sched, microsh_sched_job_t* job);
+uint32_t       microsh_sched_deadline(const microsh_sched_t* sched, uint32_t now_ms);
+void           microsh_sched_cancel_term(microsh_sched_t* sched, const microrl_t* mrl);
+#endif /* MICROSH_CFG_SCHED */
+
+#if MICROSH_CFG_EVENTS
+void           microsh_event_init(microsh_t* msh);
+uint8_t        microsh_event_pop(microsh_events_t* ev, uint16_t* id);
+uint8_t        microsh_event_pending(microsh_events_t* ev);
+void           microsh_event_unbind_term(microsh_events_t* ev, const microrl_t* mrl);
+#endif /* MICROSH_CFG_EVENTS */
+
+#if MICROSH_CFG_HISTORY && MICROSH_CFG_CONSOLE_SESSIONS
+int            microsh_session_term_user(microsh_t* msh, microrl_t* mrl);
+#endif /* MICROSH_CFG_HISTORY && MICROSH_CFG_CONSOLE_SESSIONS */
+
+#if MICROSH_CFG_MANIFEST && MICROSH_CFG_CONSOLE_SESSIONS
+uint32_t       microsh_session_term_login_type(microsh_t* msh, microrl_t* mrl);
+#endif /* MICROSH_CFG_MANIFEST && MICROSH_CFG_CONSOLE_SESSIONS */
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* MICROSH_HDR_PRIV_H */
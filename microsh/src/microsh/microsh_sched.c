@@ -0,0 +1,686 @@
+/**
+ * \file            microsh_sched.c
+ * \brief           microSH scheduler of deferred and periodic commands
+ */
+
+/*
+ * Copyright (c) 2022 Dmitry KARASEV
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * This file is part of microSH - Shell for Embedded Systems library.
+ *
+ * Author:          Dmitry KARASEV <karasevsdmitry@yandex.ru>
+ * Version:         2.0.0-dev
+ */
+
+
+#include <stdint.h>
+#include <string.h>
+#include "microsh.h"
+#include "microsh_priv.h"
+
+#if MICROSH_CFG_SCHED
+
+#define _SLOT_BITS                  MICROSH_CFG_SCHED_WHEEL_BITS
+#define _SLOTS                      (1UL << _SLOT_BITS)
+#define _SLOT_MASK                  (_SLOTS - 1)
+#define _LEVELS                     MICROSH_CFG_SCHED_WHEEL_LEVELS
+
+/* List of expired jobs follows wheel slots */
+#define _EXPIRED                    (_LEVELS << _SLOT_BITS)
+
+/* Maximum delay in ticks, job must not wrap around the top level */
+#if _SLOT_BITS * _LEVELS >= 31
+#define _MAX_TICKS                  0x7FFFFFFFUL
+#else
+#define _MAX_TICKS                  ((1UL << (_SLOT_BITS * _LEVELS)) - 1)
+#endif /* _SLOT_BITS * _LEVELS >= 31 */
+
+/* Job states */
+#define _JOB_FREE                   0
+#define _JOB_WAIT                   1
+#define _JOB_RUN                    2
+#define _JOB_CANCEL                 3
+
+static microshr_t prv_add(microsh_t* msh, microrl_t* mrl, uint32_t delay_ms, uint32_t period_ms,
+                            microsh_sched_job_t** job_out);
+static microshr_t prv_add_line(microsh_t* msh, microrl_t* mrl, uint32_t delay_ms, uint32_t period_ms,
+                                const char* line, microsh_sched_job_t** job_out);
+static void    prv_release(microsh_sched_t* sched, microsh_sched_job_t* job);
+static void    prv_link(microsh_sched_t* sched, microsh_sched_job_t* job, uint16_t list);
+static void    prv_unlink(microsh_sched_t* sched, microsh_sched_job_t* job);
+static void    prv_insert(microsh_sched_t* sched, microsh_sched_job_t* job);
+static void    prv_step(microsh_sched_t* sched);
+static uint8_t prv_parse_time(const char* str, uint32_t* ms);
+static int     prv_add_cmd(microsh_t* msh, int argc, const char* const *argv, uint8_t periodic);
+
+/**
+ * \brief           Schedule command line
+ * \note            Job added by application runs on own terminal of shell and is
+ *                      kept across log outs. Jobs added by `at` and `every` commands
+ *                      belong to their terminal and are cancelled at its log out
+ * \param[in,out]   msh: microSH instance
+ * \param[in]       delay_ms: Time until the first run in milliseconds
+ * \param[in]       period_ms: Period of the next runs in milliseconds, `0` for single run
+ * \param[in]       line: Command line with tokens separated by spaces
+ * \param[out]      id: Identifier of added job for \ref microsh_sched_cancel. May be `NULL`
+ * \return          \ref microshOK on success, \ref microshERRMEM if no free job or line
+ *                      does not fit to job, member of \ref microshr_t otherwise
+ */
+microshr_t microsh_sched_add(microsh_t* msh, uint32_t delay_ms, uint32_t period_ms, const char* line,
+                                uint8_t* id) {
+    microsh_sched_job_t* job;
+    microshr_t res;
+
+    if (msh == NULL || line == NULL) {
+        return microshERRPAR;
+    }
+
+    res = prv_add_line(msh, NULL, delay_ms, period_ms, line, &job);
+    if (res == microshOK && id != NULL) {
+        *id = (uint8_t)(job - msh->sched.jobs + 1);
+    }
+
+    return res;
+}
+
+#if MICROSH_CFG_SCRIPT || __DOXYGEN__
+/**
+ * \brief           Schedule compiled script
+ * \note            Script must stay valid until job is finished or cancelled
+ * \param[in,out]   msh: microSH instance
+ * \param[in]       delay_ms: Time until the first run in milliseconds
+ * \param[in]       period_ms: Period of the next runs in milliseconds, `0` for single run
+ * \param[in]       script: Compiled script
+ * \param[out]      id: Identifier of added job for \ref microsh_sched_cancel. May be `NULL`
+ * \return          \ref microshOK on success, \ref microshERRMEM if no free job,
+ *                      member of \ref microshr_t otherwise
+ */
+microshr_t microsh_sched_add_script(microsh_t* msh, uint32_t delay_ms, uint32_t period_ms,
+                                    const microsh_script_t* script, uint8_t* id) {
+    microsh_sched_job_t* job;
+    microshr_t res;
+
+    if (msh == NULL || script == NULL) {
+        return microshERRPAR;
+    }
+
+    res = prv_add(msh, NULL, delay_ms, period_ms, &job);
+    if (res != microshOK) {
+        return res;
+    }
+
+    job->script = script;
+    if (id != NULL) {
+        *id = (uint8_t)(job - msh->sched.jobs + 1);
+    }
+
+    return microshOK;
+}
+#endif /* MICROSH_CFG_SCRIPT || __DOXYGEN__ */
+
+/**
+ * \brief           Cancel scheduled job
+ * \note            Job being run is finished, periodic job is not run anymore
+ * \param[in,out]   msh: microSH instance
+ * \param[in]       id: Job identifier
+ * \return          \ref microshOK on success, \ref microshERR if there is no such job,
+ *                      member of \ref microshr_t otherwise
+ */
+microshr_t microsh_sched_cancel(microsh_t* msh, uint8_t id) {
+    microsh_sched_t* sched;
+    microsh_sched_job_t* job;
+
+    if (msh == NULL) {
+        return microshERRPAR;
+    }
+
+    sched = &msh->sched;
+    if (id == 0 || id > MICROSH_CFG_SCHED_JOBS) {
+        return microshERR;
+    }
+
+    job = &sched->jobs[id - 1];
+    switch (job->state) {
+        case _JOB_WAIT:
+            prv_unlink(sched, job);
+            prv_release(sched, job);
+            return microshOK;
+        case _JOB_RUN:
+            job->state = _JOB_CANCEL;
+            return microshOK;
+        default:
+            return microshERR;
+    }
+}
+
+/**
+ * \brief           Built-in command to run command once after delay: `at TIME COMMAND...`
+ *
+ * `TIME` is number of seconds, `m` and `h` suffixes set minutes and hours.
+ * Quote command line holding `;`, `&&`, `||` or `|`. Without arguments
+ * scheduled jobs of terminal are printed. Job runs on terminal which added
+ * it and is cancelled at its log out
+ * \note            Register it with \ref microsh_cmd_register using
+ *                      \ref MICRORL_CFG_CMD_TOKEN_NMB as maximum number of arguments
+ * \param[in]       msh: microSH instance
+ * \param[in]       argc: argument count
+ * \param[in]       argv: pointer array to token string
+ * \return          \ref microshEXEC_OK on success, member of
+ *                      \ref microsh_execr_t enumeration otherwise
+ */
+int microsh_sched_at_cmd(microsh_t* msh, int argc, const char* const *argv) {
+    microsh_sched_t* sched = &msh->sched;
+    microrl_t* mrl = microsh_get_mrl(msh);
+    char num_str[21];
+
+    if (argc > 1) {
+        return prv_add_cmd(msh, argc, argv, 0);
+    }
+
+    microsh_sched_advance(sched, msh->now_ms);
+    for (size_t i = 0; i < sched->used; ++i) {
+        const microsh_sched_job_t* job = &sched->jobs[i];
+        uint64_t left;
+
+        /* Jobs of application and other terminals are not shown */
+        if (job->state != _JOB_WAIT || job->mrl != mrl) {
+            continue;
+        }
+
+        /* Time is printed in whole seconds */
+        left = 0;
+        if ((int32_t)(job->expires - sched->tick) > 0) {
+            left = (uint64_t)(job->expires - sched->tick) * MICROSH_CFG_SCHED_TICK_MS - (msh->now_ms - sched->tick_ms);
+        }
+        mrl->out_fn(mrl, microsh_u64_to_str(i + 1, num_str));
+        mrl->out_fn(mrl, "\tin ");
+        mrl->out_fn(mrl, microsh_u64_to_str((left + 500) / 1000, num_str));
+        mrl->out_fn(mrl, "s");
+        if (job->period != 0) {
+            mrl->out_fn(mrl, " every ");
+            mrl->out_fn(mrl, microsh_u64_to_str(((uint64_t)job->period * MICROSH_CFG_SCHED_TICK_MS + 500) / 1000, num_str));
+            mrl->out_fn(mrl, "s");
+        }
+        mrl->out_fn(mrl, "\t");
+#if MICROSH_CFG_SCRIPT
+        if (job->script != NULL) {
+            mrl->out_fn(mrl, "<script>");
+        } else
+#endif /* MICROSH_CFG_SCRIPT */
+        {
+            const char* token = job->line;
+
+            for (uint8_t t = 0; t < job->argc; ++t) {
+                mrl->out_fn(mrl, t > 0 ? " " : "");
+                mrl->out_fn(mrl, token);
+                token += strlen(token) + 1;
+            }
+        }
+        mrl->out_fn(mrl, MICRORL_CFG_END_LINE);
+    }
+
+    return microshEXEC_OK;
+}
+
+/**
+ * \brief           Built-in command to run command periodically: `every TIME COMMAND...`
+ *
+ * The first run is after `TIME`, see \ref microsh_sched_at_cmd for its format
+ * \note            Register it with \ref microsh_cmd_register using
+ *                      \ref MICRORL_CFG_CMD_TOKEN_NMB as maximum number of arguments
+ * \param[in]       msh: microSH instance
+ * \param[in]       argc: argument count
+ * \param[in]       argv: pointer array to token string
+ * \return          \ref microshEXEC_OK on success, member of
+ *                      \ref microsh_execr_t enumeration otherwise
+ */
+int microsh_sched_every_cmd(microsh_t* msh, int argc, const char* const *argv) {
+    return prv_add_cmd(msh, argc, argv, 1);
+}
+
+/**
+ * \brief           Built-in command to cancel scheduled job: `atrm ID`
+ * \note            Register it with \ref microsh_cmd_register using `2` as maximum
+ *                      number of arguments. Only jobs added by the same terminal
+ *                      are cancelled, other jobs are reported as unknown
+ * \param[in]       msh: microSH instance
+ * \param[in]       argc: argument count
+ * \param[in]       argv: pointer array to token string
+ * \return          \ref microshEXEC_OK on success, member of
+ *                      \ref microsh_execr_t enumeration otherwise
+ */
+int microsh_sched_atrm_cmd(microsh_t* msh, int argc, const char* const *argv) {
+    uint32_t id = 0;
+    const char* s;
+
+    if (argc < 2) {
+        return microshEXEC_ERROR_FEW_ARGS;
+    }
+    for (s = argv[1]; *s >= '0' && *s <= '9' && id <= MICROSH_CFG_SCHED_JOBS; ++s) {
+        id = id * 10 + (uint32_t)(*s - '0');
+    }
+    if (*s != '\0' || s == argv[1]) {
+        return microshEXEC_ERROR_BAD_ARG;
+    }
+
+    return id > 0 && id <= MICROSH_CFG_SCHED_JOBS && msh->sched.jobs[id - 1].mrl == microsh_get_mrl(msh)
+            && microsh_sched_cancel(msh, (uint8_t)id) == microshOK ? microshEXEC_OK : microshEXEC_ERROR;
+}
+
+/**
+ * \brief           Move scheduler to shell time, expired jobs are queued to run
+ * \param[in,out]   sched: Scheduler
+ * \param[in]       now_ms: Shell time
+ */
+void microsh_sched_advance(microsh_sched_t* sched, uint32_t now_ms) {
+    /* Empty wheel does not count ticks */
+    if (sched->num == 0) {
+        sched->tick_ms = now_ms;
+        return;
+    }
+
+    while (now_ms - sched->tick_ms >= MICROSH_CFG_SCHED_TICK_MS) {
+        sched->tick_ms += MICROSH_CFG_SCHED_TICK_MS;
+        prv_step(sched);
+    }
+}
+
+/**
+ * \brief           Take the next expired job to run
+ * \note            Return job with \ref microsh_sched_done after its run
+ * \param[in,out]   sched: Scheduler
+ * \return          Expired job, `NULL` if none
+ */
+microsh_sched_job_t* microsh_sched_pop(microsh_sched_t* sched) {
+    microsh_sched_job_t* job;
+
+    if (sched->lists[_EXPIRED] == 0) {
+        return NULL;
+    }
+
+    job = &sched->jobs[sched->lists[_EXPIRED] - 1];
+    prv_unlink(sched, job);
+    job->state = _JOB_RUN;
+
+    return job;
+}
+
+/**
+ * \brief           Finish run of job, periodic job is scheduled again
+ * \note            Missed periods are skipped if shell was not ticked for a long time
+ * \param[in,out]   sched: Scheduler
+ * \param[in,out]   job: Job returned by \ref microsh_sched_pop
+ */
+void microsh_sched_done(microsh_sched_t* sched, microsh_sched_job_t* job) {
+    if (job->state != _JOB_RUN || job->period == 0) {
+        prv_release(sched, job);
+        return;
+    }
+
+    job->expires += job->period;
+    if ((int32_t)(job->expires - sched->tick) <= 0) {
+        job->expires = sched->tick + job->period;
+    }
+    job->state = _JOB_WAIT;
+    prv_insert(sched, job);
+}
+
+/**
+ * \brief           Get time until the next scheduler tick with work to do
+ * \note            Only the first non-empty slot of every level is looked for,
+ *                      time of slot of upper level is time of moving its jobs down
+ * \param[in]       sched: Scheduler
+ * \param[in]       now_ms: Shell time
+ * \return          Milliseconds until the next deadline, \ref MICROSH_NO_DEADLINE if none is pending
+ */
+uint32_t microsh_sched_deadline(const microsh_sched_t* sched, uint32_t now_ms) {
+    uint32_t ticks = UINT32_MAX, elapsed;
+
+    if (sched->num == 0) {
+        return MICROSH_NO_DEADLINE;
+    }
+    if (sched->lists[_EXPIRED] != 0) {
+        return 0;
+    }
+
+    for (uint32_t k = 1; k < _SLOTS; ++k) {
+        if (sched->lists[(sched->tick + k) & _SLOT_MASK] != 0) {
+            ticks = k;
+            break;
+        }
+    }
+    for (uint32_t l = 1; l < _LEVELS; ++l) {
+        uint32_t base = sched->tick >> (_SLOT_BITS * l);
+
+        /* Slot of current turn is reached again after full turn */
+        for (uint32_t k = 1; k <= _SLOTS; ++k) {
+            if (sched->lists[(l << _SLOT_BITS) | ((base + k) & _SLOT_MASK)] != 0) {
+                uint32_t t = ((base + k) << (_SLOT_BITS * l)) - sched->tick;
+
+                ticks = t < ticks ? t : ticks;
+                break;
+            }
+        }
+    }
+
+    /* Only jobs being run are left */
+    if (ticks == UINT32_MAX) {
+        return MICROSH_NO_DEADLINE;
+    }
+    if (ticks > (MICROSH_NO_DEADLINE - 1) / MICROSH_CFG_SCHED_TICK_MS) {
+        return MICROSH_NO_DEADLINE - 1;
+    }
+
+    ticks *= MICROSH_CFG_SCHED_TICK_MS;
+    elapsed = now_ms - sched->tick_ms;
+
+    return ticks > elapsed ? ticks - elapsed : 0;
+}
+
+/**
+ * \brief           Cancel all jobs added by terminal
+ * \param[in,out]   sched: Scheduler
+ * \param[in]       mrl: \ref microrl_t working instance of terminal
+ */
+void microsh_sched_cancel_term(microsh_sched_t* sched, const microrl_t* mrl) {
+    for (size_t i = 0; i < sched->used; ++i) {
+        microsh_sched_job_t* job = &sched->jobs[i];
+
+        if (job->mrl != mrl) {
+            continue;
+        }
+        if (job->state == _JOB_WAIT) {
+            prv_unlink(sched, job);
+            prv_release(sched, job);
+        } else if (job->state == _JOB_RUN) {
+            job->state = _JOB_CANCEL;
+        }
+    }
+}
+
+/**
+ * \brief           Take free job and schedule it
+ * \param[in,out]   msh: microSH instance
+ * \param[in]       mrl: Terminal which adds job, `NULL` for application
+ * \param[in]       delay_ms: Time until the first run in milliseconds
+ * \param[in]       period_ms: Period of the next runs in milliseconds, `0` for single run
+ * \param[out]      job_out: Scheduled job to fill its command
+ * \return          \ref microshOK on success, member of \ref microshr_t otherwise
+ */
+static microshr_t prv_add(microsh_t* msh, microrl_t* mrl, uint32_t delay_ms, uint32_t period_ms,
+                            microsh_sched_job_t** job_out) {
+    microsh_sched_t* sched = &msh->sched;
+    microsh_sched_job_t* job;
+    uint64_t delay, period;
+    uint8_t n;
+
+    if (sched->num == 0) {
+        sched->tick_ms = msh->now_ms;
+    }
+
+    /* Job does not run earlier than asked, time passed in current tick is added */
+    delay = ((uint64_t)delay_ms + (msh->now_ms - sched->tick_ms) + MICROSH_CFG_SCHED_TICK_MS - 1)
+            / MICROSH_CFG_SCHED_TICK_MS;
+    period = ((uint64_t)period_ms + MICROSH_CFG_SCHED_TICK_MS - 1) / MICROSH_CFG_SCHED_TICK_MS;
+    if (delay > _MAX_TICKS || period > _MAX_TICKS) {
+        return microshERRPAR;
+    }
+
+    if (sched->free != 0) {
+        n = sched->free;
+        sched->free = sched->jobs[n - 1].next;
+    } else if (sched->used < MICROSH_CFG_SCHED_JOBS) {
+        n = ++sched->used;
+    } else {
+        return microshERRMEM;
+    }
+
+    job = &sched->jobs[n - 1];
+    memset(job, 0x00, sizeof(*job));
+    job->expires = sched->tick + (uint32_t)delay;
+    job->period = (uint32_t)period;
+    job->mrl = mrl;
+    job->state = _JOB_WAIT;
+    ++sched->num;
+    prv_insert(sched, job);
+    *job_out = job;
+
+    return microshOK;
+}
+
+/**
+ * \brief           Schedule command line split to tokens by spaces
+ * \param[in,out]   msh: microSH instance
+ * \param[in]       mrl: Terminal which adds job, `NULL` for application
+ * \param[in]       delay_ms: Time until the first run in milliseconds
+ * \param[in]       period_ms: Period of the next runs in milliseconds, `0` for single run
+ * \param[in]       line: Command line with tokens separated by spaces
+ * \param[out]      job_out: Scheduled job
+ * \return          \ref microshOK on success, member of \ref microshr_t otherwise
+ */
+static microshr_t prv_add_line(microsh_t* msh, microrl_t* mrl, uint32_t delay_ms, uint32_t period_ms,
+                                const char* line, microsh_sched_job_t** job_out) {
+    char tokens[MICROSH_CFG_SCHED_LINE_LEN];
+    microsh_sched_job_t* job;
+    int argc;
+    microshr_t res;
+
+    /* Line is checked before job is taken */
+    argc = microsh_line_pack(tokens, sizeof(tokens), line);
+    if (argc <= 0) {
+        return argc == 0 ? microshERRPAR : microshERRMEM;
+    }
+
+    res = prv_add(msh, mrl, delay_ms, period_ms, &job);
+    if (res != microshOK) {
+        return res;
+    }
+
+    memcpy(job->line, tokens, sizeof(job->line));
+    job->argc = (uint8_t)argc;
+    *job_out = job;
+
+    return microshOK;
+}
+
+/**
+ * \brief           Return job to pool
+ * \param[in,out]   sched: Scheduler
+ * \param[in,out]   job: Job which is not in any list
+ */
+static void prv_release(microsh_sched_t* sched, microsh_sched_job_t* job) {
+    job->state = _JOB_FREE;
+    job->next = sched->free;
+    sched->free = (uint8_t)(job - sched->jobs + 1);
+    --sched->num;
+}
+
+/**
+ * \brief           Put job to the head of list
+ * \param[in,out]   sched: Scheduler
+ * \param[in,out]   job: Job which is not in any list
+ * \param[in]       list: Index of wheel slot or \ref _EXPIRED
+ */
+static void prv_link(microsh_sched_t* sched, microsh_sched_job_t* job, uint16_t list) {
+    uint8_t n = (uint8_t)(job - sched->jobs + 1);
+
+    job->list = list;
+    job->prev = 0;
+    job->next = sched->lists[list];
+    if (job->next != 0) {
+        sched->jobs[job->next - 1].prev = n;
+    }
+    sched->lists[list] = n;
+}
+
+/**
+ * \brief           Remove job from its list
+ * \param[in,out]   sched: Scheduler
+ * \param[in,out]   job: Job in list
+ */
+static void prv_unlink(microsh_sched_t* sched, microsh_sched_job_t* job) {
+    if (job->prev != 0) {
+        sched->jobs[job->prev - 1].next = job->next;
+    } else {
+        sched->lists[job->list] = job->next;
+    }
+    if (job->next != 0) {
+        sched->jobs[job->next - 1].prev = job->prev;
+    }
+}
+
+/**
+ * \brief           Put job to wheel slot by time left until its run
+ *
+ * Level is chosen by number of ticks left, slot by expiration tick bits of
+ * level. Job which time has come is put to expired list
+ * \param[in,out]   sched: Scheduler
+ * \param[in,out]   job: Job which is not in any list
+ */
+static void prv_insert(microsh_sched_t* sched, microsh_sched_job_t* job) {
+    uint32_t delta = job->expires - sched->tick;
+    uint32_t l = 0;
+
+    if ((int32_t)delta <= 0) {
+        prv_link(sched, job, _EXPIRED);
+        return;
+    }
+
+    while (l + 1 < _LEVELS && (delta >> (_SLOT_BITS * (l + 1))) != 0) {
+        ++l;
+    }
+    prv_link(sched, job, (uint16_t)((l << _SLOT_BITS) | ((job->expires >> (_SLOT_BITS * l)) & _SLOT_MASK)));
+}
+
+/**
+ * \brief           Advance wheel by one tick
+ *
+ * When lower level finishes its turn, jobs of the reached slot of upper
+ * level are moved down. Then jobs of reached slot of the first level expire
+ * \param[in,out]   sched: Scheduler
+ */
+static void prv_step(microsh_sched_t* sched) {
+    uint32_t tick = ++sched->tick;
+    uint16_t list;
+
+    if ((tick & _SLOT_MASK) == 0) {
+        for (uint32_t l = 1; l < _LEVELS; ++l) {
+            uint32_t slot = (tick >> (_SLOT_BITS * l)) & _SLOT_MASK;
+
+            list = (uint16_t)((l << _SLOT_BITS) | slot);
+            while (sched->lists[list] != 0) {
+                microsh_sched_job_t* job = &sched->jobs[sched->lists[list] - 1];
+
+                prv_unlink(sched, job);
+                prv_insert(sched, job);
+            }
+            if (slot != 0) {
+                break;
+            }
+        }
+    }
+
+    list = (uint16_t)(tick & _SLOT_MASK);
+    while (sched->lists[list] != 0) {
+        microsh_sched_job_t* job = &sched->jobs[sched->lists[list] - 1];
+
+        prv_unlink(sched, job);
+        prv_link(sched, job, _EXPIRED);
+    }
+}
+
+/**
+ * \brief           Convert time argument to milliseconds
+ * \param[in]       str: Number of seconds, minutes with `m` suffix or hours with `h` suffix
+ * \param[out]      ms: Time in milliseconds
+ * \return          `1` on success, `0` on wrong format or overflow
+ */
+static uint8_t prv_parse_time(const char* str, uint32_t* ms) {
+    uint64_t val = 0, mult = 1000;
+    const char* s;
+
+    for (s = str; *s >= '0' && *s <= '9' && val <= UINT32_MAX; ++s) {
+        val = val * 10 + (uint64_t)(*s - '0');
+    }
+    if (s == str) {
+        return 0;
+    }
+    if (*s == 'm' || *s == 'h') {
+        mult = *s == 'm' ? 60000 : 3600000;
+        ++s;
+    } else if (*s == 's') {
+        ++s;
+    }
+    if (*s != '\0' || val * mult > UINT32_MAX) {
+        return 0;
+    }
+    *ms = (uint32_t)(val * mult);
+
+    return 1;
+}
+
+/**
+ * \brief           Schedule command line of `at` and `every` commands
+ * \param[in,out]   msh: microSH instance
+ * \param[in]       argc: argument count
+ * \param[in]       argv: pointer array to token string
+ * \param[in]       periodic: `1` to run command periodically, `0` to run it once
+ * \return          \ref microshEXEC_OK on success, member of
+ *                      \ref microsh_execr_t enumeration otherwise
+ */
+static int prv_add_cmd(microsh_t* msh, int argc, const char* const *argv, uint8_t periodic) {
+    microrl_t* mrl = microsh_get_mrl(msh);
+    microsh_sched_job_t* job;
+    uint32_t ms;
+    size_t len = 0;
+    char line[MICROSH_CFG_SCHED_LINE_LEN];
+    char num_str[21];
+
+    if (argc < 3) {
+        return microshEXEC_ERROR_FEW_ARGS;
+    }
+    if (!prv_parse_time(argv[1], &ms) || (periodic && ms == 0)) {
+        return microshEXEC_ERROR_BAD_ARG;
+    }
+
+    /* Joined line is split again, so quoted sequence becomes several tokens */
+    for (int i = 2; i < argc; ++i) {
+        size_t tok_len = strlen(argv[i]);
+
+        if (len + tok_len + 1 > sizeof(line)) {
+            return microshEXEC_ERROR;
+        }
+        memcpy(&line[len], argv[i], tok_len);
+        len += tok_len;
+        line[len++] = i + 1 < argc ? ' ' : '\0';
+    }
+
+    switch (prv_add_line(msh, mrl, ms, periodic ? ms : 0, line, &job)) {
+        case microshOK:
+            break;
+        case microshERRPAR:
+            return microshEXEC_ERROR_BAD_ARG;
+        default:
+            return microshEXEC_ERROR;
+    }
+
+    mrl->out_fn(mrl, "job ");
+    mrl->out_fn(mrl, microsh_u64_to_str((uint64_t)(job - msh->sched.jobs + 1), num_str));
+    mrl->out_fn(mrl, MICRORL_CFG_END_LINE);
+
+    return microshEXEC_OK;
+}
+
+#endif /* MICROSH_CFG_SCHED */
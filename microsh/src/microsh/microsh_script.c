@@ -0,0 +1,624 @@
+/**
+ * \file            microsh_script.c
+ * \brief           microSH compiled command scripts
+ */
+
+/*
+ * Copyright (c) 2022 Dmitry KARASEV
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * This file is part of microSH - Shell for Embedded Systems library.
+ *
+ * Author:          Dmitry KARASEV <karasevsdmitry@yandex.ru>
+ * Version:         2.0.0-dev
+ */
+
+#include <stdint.h>
+#include <string.h>
+#include "microsh.h"
+#include "microsh_priv.h"
+
+#if MICROSH_CFG_SCRIPT
+
+/* Bytecode instructions, 16-bit operands are little endian */
+#define _OP_END                     0x00        /* Stop script */
+#define _OP_CMD                     0x01        /* flags, index:16, depth, path[depth], argc, offsets:16[argc] */
+#define _OP_JMP                     0x02        /* addr:16 */
+#define _OP_JFAIL                   0x03        /* addr:16, jump if the last command failed */
+#define _OP_REPEAT                  0x04        /* count:16, exit addr:16 */
+#define _OP_LOOP                    0x05        /* body addr:16, jump while repeat counter is not zero */
+
+/* Failure of command does not stop script */
+#define _CMD_FLAG_NO_STOP           0x01
+
+/**
+ * \brief           Script block being compiled
+ */
+typedef struct {
+    char type;                                  /*!< `i` for `if`, `e` for `else`, `w` for `while`, `r` for `repeat` */
+    uint16_t patch;                             /*!< Position of jump address to set at block end */
+    uint16_t start;                             /*!< Position to jump back to for loops */
+} prv_block_t;
+
+static size_t     prv_tokenize(char* line, const char** argv);
+static microshr_t prv_emit(microsh_script_t* script, const uint8_t* data, size_t len);
+static microshr_t prv_emit_op(microsh_script_t* script, uint8_t op, uint16_t arg);
+static void       prv_patch(microsh_script_t* script, uint16_t pos, uint16_t val);
+static microshr_t prv_emit_cmd(microsh_t* msh, microsh_script_t* script, uint8_t flags, int argc, const char** argv);
+static microshr_t prv_str_add(microsh_script_t* script, const char* str, uint16_t* offset);
+static uint16_t   prv_get16(const uint8_t* data);
+static uint8_t    prv_verify(microsh_t* msh, const microsh_script_t* script, uint32_t* cmds_sig);
+static uint32_t   prv_checksum(const microsh_script_t* script);
+static uint32_t   prv_fnv(uint32_t hash, const void* data, size_t len);
+
+/**
+ * \brief           Compile script text
+ *
+ * Every line is a command with arguments. Arguments with spaces are quoted with `"`.
+ * Failed command stops script, unless its name is prefixed with `-`. Lines starting
+ * with `#` are comments. Blocks are:
+ *  - `if COMMAND` ... [`else` ...] `end`, branch is selected by command success
+ *  - `while COMMAND` ... `end`, body runs while command succeeds
+ *  - `repeat N` ... `end`, body runs `N` times
+ *
+ * \note            Commands are resolved with registered commands, so all commands
+ *                      used by script must be registered before
+ * \param[in]       msh: microSH instance
+ * \param[out]      script: Compiled script
+ * \param[in]       text: Script text
+ * \param[out]      err_line: Number of line with error starting from `1`. May be `NULL`
+ * \return          \ref microshOK on success, \ref microshERRMEM if script does not fit buffers,
+ *                      \ref microshERRPAR on syntax error or unknown command
+ */
+microshr_t microsh_script_compile(microsh_t* msh, microsh_script_t* script, const char* text, size_t* err_line) {
+    prv_block_t blocks[MICROSH_CFG_SCRIPT_DEPTH];
+    size_t depth = 0, line_num = 0;
+    microshr_t res = microshOK;
+
+    if (msh == NULL || script == NULL || text == NULL) {
+        return microshERRPAR;
+    }
+
+    memset(script, 0x00, sizeof(*script));
+
+    while (*text != '\0' && res == microshOK) {
+        char line[MICRORL_CFG_CMDLINE_LEN];
+        const char* argv[MICRORL_CFG_CMD_TOKEN_NMB + 1];
+        const char* end = strchr(text, '\n');
+        size_t len = end != NULL ? (size_t)(end - text) : strlen(text);
+        size_t argc, skip = strspn(text, " \t");
+
+        ++line_num;
+
+        /* Comments are not limited by line length */
+        if (skip < len && text[skip] == '#') {
+            text += end != NULL ? len + 1 : len;
+            continue;
+        }
+        if (len >= sizeof(line)) {
+            res = microshERRMEM;
+            break;
+        }
+        memcpy(line, text, len);
+        line[len] = '\0';
+        text += end != NULL ? len + 1 : len;
+
+        argc = prv_tokenize(line, argv);
+        if (argc == 0) {
+            continue;
+        }
+        if (argc > MICRORL_CFG_CMD_TOKEN_NMB) {
+            res = microshERRPAR;
+            break;
+        }
+
+        if (strcmp(argv[0], "if") == 0 || strcmp(argv[0], "while") == 0) {
+            if (argc < 2 || depth >= MICROSH_ARRAYSIZE(blocks)) {
+                res = microshERRPAR;
+                break;
+            }
+            blocks[depth].type = argv[0][0];
+            blocks[depth].start = script->code_len;
+            res = prv_emit_cmd(msh, script, _CMD_FLAG_NO_STOP, (int)argc - 1, &argv[1]);
+            blocks[depth].patch = (uint16_t)(script->code_len + 1);
+            if (res == microshOK) {
+                res = prv_emit_op(script, _OP_JFAIL, 0);
+            }
+            ++depth;
+        } else if (strcmp(argv[0], "repeat") == 0) {
+            const char* s = argc == 2 ? argv[1] : "";
+            uint32_t count = 0;
+
+            for (; *s >= '0' && *s <= '9' && count <= UINT16_MAX; ++s) {
+                count = count * 10 + (uint32_t)(*s - '0');
+            }
+            if (argc != 2 || *s != '\0' || s == argv[1] || count > UINT16_MAX
+                    || depth >= MICROSH_ARRAYSIZE(blocks)) {
+                res = microshERRPAR;
+                break;
+            }
+            blocks[depth].type = 'r';
+            blocks[depth].patch = (uint16_t)(script->code_len + 3);
+            res = prv_emit_op(script, _OP_REPEAT, (uint16_t)count);
+            if (res == microshOK) {
+                res = prv_emit(script, (const uint8_t[]){0x00, 0x00}, 2);
+            }
+            blocks[depth++].start = script->code_len;
+        } else if (strcmp(argv[0], "else") == 0) {
+            if (argc != 1 || depth == 0 || blocks[depth - 1].type != 'i') {
+                res = microshERRPAR;
+                break;
+            }
+            res = prv_emit_op(script, _OP_JMP, 0);
+            prv_patch(script, blocks[depth - 1].patch, script->code_len);
+            blocks[depth - 1].type = 'e';
+            blocks[depth - 1].patch = (uint16_t)(script->code_len - 2);
+        } else if (strcmp(argv[0], "end") == 0) {
+            prv_block_t* blk;
+
+            if (argc != 1 || depth == 0) {
+                res = microshERRPAR;
+                break;
+            }
+            blk = &blocks[depth - 1];
+            if (blk->type == 'w') {
+                res = prv_emit_op(script, _OP_JMP, blk->start);
+            } else if (blk->type == 'r') {
+                res = prv_emit_op(script, _OP_LOOP, blk->start);
+            }
+            prv_patch(script, blk->patch, script->code_len);
+            --depth;
+        } else {
+            uint8_t flags = 0;
+
+            if (argv[0][0] == '-' && argv[0][1] != '\0') {
+                ++argv[0];
+                flags = _CMD_FLAG_NO_STOP;
+            }
+            res = prv_emit_cmd(msh, script, flags, (int)argc, argv);
+        }
+    }
+
+    if (res == microshOK && depth > 0) {
+        res = microshERRPAR;
+    }
+    if (res == microshOK) {
+        res = prv_emit(script, (const uint8_t[]){_OP_END}, 1);
+    }
+    if (res == microshOK) {
+        res = prv_verify(msh, script, &script->cmds_sig) ? microshOK : microshERRPAR;
+        script->chk = prv_checksum(script);
+    }
+    if (res != microshOK) {
+        script->code_len = 0;
+        if (err_line != NULL) {
+            *err_line = line_num;
+        }
+    }
+
+    return res;
+}
+
+/**
+ * \brief           Run compiled script
+ * \note            Script commands run without session checks. Output is
+ *                      printed to the terminal of \ref microsh_get_mrl
+ * \param[in,out]   msh: microSH instance
+ * \param[in]       script: Compiled script
+ * \param[out]      failed_cmd: Name of command which stopped script. May be `NULL`
+ * \return          \ref microshEXEC_OK if script is finished, result of command which
+ *                      stopped script or \ref microshEXEC_ERROR if script is corrupted
+ *                      or does not match registered commands otherwise
+ */
+int microsh_script_run(microsh_t* msh, const microsh_script_t* script, const char** failed_cmd) {
+    uint16_t counts[MICROSH_CFG_SCRIPT_DEPTH];
+    const uint8_t* code;
+    microrl_t* mrl;
+    size_t pc = 0, sp = 0;
+    uint32_t cmds_sig;
+    uint8_t failed = 0;
+
+    /* Script may come from storage, nothing of it is trusted before verification */
+    if (msh == NULL || script == NULL || !prv_verify(msh, script, &cmds_sig)
+            || cmds_sig != script->cmds_sig || prv_checksum(script) != script->chk) {
+        return microshEXEC_ERROR;
+    }
+
+    code = script->code;
+    mrl = microsh_get_mrl(msh);
+    while (pc < script->code_len) {
+        switch (code[pc]) {
+            case _OP_END:
+                return microshEXEC_OK;
+            case _OP_CMD: {
+                const char* argv[MICRORL_CFG_CMD_TOKEN_NMB];
+                const microsh_cmd_t* run;
+                uint8_t flags = code[pc + 1];
+                uint16_t index = prv_get16(&code[pc + 2]);
+                uint8_t depth = code[pc + 4];
+                uint8_t argc;
+                int res;
+
+                /* Subcommands are stored as path of indexes in child tables */
+                run = &msh->cmds[index];
+                pc += 5;
+#if MICROSH_CFG_SUBCMDS
+                for (uint8_t d = 0; d < depth; ++d) {
+                    run = &run->subcmds[code[pc++]];
+                }
+#endif /* MICROSH_CFG_SUBCMDS */
+                argc = code[pc++];
+                for (uint8_t i = 0; i < argc; ++i, pc += 2) {
+                    argv[i] = &script->strs[prv_get16(&code[pc])];
+                }
+
+                res = microsh_cmd_exec(msh, mrl, index, run, argc - depth, &argv[depth]);
+                failed = res != microshEXEC_OK;
+                if (failed && !(flags & _CMD_FLAG_NO_STOP)) {
+                    if (failed_cmd != NULL) {
+                        *failed_cmd = argv[0];
+                    }
+                    return res;
+                }
+                break;
+            }
+            case _OP_JMP:
+                pc = prv_get16(&code[pc + 1]);
+                break;
+            case _OP_JFAIL:
+                pc = failed ? prv_get16(&code[pc + 1]) : pc + 3;
+                break;
+            case _OP_REPEAT: {
+                uint16_t count = prv_get16(&code[pc + 1]);
+
+                if (count == 0) {
+                    pc = prv_get16(&code[pc + 3]);
+                } else if (sp >= MICROSH_ARRAYSIZE(counts)) {
+                    return microshEXEC_ERROR;
+                } else {
+                    counts[sp++] = count;
+                    pc += 5;
+                }
+                break;
+            }
+            case _OP_LOOP:
+                if (sp == 0) {
+                    return microshEXEC_ERROR;
+                } else if (--counts[sp - 1] > 0) {
+                    pc = prv_get16(&code[pc + 1]);
+                } else {
+                    --sp;
+                    pc += 3;
+                }
+                break;
+            default:
+                return microshEXEC_ERROR;
+        }
+    }
+
+    return microshEXEC_OK;
+}
+
+/**
+ * \brief           Split script line to arguments in place
+ * \param[in,out]   line: Script line, separators are replaced with `\0`
+ * \param[out]      argv: Array of at least \ref MICRORL_CFG_CMD_TOKEN_NMB + `1` arguments
+ * \return          Number of arguments, \ref MICRORL_CFG_CMD_TOKEN_NMB + `1` if there are more
+ */
+static size_t prv_tokenize(char* line, const char** argv) {
+    size_t argc = 0;
+
+    while (*line != '\0' && argc <= MICRORL_CFG_CMD_TOKEN_NMB) {
+        char sep = ' ';
+
+        if (*line == ' ' || *line == '\t' || *line == '\r') {
+            ++line;
+            continue;
+        }
+        if (*line == '"') {
+            sep = *line++;
+        }
+        argv[argc++] = line;
+        while (*line != '\0' && (sep == '"' ? *line != '"' : (*line != ' ' && *line != '\t' && *line != '\r'))) {
+            ++line;
+        }
+        if (*line != '\0') {
+            *line++ = '\0';
+        }
+    }
+
+    return argc;
+}
+
+/**
+ * \brief           Append data to bytecode
+ * \param[in,out]   script: Script being compiled
+ * \param[in]       data: Bytecode data
+ * \param[in]       len: Data length
+ * \return          \ref microshOK on success, \ref microshERRMEM if there is no space
+ */
+static microshr_t prv_emit(microsh_script_t* script, const uint8_t* data, size_t len) {
+    if (script->code_len + len > sizeof(script->code)) {
+        return microshERRMEM;
+    }
+    memcpy(&script->code[script->code_len], data, len);
+    script->code_len = (uint16_t)(script->code_len + len);
+
+    return microshOK;
+}
+
+/**
+ * \brief           Append instruction with 16-bit operand to bytecode
+ * \param[in,out]   script: Script being compiled
+ * \param[in]       op: Instruction
+ * \param[in]       arg: Operand
+ * \return          \ref microshOK on success, \ref microshERRMEM if there is no space
+ */
+static microshr_t prv_emit_op(microsh_script_t* script, uint8_t op, uint16_t arg) {
+    const uint8_t data[3] = {op, (uint8_t)arg, (uint8_t)(arg >> 8)};
+
+    return prv_emit(script, data, sizeof(data));
+}
+
+/**
+ * \brief           Set 16-bit operand emitted before
+ * \param[in,out]   script: Script being compiled
+ * \param[in]       pos: Operand position, ignored if it is outside of emitted bytecode
+ * \param[in]       val: Operand value
+ */
+static void prv_patch(microsh_script_t* script, uint16_t pos, uint16_t val) {
+    if (pos + 2 <= script->code_len) {
+        script->code[pos] = (uint8_t)val;
+        script->code[pos + 1] = (uint8_t)(val >> 8);
+    }
+}
+
+/**
+ * \brief           Resolve command and append its call to bytecode
+ * \param[in]       msh: microSH instance
+ * \param[in,out]   script: Script being compiled
+ * \param[in]       flags: Call flags
+ * \param[in]       argc: Number of arguments including command name
+ * \param[in]       argv: Arguments
+ * \return          \ref microshOK on success, \ref microshERRMEM if there is no space,
+ *                      \ref microshERRPAR on unknown command or wrong number of arguments
+ */
+static microshr_t prv_emit_cmd(microsh_t* msh, microsh_script_t* script, uint8_t flags, int argc, const char** argv) {
+    uint8_t data[6 + MICRORL_CFG_CMD_TOKEN_NMB * 3];
+    const microsh_cmd_t* cmd;
+    const microsh_cmd_t* run;
+    size_t len = 0;
+    int depth = 0;
+
+#if MICROSH_CFG_SUBCMDS
+    cmd = microsh_cmd_resolve(msh, 1, argv, NULL);
+    run = microsh_cmd_resolve(msh, argc, argv, &depth);
+#else
+    cmd = run = microsh_cmd_find(msh, argv[0]);
+#endif /* MICROSH_CFG_SUBCMDS */
+    if (cmd == NULL || run == NULL || run->cmd_fn == NULL || argc - depth > (int)run->arg_num) {
+        return microshERRPAR;
+    }
+
+    data[len++] = _OP_CMD;
+    data[len++] = flags;
+    data[len++] = (uint8_t)(cmd - msh->cmds);
+    data[len++] = (uint8_t)((cmd - msh->cmds) >> 8);
+    data[len++] = (uint8_t)depth;
+#if MICROSH_CFG_SUBCMDS
+    /* Index of every level in child table of previous one */
+    for (int d = 1; d <= depth; ++d) {
+        const microsh_cmd_t* sub = microsh_cmd_resolve(msh, d + 1, argv, NULL);
+
+        data[len++] = (uint8_t)(sub - cmd->subcmds);
+        cmd = sub;
+    }
+#endif /* MICROSH_CFG_SUBCMDS */
+    data[len++] = (uint8_t)argc;
+    for (int i = 0; i < argc; ++i) {
+        uint16_t offset;
+
+        if (prv_str_add(script, argv[i], &offset) != microshOK) {
+            return microshERRMEM;
+        }
+        data[len++] = (uint8_t)offset;
+        data[len++] = (uint8_t)(offset >> 8);
+    }
+
+    return prv_emit(script, data, len);
+}
+
+/**
+ * \brief           Add argument to pool, equal arguments are kept once
+ * \param[in,out]   script: Script being compiled
+ * \param[in]       str: Argument
+ * \param[out]      offset: Argument offset in pool
+ * \return          \ref microshOK on success, \ref microshERRMEM if there is no space
+ */
+static microshr_t prv_str_add(microsh_script_t* script, const char* str, uint16_t* offset) {
+    size_t len = strlen(str) + 1;
+
+    for (size_t off = 0; off < script->strs_len; off += strlen(&script->strs[off]) + 1) {
+        if (strcmp(&script->strs[off], str) == 0) {
+            *offset = (uint16_t)off;
+            return microshOK;
+        }
+    }
+
+    if (script->strs_len + len > sizeof(script->strs)) {
+        return microshERRMEM;
+    }
+    memcpy(&script->strs[script->strs_len], str, len);
+    *offset = script->strs_len;
+    script->strs_len = (uint16_t)(script->strs_len + len);
+
+    return microshOK;
+}
+
+/**
+ * \brief           Read 16-bit little endian value
+ * \param[in]       data: Pointer to value
+ * \return          Value
+ */
+static uint16_t prv_get16(const uint8_t* data) {
+    return (uint16_t)(data[0] | (data[1] << 8));
+}
+
+/**
+ * \brief           Check that bytecode is well formed and calculate fingerprint of used commands
+ *
+ * Every instruction must fit bytecode, command indexes and subcommand paths must
+ * exist in registered tables of up to `255` subcommands, arguments must fit argument vector and pool,
+ * jumps must point to the first byte of an instruction
+ *
+ * \param[in]       msh: microSH instance
+ * \param[in]       script: Script to check
+ * \param[out]      cmds_sig: Fingerprint of names and positions of used commands
+ * \return          `1` if bytecode is well formed, `0` otherwise
+ */
+static uint8_t prv_verify(microsh_t* msh, const microsh_script_t* script, uint32_t* cmds_sig) {
+    uint8_t starts[(MICROSH_CFG_SCRIPT_CODE_LEN + 7) / 8];
+    const uint8_t* code = script->code;
+    size_t len = script->code_len;
+    uint32_t sig = 2166136261u;
+
+    if (len == 0 || len > sizeof(script->code) || script->strs_len > sizeof(script->strs)
+            || (script->strs_len > 0 && script->strs[script->strs_len - 1] != '\0')) {
+        return 0;
+    }
+
+    /* The first pass checks instructions and marks their positions */
+    memset(starts, 0x00, sizeof(starts));
+    for (size_t pc = 0; pc < len;) {
+        starts[pc / 8] |= (uint8_t)(1 << (pc % 8));
+        switch (code[pc]) {
+            case _OP_END:
+                ++pc;
+                break;
+            case _OP_JMP:
+            case _OP_JFAIL:
+            case _OP_LOOP:
+                pc += 3;
+                break;
+            case _OP_REPEAT:
+                pc += 5;
+                break;
+            case _OP_CMD: {
+                const microsh_cmd_t* run;
+                uint16_t index;
+                uint8_t depth, argc;
+
+                if (pc + 5 > len || (index = prv_get16(&code[pc + 2])) >= msh->cmds_index) {
+                    return 0;
+                }
+                depth = code[pc + 4];
+                run = &msh->cmds[index];
+                sig = prv_fnv(sig, run->name, strlen(run->name) + 1);
+                pc += 5;
+#if MICROSH_CFG_SUBCMDS
+                /* Index in child table is stored in one byte, larger tables are not supported */
+                for (uint8_t d = 0; d < depth; ++d, ++pc) {
+                    if (pc >= len || run->subcmds_num > 255 || code[pc] >= run->subcmds_num) {
+                        return 0;
+                    }
+                    run = &run->subcmds[code[pc]];
+                    sig = prv_fnv(sig, run->name, strlen(run->name) + 1);
+                }
+#else
+                if (depth != 0) {
+                    return 0;
+                }
+#endif /* MICROSH_CFG_SUBCMDS */
+                if (pc >= len || run->cmd_fn == NULL) {
+                    return 0;
+                }
+                argc = code[pc++];
+                if (argc <= depth || argc > MICRORL_CFG_CMD_TOKEN_NMB
+                        || (size_t)(argc - depth) > run->arg_num || pc + 2 * (size_t)argc > len) {
+                    return 0;
+                }
+                for (uint8_t i = 0; i < argc; ++i, pc += 2) {
+                    if (prv_get16(&code[pc]) >= script->strs_len) {
+                        return 0;
+                    }
+                }
+                break;
+            }
+            default:
+                return 0;
+        }
+        if (pc > len) {
+            return 0;
+        }
+    }
+
+    /* The second pass checks jump targets */
+    for (size_t pc = 0; pc < len;) {
+        uint8_t op = code[pc];
+        size_t target = len;
+
+        if (op == _OP_CMD) {
+            pc += 5 + code[pc + 4];
+            pc += 1 + 2 * (size_t)code[pc];
+            continue;
+        }
+        if (op == _OP_JMP || op == _OP_JFAIL || op == _OP_LOOP) {
+            target = prv_get16(&code[pc + 1]);
+        } else if (op == _OP_REPEAT) {
+            target = prv_get16(&code[pc + 3]);
+        }
+        if (op != _OP_END && (target >= len || !(starts[target / 8] & (1 << (target % 8))))) {
+            return 0;
+        }
+        pc += op == _OP_END ? 1 : (op == _OP_REPEAT ? 5 : 3);
+    }
+
+    *cmds_sig = sig;
+    return 1;
+}
+
+/**
+ * \brief           Calculate checksum of script
+ * \note            Lengths must be checked before
+ * \param[in]       script: Script
+ * \return          Checksum
+ */
+static uint32_t prv_checksum(const microsh_script_t* script) {
+    uint32_t hash = 2166136261u;
+
+    hash = prv_fnv(hash, &script->code_len, sizeof(script->code_len));
+    hash = prv_fnv(hash, &script->strs_len, sizeof(script->strs_len));
+    hash = prv_fnv(hash, &script->cmds_sig, sizeof(script->cmds_sig));
+    hash = prv_fnv(hash, script->code, script->code_len);
+    return prv_fnv(hash, script->strs, script->strs_len);
+}
+
+/**
+ * \brief           Continue FNV-1a hash with data
+ * \param[in]       hash: Hash of previous data
+ * \param[in]       data: Data to hash
+ * \param[in]       len: Data length
+ * \return          Hash
+ */
+static uint32_t prv_fnv(uint32_t hash, const void* data, size_t len) {
+    const uint8_t* ptr = data;
+
+    while (len-- > 0) {
+        hash = (hash ^ *ptr++) * 16777619u;
+    }
+
+    return hash;
+}
+
+#endif /* MICROSH_CFG_SCRIPT */
@@ -0,0 +1,203 @@
+/**
+ * \file            microsh_trie.c
+ * \brief           microSH prefix trie of command names
+ */
+
+/*
+ * Copyright (c) 2022 Dmitry KARASEV
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * This file is part of microSH - Shell for Embedded Systems library.
+ *
+ * Author:          Dmitry KARASEV <karasevsdmitry@yandex.ru>
+ * Version:         2.0.0-dev
+ */
+
+#include <stdint.h>
+#include <string.h>
+#include "microsh.h"
+
+#if MICROSH_CFG_CMD_ABBREV
+
+static uint16_t prv_node_find(const microsh_trie_t* trie, const char* key);
+static void    prv_collect(const microsh_trie_t* trie, uint16_t node, uint16_t* values, size_t max, size_t* n);
+
+/**
+ * \brief           Remove all keys from trie
+ * \param[out]      trie: Trie instance
+ */
+void microsh_trie_reset(microsh_trie_t* trie) {
+    memset(&trie->nodes[0], 0x00, sizeof(trie->nodes[0]));
+    trie->len = 1;
+}
+
+/**
+ * \brief           Insert key to trie
+ * \note            Trie is not changed on failure
+ * \param[in,out]   trie: Trie instance
+ * \param[in]       key: Non-empty key string
+ * \param[in]       value: Value of key
+ * \return          \ref microshOK on success, \ref microshERRMEM if nodes pool is full,
+ *                      \ref microshERRPAR if key is already in trie
+ */
+microshr_t microsh_trie_insert(microsh_trie_t* trie, const char* key, uint16_t value) {
+    microsh_trie_node_t* nodes = trie->nodes;
+    uint16_t node = 0;
+    size_t depth = 0, len = strlen(key);
+
+    /* Check for duplicate and for enough free nodes before any change */
+    for (uint16_t c; depth < len; ++depth, node = c) {
+        for (c = nodes[node].child; c != 0 && nodes[c].ch != key[depth]; c = nodes[c].next) {}
+        if (c == 0) {
+            break;
+        }
+    }
+    if (depth == len && nodes[node].end) {
+        return microshERRPAR;
+    }
+    if (len - depth > (size_t)(MICROSH_ARRAYSIZE(trie->nodes) - trie->len)) {
+        return microshERRMEM;
+    }
+
+    node = 0;
+    for (size_t i = 0; i < len; ++i) {
+        uint16_t* link = &nodes[node].child;
+
+        ++nodes[node].count;
+        if (!nodes[node].end) {
+            nodes[node].value = value;
+        }
+
+        /* Keep siblings in character order */
+        while (*link != 0 && (unsigned char)nodes[*link].ch < (unsigned char)key[i]) {
+            link = &nodes[*link].next;
+        }
+        if (*link == 0 || nodes[*link].ch != key[i]) {
+            uint16_t n = trie->len++;
+
+            memset(&nodes[n], 0x00, sizeof(nodes[n]));
+            nodes[n].ch = key[i];
+            nodes[n].next = *link;
+            *link = n;
+        }
+        node = *link;
+    }
+    ++nodes[node].count;
+    nodes[node].end = 1;
+    nodes[node].value = value;
+
+    return microshOK;
+}
+
+/**
+ * \brief           Find exact key in trie
+ * \param[in]       trie: Trie instance
+ * \param[in]       key: Key string
+ * \param[out]      value: Value of key
+ * \return          `1` if key is found, `0` otherwise
+ */
+uint8_t microsh_trie_find(const microsh_trie_t* trie, const char* key, uint16_t* value) {
+    uint16_t node = prv_node_find(trie, key);
+
+    if (node == 0 || !trie->nodes[node].end) {
+        return 0;
+    }
+    *value = trie->nodes[node].value;
+
+    return 1;
+}
+
+/**
+ * \brief           Find key by its exact string or by its unique prefix
+ * \note            Exact key is preferred over longer keys with the same prefix
+ * \param[in]       trie: Trie instance
+ * \param[in]       prefix: Non-empty key or prefix string
+ * \param[out]      value: Value of found key
+ * \return          `1` if key is found, `0` if no key starts with `prefix`,
+ *                      number of keys starting with `prefix` if it is ambiguous
+ */
+size_t microsh_trie_match(const microsh_trie_t* trie, const char* prefix, uint16_t* value) {
+    uint16_t node = prv_node_find(trie, prefix);
+
+    if (node == 0) {
+        return 0;
+    }
+    if (trie->nodes[node].end || trie->nodes[node].count == 1) {
+        *value = trie->nodes[node].value;
+        return 1;
+    }
+
+    return trie->nodes[node].count;
+}
+
+/**
+ * \brief           Get values of all keys starting with prefix in key order
+ * \param[in]       trie: Trie instance
+ * \param[in]       prefix: Prefix string, may be empty
+ * \param[out]      values: Array of values. If there are more than `max` keys,
+ *                      the last element is the value of the last key in order
+ * \param[in]       max: Size of `values` array
+ * \return          Number of keys starting with `prefix`
+ */
+size_t microsh_trie_collect(const microsh_trie_t* trie, const char* prefix, uint16_t* values, size_t max) {
+    uint16_t node = prefix[0] == '\0' ? 0 : prv_node_find(trie, prefix);
+    size_t n = 0;
+
+    if ((node != 0 || prefix[0] == '\0') && max > 0) {
+        prv_collect(trie, node, values, max, &n);
+    }
+
+    return n;
+}
+
+/**
+ * \brief           Find node of the last character of key
+ * \param[in]       trie: Trie instance
+ * \param[in]       key: Non-empty key string
+ * \return          Node index, `0` if there is no such path
+ */
+static uint16_t prv_node_find(const microsh_trie_t* trie, const char* key) {
+    uint16_t node = 0;
+
+    for (; *key != '\0'; ++key) {
+        for (node = trie->nodes[node].child; node != 0 && trie->nodes[node].ch != *key;
+                node = trie->nodes[node].next) {}
+        if (node == 0) {
+            break;
+        }
+    }
+
+    return node;
+}
+
+/**
+ * \brief           Collect values of keys of subtree in key order
+ * \note            Recursion depth is limited by the longest key length
+ * \param[in]       trie: Trie instance
+ * \param[in]       node: Subtree root node
+ * \param[out]      values: Array of values
+ * \param[in]       max: Size of `values` array
+ * \param[in,out]   n: Number of collected keys
+ */
+static void prv_collect(const microsh_trie_t* trie, uint16_t node, uint16_t* values, size_t max, size_t* n) {
+    if (trie->nodes[node].end) {
+        values[*n < max ? *n : max - 1] = trie->nodes[node].value;
+        ++*n;
+    }
+    for (uint16_t c = trie->nodes[node].child; c != 0; c = trie->nodes[c].next) {
+        prv_collect(trie, c, values, max, n);
+    }
+}
+
+#endif /* MICROSH_CFG_CMD_ABBREV */
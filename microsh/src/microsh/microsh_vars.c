@@ -0,0 +1,342 @@
+/**
+ * \file            microsh_vars.c
+ * \brief           microSH shell variables
+ */
+
+/*
+ * Copyright (c) 2022 Dmitry KARASEV
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * This file is part of microSH - Shell for Embedded Systems library.
+ *
+ * Author:          Dmitry KARASEV <karasevsdmitry@yandex.ru>
+ * Version:         2.0.0-dev
+ */
+
+#include <stdint.h>
+#include <string.h>
+#include "microsh.h"
+#include "microsh_priv.h"
+
+#if MICROSH_CFG_VARS
+
+static uint8_t prv_name_char(char c);
+static uint8_t prv_name_valid(const char* name);
+static size_t  prv_slot_find(microsh_vars_t* vars, const char* name);
+
+/**
+ * \brief           Set variable value, create variable if it does not exist
+ * \param[in,out]   msh: microSH instance
+ * \param[in]       name: Variable name of letters, digits and `_`, not starting with digit
+ * \param[in]       value: Variable value
+ * \return          \ref microshOK on success, \ref microshERRMEM if there are no free slots,
+ *                      \ref microshERRPAR on wrong name or too long value
+ */
+microshr_t microsh_var_set(microsh_t* msh, const char* name, const char* value) {
+    microsh_vars_t* vars;
+    size_t slot;
+
+    if (msh == NULL || value == NULL || !prv_name_valid(name)
+            || strlen(value) >= MICROSH_CFG_VAR_VALUE_LEN) {
+        return microshERRPAR;
+    }
+
+    vars = &msh->vars;
+    slot = prv_slot_find(vars, name);
+    if (vars->slots[slot].name[0] == '\0') {
+        /* Keep one slot free to stop probing */
+        if (vars->num >= MICROSH_ARRAYSIZE(vars->slots) - 1) {
+            return microshERRMEM;
+        }
+        strcpy(vars->slots[slot].name, name);
+        ++vars->num;
+    }
+    strcpy(vars->slots[slot].value, value);
+
+    return microshOK;
+}
+
+/**
+ * \brief           Get variable value
+ * \param[in]       msh: microSH instance
+ * \param[in]       name: Variable name
+ * \return          Variable value, `NULL` if variable is not set
+ */
+const char* microsh_var_get(microsh_t* msh, const char* name) {
+    size_t slot;
+
+    if (msh == NULL || !prv_name_valid(name)) {
+        return NULL;
+    }
+
+    slot = prv_slot_find(&msh->vars, name);
+
+    return msh->vars.slots[slot].name[0] != '\0' ? msh->vars.slots[slot].value : NULL;
+}
+
+/**
+ * \brief           Delete variable
+ * \param[in,out]   msh: microSH instance
+ * \param[in]       name: Variable name
+ * \return          \ref microshOK on success, \ref microshERR if variable is not set,
+ *                      \ref microshERRPAR on wrong name
+ */
+microshr_t microsh_var_unset(microsh_t* msh, const char* name) {
+    microsh_vars_t* vars;
+    size_t slot, next;
+
+    if (msh == NULL || !prv_name_valid(name)) {
+        return microshERRPAR;
+    }
+
+    vars = &msh->vars;
+    slot = prv_slot_find(vars, name);
+    if (vars->slots[slot].name[0] == '\0') {
+        return microshERR;
+    }
+
+    /* Shift the next entries of probe sequence back instead of using deleted marks */
+    next = slot;
+    while (1) {
+        size_t home;
+
+        next = (next + 1) % MICROSH_ARRAYSIZE(vars->slots);
+        if (vars->slots[next].name[0] == '\0') {
+            break;
+        }
+
+        /* Entry may move back only if its home slot is not between freed slot and it */
+        home = microsh_str_hash(vars->slots[next].name) % MICROSH_ARRAYSIZE(vars->slots);
+        if (slot <= next ? (home <= slot || home > next) : (home <= slot && home > next)) {
+            vars->slots[slot] = vars->slots[next];
+            slot = next;
+        }
+    }
+    vars->slots[slot].name[0] = '\0';
+    --vars->num;
+
+    return microshOK;
+}
+
+/**
+ * \brief           Replace `$NAME` and `$?` in arguments with variable values
+ * \note            Arguments without `$` are not copied. Arguments which become empty
+ *                      are removed. Unset variable is replaced with empty string
+ * \param[in,out]   msh: microSH instance
+ * \param[in,out]   argc: Number of arguments
+ * \param[in,out]   argv: Pointer to arguments, it is replaced with pointer to expanded
+ *                      arguments valid until the next call
+ * \return          \ref microshEXEC_OK on success, \ref microshEXEC_ERROR_EXPAND if
+ *                      expanded arguments do not fit buffer
+ */
+int microsh_var_expand(microsh_t* msh, int* argc, const char* const **argv) {
+    microsh_vars_t* vars = &msh->vars;
+    size_t len = 0;
+    int n = 0, i;
+
+    for (i = 0; i < *argc && strchr((*argv)[i], '$') == NULL; ++i) {}
+    if (i == *argc) {
+        return microshEXEC_OK;
+    }
+
+    for (i = 0; i < *argc; ++i) {
+        const char* s = (*argv)[i];
+        size_t start = len;
+
+        if (strchr(s, '$') == NULL) {
+            vars->argv[n++] = s;
+            continue;
+        }
+
+        while (*s != '\0') {
+            char name[MICROSH_CFG_VAR_NAME_LEN];
+            const char* value = NULL;
+            char res_str[22];
+            size_t name_len = 0, value_len;
+
+            if (s[0] == '$' && s[1] == '?') {
+                /* Negative result is printed as sign and magnitude */
+                res_str[0] = '-';
+                value = microsh_u64_to_str(vars->last_res < 0 ? (uint64_t)0 - (uint64_t)(int64_t)vars->last_res
+                                                              : (uint64_t)vars->last_res, &res_str[1]);
+                if (vars->last_res < 0) {
+                    value = res_str;
+                }
+                s += 2;
+            } else if (s[0] == '$' && prv_name_char(s[1]) && !(s[1] >= '0' && s[1] <= '9')) {
+                for (++s; prv_name_char(*s); ++s) {
+                    if (name_len < sizeof(name) - 1) {
+                        name[name_len] = *s;
+                    }
+                    ++name_len;
+                }
+                name[name_len < sizeof(name) ? name_len : 0] = '\0';
+                value = microsh_var_get(msh, name);
+                if (value == NULL) {
+                    value = "";
+                }
+            } else {
+                if (len + 1 >= sizeof(vars->line)) {
+                    return microshEXEC_ERROR_EXPAND;
+                }
+                vars->line[len++] = *s++;
+                continue;
+            }
+
+            value_len = strlen(value);
+            if (len + value_len >= sizeof(vars->line)) {
+                return microshEXEC_ERROR_EXPAND;
+            }
+            memcpy(&vars->line[len], value, value_len);
+            len += value_len;
+        }
+        if (len + 1 > sizeof(vars->line)) {
+            return microshEXEC_ERROR_EXPAND;
+        }
+        vars->line[len++] = '\0';
+
+        /* Argument of unset variables only is removed */
+        if (vars->line[start] != '\0') {
+            vars->argv[n++] = &vars->line[start];
+        }
+    }
+
+    *argc = n;
+    *argv = vars->argv;
+
+    return microshEXEC_OK;
+}
+
+/**
+ * \brief           Built-in command to set variable: `set NAME VALUE`
+ * \note            Register it with \ref microsh_cmd_register using `3` as maximum
+ *                      number of arguments
+ * \param[in]       msh: microSH instance
+ * \param[in]       argc: argument count
+ * \param[in]       argv: pointer array to token string
+ * \return          \ref microshEXEC_OK on success, member of
+ *                      \ref microsh_execr_t enumeration otherwise
+ */
+int microsh_var_set_cmd(microsh_t* msh, int argc, const char* const *argv) {
+    if (argc < 3) {
+        return microshEXEC_ERROR_FEW_ARGS;
+    }
+
+    switch (microsh_var_set(msh, argv[1], argv[2])) {
+        case microshOK:
+            return microshEXEC_OK;
+        case microshERRPAR:
+            return microshEXEC_ERROR_BAD_ARG;
+        default:
+            return microshEXEC_ERROR;
+    }
+}
+
+/**
+ * \brief           Built-in command to delete variable: `unset NAME`
+ * \note            Register it with \ref microsh_cmd_register using `2` as maximum
+ *                      number of arguments
+ * \param[in]       msh: microSH instance
+ * \param[in]       argc: argument count
+ * \param[in]       argv: pointer array to token string
+ * \return          \ref microshEXEC_OK on success, member of
+ *                      \ref microsh_execr_t enumeration otherwise
+ */
+int microsh_var_unset_cmd(microsh_t* msh, int argc, const char* const *argv) {
+    if (argc < 2) {
+        return microshEXEC_ERROR_FEW_ARGS;
+    }
+
+    return microsh_var_unset(msh, argv[1]) == microshERRPAR ? microshEXEC_ERROR_BAD_ARG : microshEXEC_OK;
+}
+
+/**
+ * \brief           Built-in command to print all variables as `NAME=VALUE` lines
+ * \note            Register it with \ref microsh_cmd_register using `1` as maximum
+ *                      number of arguments
+ * \param[in]       msh: microSH instance
+ * \param[in]       argc: argument count
+ * \param[in]       argv: pointer array to token string
+ * \return          \ref microshEXEC_OK on success, member of
+ *                      \ref microsh_execr_t enumeration otherwise
+ */
+int microsh_var_env_cmd(microsh_t* msh, int argc, const char* const *argv) {
+    microrl_t* mrl = microsh_get_mrl(msh);
+
+    MICROSH_UNUSED(argc);
+    MICROSH_UNUSED(argv);
+
+    for (size_t i = 0; i < MICROSH_ARRAYSIZE(msh->vars.slots); ++i) {
+        const microsh_var_t* var = &msh->vars.slots[i];
+
+        if (var->name[0] != '\0') {
+            mrl->out_fn(mrl, var->name);
+            mrl->out_fn(mrl, "=");
+            mrl->out_fn(mrl, var->value);
+            mrl->out_fn(mrl, MICRORL_CFG_END_LINE);
+        }
+    }
+
+    return microshEXEC_OK;
+}
+
+/**
+ * \brief           Check for variable name character
+ * \param[in]       c: Character
+ * \return          `1` for letters, digits and `_`, `0` otherwise
+ */
+static uint8_t prv_name_char(char c) {
+    return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') || c == '_';
+}
+
+/**
+ * \brief           Check variable name
+ * \param[in]       name: Variable name
+ * \return          `1` if name is not empty, fits slot, has name characters only
+ *                      and does not start with digit, `0` otherwise
+ */
+static uint8_t prv_name_valid(const char* name) {
+    size_t len = 0;
+
+    /* `$1`..`$9` are left for alias positional parameters */
+    if (name == NULL || (name[0] >= '0' && name[0] <= '9')) {
+        return 0;
+    }
+    for (; name[len] != '\0'; ++len) {
+        if (!prv_name_char(name[len]) || len >= MICROSH_CFG_VAR_NAME_LEN - 1) {
+            return 0;
+        }
+    }
+
+    return len > 0;
+}
+
+/**
+ * \brief           Find slot of variable
+ * \param[in]       vars: Variables context
+ * \param[in]       name: Valid variable name
+ * \return          Slot of variable, free slot to insert variable to if it is not set
+ */
+static size_t prv_slot_find(microsh_vars_t* vars, const char* name) {
+    size_t slot = microsh_str_hash(name) % MICROSH_ARRAYSIZE(vars->slots);
+
+    /* Table always has free slot, so probing stops */
+    while (vars->slots[slot].name[0] != '\0' && strcmp(vars->slots[slot].name, name) != 0) {
+        slot = (slot + 1) % MICROSH_ARRAYSIZE(vars->slots);
+    }
+
+    return slot;
+}
+
+#endif /* MICROSH_CFG_VARS */
@@ -0,0 +1,353 @@
+/**
+ * \file            microsh_watch.c
+ * \brief           microSH periodic command with diff redraw
+ */
+
+/*
+ * Copyright (c) 2022 Dmitry KARASEV
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * This file is part of microSH - Shell for Embedded Systems library.
+ *
+ * Author:          Dmitry KARASEV <karasevsdmitry@yandex.ru>
+ * Version:         2.0.0-dev
+ */
+
+#include <stdint.h>
+#include <string.h>
+#include "microsh.h"
+#include "microsh_priv.h"
+
+#if MICROSH_CFG_WATCH
+
+/* Terminal row of the first output row, header and prompt lines are above */
+#define _TOP_ROW                    3
+
+/* Unchanged characters between changes are printed again instead of cursor move */
+#define _GAP_MAX                    6
+
+/* Maximum period in seconds */
+#define _PERIOD_MAX                 3600
+
+static int  prv_watch_out(microrl_t* mrl, const char* str);
+static void prv_put(microsh_watch_t* w, char c);
+static void prv_row_end(microsh_watch_t* w);
+static void prv_flush(microsh_watch_t* w);
+static void prv_move(microsh_watch_t* w, uint8_t row, uint8_t col);
+
+/**
+ * \brief           Built-in command to run command periodically: `watch N COMMAND...`
+ *
+ * Screen is cleared and command runs every `N` seconds while shell is ticked.
+ * Quote command line holding `;`, `&&`, `||` or `|`. Only one command is
+ * watched by shell, new watch of the same terminal replaces the previous one,
+ * while watch of another terminal is running command fails
+ * \note            Register it with \ref microsh_cmd_register using
+ *                      \ref MICRORL_CFG_CMD_TOKEN_NMB as maximum number of arguments.
+ *                      Call \ref microsh_watch_stop on Ctrl+C
+ * \param[in]       msh: microSH instance
+ * \param[in]       argc: argument count
+ * \param[in]       argv: pointer array to token string
+ * \return          \ref microshEXEC_OK on success, member of
+ *                      \ref microsh_execr_t enumeration otherwise
+ */
+int microsh_watch_cmd(microsh_t* msh, int argc, const char* const *argv) {
+    microsh_watch_t* w = &msh->watch;
+    microrl_t* mrl = microsh_get_mrl(msh);
+    uint32_t period = 0;
+    size_t len = 0;
+    const char* s;
+    char num_str[21];
+
+    if (argc < 3) {
+        return microshEXEC_ERROR_FEW_ARGS;
+    }
+    for (s = argv[1]; *s >= '0' && *s <= '9' && period <= _PERIOD_MAX; ++s) {
+        period = period * 10 + (uint32_t)(*s - '0');
+    }
+    if (*s != '\0' || period == 0 || period > _PERIOD_MAX) {
+        return microshEXEC_ERROR_BAD_ARG;
+    }
+
+    /* Watched command itself can not restart watch, watch of another terminal is not taken over */
+    if (w->out_fn != NULL || (w->mrl != NULL && w->mrl != mrl)) {
+        return microshEXEC_ERROR;
+    }
+    if (w->mrl != NULL) {
+        microsh_watch_stop(mrl);
+    }
+
+    memset(w, 0x00, sizeof(*w));
+    for (int i = 2; i < argc; ++i) {
+        size_t tok_len = strlen(argv[i]);
+
+        if (len + tok_len + 1 > sizeof(w->line)) {
+            return microshEXEC_ERROR;
+        }
+        memcpy(&w->line[len], argv[i], tok_len);
+        len += tok_len;
+        w->line[len++] = i + 1 < argc ? ' ' : '\0';
+    }
+
+    mrl->out_fn(mrl, "\033[2J\033[HEvery ");
+    mrl->out_fn(mrl, microsh_u64_to_str(period, num_str));
+    mrl->out_fn(mrl, "s: ");
+    mrl->out_fn(mrl, w->line);
+    mrl->out_fn(mrl, MICRORL_CFG_END_LINE);
+
+    /* Joined line is split again, so quoted argument becomes several tokens */
+    for (char* p = w->line; *p != '\0';) {
+        if (*p == ' ') {
+            *p++ = '\0';
+            continue;
+        }
+        if (w->argc >= (int)MICROSH_ARRAYSIZE(w->argv)) {
+            return microshEXEC_ERROR_MAX_ARGS;
+        }
+        w->argv[w->argc++] = p;
+        while (*p != '\0' && *p != ' ') {
+            ++p;
+        }
+    }
+
+    w->mrl = mrl;
+    w->period_ms = period * 1000;
+    w->next_ms = msh->now_ms;
+
+    return microshEXEC_OK;
+}
+
+/**
+ * \brief           Stop watch of terminal
+ * \note            Cursor is moved below the last output, prompt is not printed
+ * \param[in]       mrl: \ref microrl_t working instance of terminal
+ * \return          \ref microshOK if watch is stopped, \ref microshERR if terminal
+ *                      has no watch
+ */
+microshr_t microsh_watch_stop(microrl_t* mrl) {
+    microsh_watch_t* w;
+    char str[32] = "\033[";
+    size_t rows = 0;
+
+    if (mrl == NULL || MICROSH_FROM_MRL(mrl) == NULL) {
+        return microshERRPAR;
+    }
+
+    w = &MICROSH_FROM_MRL(mrl)->watch;
+    if (w->mrl != mrl) {
+        return microshERR;
+    }
+
+    /* Command being watched stopped it, watch ends with the frame */
+    if (w->out_fn != NULL) {
+        w->period_ms = 0;
+        return microshOK;
+    }
+
+    for (size_t r = 0; r < MICROSH_ARRAYSIZE(w->row_len); ++r) {
+        if (w->row_len[r] > 0) {
+            rows = r + 1;
+        }
+    }
+    microsh_u64_to_str(_TOP_ROW + rows, &str[2]);
+    strcat(str, ";1H");
+    mrl->out_fn(mrl, str);
+    w->mrl = NULL;
+
+    return microshOK;
+}
+
+/**
+ * \brief           Start capturing output of watched command
+ * \param[in,out]   watch: Watch context
+ */
+void microsh_watch_frame_begin(microsh_watch_t* watch) {
+    watch->out_fn = watch->mrl->out_fn;
+    watch->mrl->out_fn = prv_watch_out;
+    watch->row = 0;
+    watch->col = 0;
+    watch->esc = 0;
+    watch->saved = 0;
+    watch->cur_row = 0xFF;
+    watch->run_len = 0;
+}
+
+/**
+ * \brief           Finish drawing changes of watched command output
+ * \param[in,out]   watch: Watch context
+ */
+void microsh_watch_frame_end(microsh_watch_t* watch) {
+    if (watch->col > 0) {
+        prv_row_end(watch);
+    }
+    prv_flush(watch);
+
+    /* Rows which are not printed anymore are cleared */
+    for (uint8_t r = watch->row; r < MICROSH_ARRAYSIZE(watch->row_len); ++r) {
+        if (watch->row_len[r] > 0) {
+            prv_move(watch, r, 0);
+            watch->out_fn(watch->mrl, "\033[K");
+            watch->row_len[r] = 0;
+        }
+    }
+    if (watch->saved) {
+        watch->out_fn(watch->mrl, "\0338");
+    }
+
+    watch->mrl->out_fn = watch->out_fn;
+    watch->out_fn = NULL;
+    if (watch->period_ms == 0) {
+        microsh_watch_stop(watch->mrl);
+    }
+}
+
+/**
+ * \brief           Output callback of terminal while watched command runs
+ * \param[in]       mrl: \ref microrl_t working instance of terminal
+ * \param[in]       str: Output string
+ * \return          The number of characters written
+ */
+static int prv_watch_out(microrl_t* mrl, const char* str) {
+    microsh_watch_t* w = &MICROSH_FROM_MRL(mrl)->watch;
+    size_t len = strlen(str);
+
+    for (size_t i = 0; i < len; ++i) {
+        prv_put(w, str[i]);
+    }
+
+    return (int)len;
+}
+
+/**
+ * \brief           Put output character to its cell, changed cell is drawn
+ * \param[in,out]   w: Watch context
+ * \param[in]       c: Output character
+ */
+static void prv_put(microsh_watch_t* w, char c) {
+    uint8_t end;
+
+    /* Escape sequences of output would break cursor tracking */
+    if (w->esc == 1) {
+        w->esc = c == '[' ? 2 : 0;
+        return;
+    } else if (w->esc == 2) {
+        w->esc = c >= 0x40 && c <= 0x7E ? 0 : 2;
+        return;
+    }
+
+    switch (c) {
+        case '\033':
+            w->esc = 1;
+            return;
+        case '\n':
+            prv_row_end(w);
+            return;
+        case '\t':
+            do {
+                prv_put(w, ' ');
+            } while (w->col % 8 != 0 && w->col < MICROSH_CFG_WATCH_COLS);
+            return;
+        default:
+            if ((unsigned char)c < 0x20) {
+                return;
+            }
+            break;
+    }
+
+    if (w->row >= MICROSH_CFG_WATCH_ROWS || w->col >= MICROSH_CFG_WATCH_COLS) {
+        return;
+    }
+
+    if (w->col >= w->row_len[w->row] || w->screen[w->row][w->col] != c) {
+        end = (uint8_t)(w->run_col + w->run_len);
+        if (w->run_len > 0 && (w->run_row != w->row || w->col - end > _GAP_MAX)) {
+            prv_flush(w);
+        }
+        if (w->run_len == 0) {
+            w->run_row = w->row;
+            w->run_col = w->col;
+        }
+
+        /* Gap cells are shown already and hold the same characters */
+        while (w->run_col + w->run_len < w->col) {
+            w->run[w->run_len] = w->screen[w->row][w->run_col + w->run_len];
+            ++w->run_len;
+        }
+        w->run[w->run_len++] = c;
+        w->screen[w->row][w->col] = c;
+    }
+    ++w->col;
+}
+
+/**
+ * \brief           Finish output row, shown characters after its end are erased
+ * \param[in,out]   w: Watch context
+ */
+static void prv_row_end(microsh_watch_t* w) {
+    if (w->row < MICROSH_CFG_WATCH_ROWS) {
+        if (w->col < w->row_len[w->row]) {
+            prv_flush(w);
+            prv_move(w, w->row, w->col);
+            w->out_fn(w->mrl, "\033[K");
+        }
+        w->row_len[w->row] = w->col;
+        ++w->row;
+    }
+    w->col = 0;
+}
+
+/**
+ * \brief           Print waiting changed characters
+ * \param[in,out]   w: Watch context
+ */
+static void prv_flush(microsh_watch_t* w) {
+    if (w->run_len == 0) {
+        return;
+    }
+
+    prv_move(w, w->run_row, w->run_col);
+    w->run[w->run_len] = '\0';
+    w->out_fn(w->mrl, w->run);
+    w->cur_col = (uint8_t)(w->cur_col + w->run_len);
+    w->run_len = 0;
+}
+
+/**
+ * \brief           Move terminal cursor to output cell if it is not there
+ * \note            Cursor position of prompt is saved before the first move of frame
+ * \param[in,out]   w: Watch context
+ * \param[in]       row: Output row
+ * \param[in]       col: Output column
+ */
+static void prv_move(microsh_watch_t* w, uint8_t row, uint8_t col) {
+    char str[32] = "\033[";
+
+    if (!w->saved) {
+        w->out_fn(w->mrl, "\0337");
+        w->saved = 1;
+    }
+    if (w->cur_row == row && w->cur_col == col) {
+        return;
+    }
+
+    microsh_u64_to_str(_TOP_ROW + row, &str[2]);
+    strcat(str, ";");
+    microsh_u64_to_str(col + 1, &str[strlen(str)]);
+    strcat(str, "H");
+    w->out_fn(w->mrl, str);
+    w->cur_row = row;
+    w->cur_col = col;
+}
+
+#endif /* MICROSH_CFG_WATCH */
@@ -0,0 +1,189 @@
+#!/usr/bin/env python3
+#
+# Host tool for microSH virtual channels multiplexer
+#
+# Copyright (c) 2022 Dmitry KARASEV
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+#
+# This file is part of microSH - Shell for Embedded Systems library.
+#
+# Author:          Dmitry KARASEV <karasevsdmitry@yandex.ru>
+# Version:         2.0.0-dev
+
+"""Encode and decode microSH multiplexer frames.
+
+Frame format is `FLAG | channel | payload | CRC-8 | FLAG`, where FLAG is 0x7E.
+FLAG and ESC (0x7D) bytes inside frame are sent as ESC followed by byte ^ 0x20.
+
+Examples:
+    printf 'help\\n' | microsh_mux.py encode | device | microsh_mux.py decode -o 2=telemetry.bin
+    microsh_mux.py term /dev/ttyUSB0
+"""
+
+import argparse
+import os
+import select
+import sys
+import termios
+import tty
+
+FLAG = 0x7E
+ESC = 0x7D
+MAX_PAYLOAD = 64
+
+
+def crc8(data):
+    crc = 0
+    for byte in data:
+        crc ^= byte
+        for _ in range(8):
+            crc = ((crc << 1) ^ 0x07) & 0xFF if crc & 0x80 else (crc << 1) & 0xFF
+    return crc
+
+
+def encode(ch, payload):
+    """Encode payload of channel to list of frames"""
+    frames = bytearray()
+    for i in range(0, max(len(payload), 1), MAX_PAYLOAD):
+        body = bytes([ch]) + payload[i:i + MAX_PAYLOAD]
+        body += bytes([crc8(body)])
+        frames.append(FLAG)
+        for byte in body:
+            if byte in (FLAG, ESC):
+                frames += bytes([ESC, byte ^ 0x20])
+            else:
+                frames.append(byte)
+        frames.append(FLAG)
+    return bytes(frames)
+
+
+class Decoder:
+    """Stream decoder, calls handler with channel and payload of every valid frame"""
+
+    def __init__(self, handler):
+        self.handler = handler
+        self.frame = bytearray()
+        self.esc = False
+        self.errors = 0
+
+    def feed(self, data):
+        for byte in data:
+            if byte == FLAG:
+                if len(self.frame) >= 2:
+                    if crc8(self.frame[:-1]) == self.frame[-1]:
+                        self.handler(self.frame[0], bytes(self.frame[1:-1]))
+                    else:
+                        self.errors += 1
+                self.frame.clear()
+                self.esc = False
+            elif byte == ESC:
+                self.esc = True
+            else:
+                self.frame.append(byte ^ 0x20 if self.esc else byte)
+                self.esc = False
+
+
+def open_outputs(specs):
+    outputs = {0: sys.stdout.buffer}
+    for spec in specs:
+        ch, path = spec.split("=", 1)
+        outputs[int(ch)] = open(path, "wb")
+    return outputs
+
+
+def make_handler(outputs):
+    def handler(ch, payload):
+        out = outputs.get(ch)
+        if out is None:
+            sys.stderr.write("[ch%d] %s\n" % (ch, payload.hex()))
+            return
+        out.write(payload)
+        out.flush()
+    return handler
+
+
+def cmd_encode(args):
+    while True:
+        data = os.read(sys.stdin.fileno(), MAX_PAYLOAD)
+        if not data:
+            break
+        sys.stdout.buffer.write(encode(args.channel, data))
+        sys.stdout.buffer.flush()
+
+
+def cmd_decode(args):
+    decoder = Decoder(make_handler(open_outputs(args.output)))
+    while True:
+        data = os.read(sys.stdin.fileno(), 4096)
+        if not data:
+            break
+        decoder.feed(data)
+    if decoder.errors:
+        sys.stderr.write("%d bad frames\n" % decoder.errors)
+
+
+def cmd_term(args):
+    dev = os.open(args.device, os.O_RDWR | os.O_NOCTTY)
+    attrs = termios.tcgetattr(dev)
+    tty.setraw(dev)
+    raw_attrs = termios.tcgetattr(dev)
+    raw_attrs[4] = raw_attrs[5] = getattr(termios, "B%d" % args.baudrate)
+    termios.tcsetattr(dev, termios.TCSANOW, raw_attrs)
+    stdin_attrs = termios.tcgetattr(sys.stdin.fileno()) if sys.stdin.isatty() else None
+    if stdin_attrs:
+        tty.setraw(sys.stdin.fileno())
+    decoder = Decoder(make_handler(open_outputs(args.output)))
+    try:
+        while True:
+            ready, _, _ = select.select([dev, sys.stdin.fileno()], [], [])
+            if dev in ready:
+                decoder.feed(os.read(dev, 4096))
+            if sys.stdin.fileno() in ready:
+                data = os.read(sys.stdin.fileno(), MAX_PAYLOAD)
+                if not data or data == b"\x1d":     # Ctrl+] exits
+                    break
+                os.write(dev, encode(args.channel, data))
+    finally:
+        if stdin_attrs:
+            termios.tcsetattr(sys.stdin.fileno(), termios.TCSANOW, stdin_attrs)
+        termios.tcsetattr(dev, termios.TCSANOW, attrs)
+        os.close(dev)
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    sub = parser.add_subparsers(dest="cmd", required=True)
+
+    p = sub.add_parser("encode", help="encode stdin to frames of channel on stdout")
+    p.add_argument("-c", "--channel", type=int, default=0, help="channel index (default: 0, shell)")
+    p.set_defaults(fn=cmd_encode)
+
+    p = sub.add_parser("decode", help="decode frames from stdin, channel 0 is written to stdout")
+    p.add_argument("-o", "--output", action="append", default=[], metavar="CH=FILE",
+                   help="write channel payload to file, other channels are dumped to stderr in hex")
+    p.set_defaults(fn=cmd_decode)
+
+    p = sub.add_parser("term", help="interactive shell over serial device, Ctrl+] to exit")
+    p.add_argument("device")
+    p.add_argument("-b", "--baudrate", type=int, default=115200)
+    p.add_argument("-c", "--channel", type=int, default=0, help="input channel index (default: 0, shell)")
+    p.add_argument("-o", "--output", action="append", default=[], metavar="CH=FILE")
+    p.set_defaults(fn=cmd_term)
+
+    args = parser.parse_args()
+    args.fn(args)
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,79 @@
+#!/usr/bin/env python3
+#
+# Host tool for microSH hashed passwords
+#
+# Copyright (c) 2022 Dmitry KARASEV
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+#
+# This file is part of microSH - Shell for Embedded Systems library.
+#
+# Author:          Dmitry KARASEV <karasevsdmitry@yandex.ru>
+# Version:         2.0.0-dev
+
+"""Generate microSH credentials table with salted password hashes.
+
+Passwords are hashed with PBKDF2-HMAC-SHA256 and random salt. Iterations and
+salt length must match MICROSH_CFG_PASSW_HASH_ITERATIONS and
+MICROSH_CFG_PASSW_SALT_LEN of firmware build.
+
+Examples:
+    microsh_passwd.py _LOGIN_TYPE_ADMIN:admin:12345 _LOGIN_TYPE_DEBUG:debug:54321
+    microsh_passwd.py -i 5000 -s 8 1:root
+"""
+
+import argparse
+import getpass
+import hashlib
+import os
+import sys
+
+
+def c_bytes(data):
+    return "{ " + ", ".join("0x%02X" % b for b in data) + " }"
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("entries", nargs="+", metavar="LOGIN_TYPE:USERNAME[:PASSWORD]",
+                        help="credentials entry, password is asked if omitted")
+    parser.add_argument("-i", "--iterations", type=int, default=1000,
+                        help="PBKDF2 iterations, MICROSH_CFG_PASSW_HASH_ITERATIONS (default: 1000)")
+    parser.add_argument("-s", "--salt-len", type=int, default=16,
+                        help="salt length, MICROSH_CFG_PASSW_SALT_LEN (default: 16)")
+    parser.add_argument("-n", "--name", default="credentials", help="C array name (default: credentials)")
+    args = parser.parse_args()
+
+    lines = []
+    for entry in args.entries:
+        fields = entry.split(":", 2)
+        if len(fields) < 2:
+            parser.error("wrong entry '%s'" % entry)
+        if len(fields) == 2:
+            fields.append(getpass.getpass("Password for %s: " % fields[1]))
+        login_type, username, password = fields
+
+        salt = os.urandom(args.salt_len)
+        hash_ = hashlib.pbkdf2_hmac("sha256", password.encode(), salt, args.iterations, 32)
+        lines.append("    { .login_type = %s, .username = \"%s\",\n"
+                     "      .salt = %s,\n"
+                     "      .hash = %s },"
+                     % (login_type, username, c_bytes(salt), c_bytes(hash_)))
+
+    sys.stdout.write("/* Generated by microsh_passwd.py, %d iterations */\n" % args.iterations)
+    sys.stdout.write("static const microsh_credentials_t %s[%d] = {\n" % (args.name, len(lines)))
+    sys.stdout.write("\n".join(lines).rstrip(",") + "\n};\n")
+
+
+if __name__ == "__main__":
+    main()